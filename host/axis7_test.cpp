@@ -0,0 +1,109 @@
+/**
+ * @brief axis7主机测试：axis7_to_axis6_no_twist与通用axis7_to_axis6对比
+ *
+ * twist7恒为0，两者应给出相同的6轴位姿：
+ * - SR6CAN输入范围（单位1/100 mm与度）：x/z ±3000，y ±6000（加扩展长度），
+ *   roll/pitch ±25度，逐点对比
+ * - roll/pitch在(-180, 180]全范围每15度取点，检查角度归一化与扩展臂分量
+ *
+ * 位置误差 < kMaxPosErr，角度误差 < kMaxAngleErrDeg，通用实现还原的twist6
+ * 也须在角度容差内为0。EXTENSION_LENGTH由编译开关给定，CMake分别以0与非0
+ * 构建两个测试。任一超限时打印输入并以非0退出。
+ */
+#include "utils.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// 位置为float舍入：|y7|至多约1.1e4，单个ulp约1e-3
+constexpr float kMaxPosErr = 5e-3f;
+// 通用实现经矩阵乘法和atan2还原角度，float舍入约1e-5度
+constexpr float kMaxAngleErrDeg = 1e-3f;
+
+float g_max_pos_err = 0.0f;
+float g_max_angle_err = 0.0f;
+int g_samples = 0;
+int g_failures = 0;
+
+/**
+ * @brief 角度差归一化到(-180, 180]，±180视为同一角度
+ */
+float angleDiff(float a, float b) {
+    float d = std::fmod(a - b, 360.0f);
+    if (d > 180.0f) {
+        d -= 360.0f;
+    } else if (d <= -180.0f) {
+        d += 360.0f;
+    }
+    return std::fabs(d);
+}
+
+void compare(float x7, float y7, float z7, float roll7, float pitch7) {
+    float a[6], b[5];
+    axis7_to_axis6(x7, y7, z7, roll7, pitch7, 0.0f, a[0], a[1], a[2], a[3],
+                   a[4], a[5]);
+    axis7_to_axis6_no_twist(x7, y7, z7, roll7, pitch7, b[0], b[1], b[2], b[3],
+                            b[4]);
+    g_samples++;
+
+    float pos_err = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        pos_err = std::fmax(pos_err, std::fabs(a[i] - b[i]));
+    }
+    float angle_err = std::fmax(angleDiff(a[3], b[3]), angleDiff(a[4], b[4]));
+    angle_err = std::fmax(angle_err, std::fabs(a[5]));
+    // 闭式实现的输出范围为(-180, 180]
+    bool in_range = b[3] > -180.0f && b[3] <= 180.0f && b[4] > -180.0f &&
+                    b[4] <= 180.0f;
+
+    g_max_pos_err = std::fmax(g_max_pos_err, pos_err);
+    g_max_angle_err = std::fmax(g_max_angle_err, angle_err);
+    if (pos_err >= kMaxPosErr || angle_err >= kMaxAngleErrDeg || !in_range) {
+        if (g_failures < 10) {
+            std::printf("FAIL x7=%g y7=%g z7=%g roll7=%g pitch7=%g: "
+                        "generic (%g %g %g %g %g %g) closed (%g %g %g %g %g)\n",
+                        x7, y7, z7, roll7, pitch7, a[0], a[1], a[2], a[3],
+                        a[4], a[5], b[0], b[1], b[2], b[3], b[4]);
+        }
+        g_failures++;
+    }
+}
+
+}  // namespace
+
+int main() {
+    std::printf("EXTENSION_LENGTH=%g\n", (double)EXTENSION_LENGTH);
+
+    for (int ix = -3; ix <= 3; ix++) {
+        for (int iy = -3; iy <= 3; iy++) {
+            for (int iz = -3; iz <= 3; iz++) {
+                for (int ir = -5; ir <= 5; ir++) {
+                    for (int ip = -5; ip <= 5; ip++) {
+                        compare(ix * 1000.0f, iy * 2000.0f + EXTENSION_LENGTH,
+                                iz * 1000.0f, ir * 5.0f, ip * 5.0f);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int ir = -11; ir <= 12; ir++) {
+        for (int ip = -11; ip <= 12; ip++) {
+            compare(1500.0f, -2500.0f + EXTENSION_LENGTH, 800.0f, ir * 15.0f,
+                    ip * 15.0f);
+        }
+    }
+
+    std::printf("%d samples: max position error %.3g (bound %.3g), "
+                "max angle error %.3g deg (bound %.3g)\n",
+                g_samples, g_max_pos_err, kMaxPosErr, g_max_angle_err,
+                kMaxAngleErrDeg);
+    if (g_failures != 0) {
+        std::printf("%d failures\n", g_failures);
+        return 1;
+    }
+    std::printf("closed form matches\n");
+    return 0;
+}
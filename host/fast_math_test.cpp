@@ -0,0 +1,191 @@
+/**
+ * @brief fast_math主机测试：各内核与double libm对比，检查头文件中标注的误差上界
+ *
+ * - sin/cos：|x| <= 8*pi均匀取点，绝对误差 < 2e-6
+ * - atan2：四个象限的(y, x)网格（含坐标轴），绝对误差 < 1e-6 rad
+ * - acos/asin：|x|在[0.25, 1]内逐个float（含最坏点-0.4269），其余每隔
+ *   kUnitStride个float取一个，绝对误差 < 5.7e-7 / 5.3e-7 rad
+ * - sqrt：[FLT_MIN, 1e7]内每隔kSqrtStride个float取一个，相对误差 < 4e-7
+ *
+ * 另打印主机上fast_math与libm（float）的单次调用耗时，仅供对比，不做检查；
+ * 目标板上的周期数由FAST_MATH_SELF_TEST给出。
+ * 任一上界被超出时打印最坏输入并以非0退出。
+ */
+#include "geometry/fast_math.hpp"
+
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+
+namespace {
+
+constexpr int kAngleSamples = 4000000;
+constexpr int kAtan2Grid = 2001;
+constexpr uint32_t kUnitStride = 16;
+constexpr uint32_t kSqrtStride = 7;
+constexpr int kBenchSamples = 1000000;
+
+volatile float g_sink = 0.0f;  // 防止基准循环被优化掉
+
+int g_failures = 0;
+
+struct MaxError {
+    double err = 0.0;
+    float x = 0.0f;
+    float y = 0.0f;
+
+    void add(double e, float at_x, float at_y = 0.0f) {
+        if (e > err) {
+            err = e;
+            x = at_x;
+            y = at_y;
+        }
+    }
+};
+
+void check(const char *name, const MaxError &m, double bound) {
+    bool ok = m.err < bound;
+    std::printf("%-6s max_err=%.3g (bound %.3g) at x=%.9g y=%.9g  %s\n", name,
+                m.err, bound, m.x, m.y, ok ? "ok" : "FAIL");
+    if (!ok) {
+        g_failures++;
+    }
+}
+
+float fromBits(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+uint32_t toBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief 对[lo, hi]（均为正数）内的float按位模式步进调用fn
+ */
+template <typename Fn>
+void forEachFloat(float lo, float hi, uint32_t stride, Fn fn) {
+    uint32_t end = toBits(hi);
+    for (uint32_t bits = toBits(lo); bits <= end; bits += stride) {
+        fn(fromBits(bits));
+    }
+}
+
+void checkSinCos() {
+    MaxError sin_err, cos_err;
+    const float range = 8.0f * fast_math::kPi;
+    for (int i = 0; i <= kAngleSamples; i++) {
+        float x = -range + 2.0f * range * ((float)i / kAngleSamples);
+        sin_err.add(std::fabs((double)fast_math::sin(x) - std::sin((double)x)),
+                    x);
+        cos_err.add(std::fabs((double)fast_math::cos(x) - std::cos((double)x)),
+                    x);
+    }
+    check("sin", sin_err, 2e-6);
+    check("cos", cos_err, 2e-6);
+}
+
+void checkAtan2() {
+    MaxError err;
+    for (int i = 0; i < kAtan2Grid; i++) {
+        float y = -300.0f + 600.0f * i / (kAtan2Grid - 1);
+        for (int j = 0; j < kAtan2Grid; j++) {
+            float x = -300.0f + 600.0f * j / (kAtan2Grid - 1);
+            if (x == 0.0f && y == 0.0f) {
+                continue;
+            }
+            err.add(std::fabs((double)fast_math::atan2(y, x) -
+                              std::atan2((double)y, (double)x)),
+                    x, y);
+        }
+    }
+    check("atan2", err, 1e-6);
+}
+
+void checkAcosAsin() {
+    MaxError acos_err, asin_err;
+    auto visit = [&](float a) {
+        for (float x : {a, -a}) {
+            acos_err.add(
+                std::fabs((double)fast_math::acos(x) - std::acos((double)x)),
+                x);
+            asin_err.add(
+                std::fabs((double)fast_math::asin(x) - std::asin((double)x)),
+                x);
+        }
+    };
+    forEachFloat(0.25f, 1.0f, 1, visit);
+    forEachFloat(fromBits(1), 0.25f, kUnitStride, visit);
+    visit(0.0f);
+    check("acos", acos_err, 5.7e-7);
+    check("asin", asin_err, 5.3e-7);
+}
+
+void checkSqrt() {
+    MaxError err;
+    forEachFloat(FLT_MIN, 1e7f, kSqrtStride, [&](float x) {
+        double ref = std::sqrt((double)x);
+        err.add(std::fabs((double)fast_math::sqrt(x) - ref) / ref, x);
+    });
+    check("sqrt", err, 4e-7);
+}
+
+/**
+ * @brief 同一组输入分别跑fast与libm，打印平均每次调用的纳秒数
+ */
+template <typename Fast, typename Libm>
+void bench(const char *name, float lo, float hi, Fast fast, Libm libm) {
+    auto run = [&](auto fn) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kBenchSamples; i++) {
+            g_sink = fn(lo + (hi - lo) * ((float)i / kBenchSamples));
+        }
+        std::chrono::duration<double, std::nano> ns =
+            std::chrono::steady_clock::now() - start;
+        return ns.count() / kBenchSamples;
+    };
+    double fast_ns = run(fast);
+    double libm_ns = run(libm);
+    std::printf("%-6s fast=%.2f ns  libm=%.2f ns\n", name, fast_ns, libm_ns);
+}
+
+}  // namespace
+
+int main() {
+    std::printf("FAST_MATH_ENABLE=%d\n", FAST_MATH_ENABLE);
+    checkSinCos();
+    checkAtan2();
+    checkAcosAsin();
+    checkSqrt();
+
+    bench("sin", -fast_math::kPi, fast_math::kPi,
+          [](float x) { return fast_math::sin(x); },
+          [](float x) { return sinf(x); });
+    bench("cos", -fast_math::kPi, fast_math::kPi,
+          [](float x) { return fast_math::cos(x); },
+          [](float x) { return cosf(x); });
+    bench("atan2", 100.0f, 300.0f,
+          [](float x) { return fast_math::atan2(x, 150.0f - x); },
+          [](float x) { return atan2f(x, 150.0f - x); });
+    bench("acos", -1.0f, 1.0f, [](float x) { return fast_math::acos(x); },
+          [](float x) { return acosf(x); });
+    bench("asin", -1.0f, 1.0f, [](float x) { return fast_math::asin(x); },
+          [](float x) { return asinf(x); });
+    bench("sqrt", 1e4f, 1e5f, [](float x) { return fast_math::sqrt(x); },
+          [](float x) { return sqrtf(x); });
+
+    if (g_failures != 0) {
+        std::printf("%d bounds exceeded\n", g_failures);
+        return 1;
+    }
+    std::printf("all within documented bounds\n");
+    return 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * @brief mit_codec主机测试：单精度编码与原double实现逐位一致
+ *
+ * - 每个字段的每个编码边界（code * span / max - offset）前后各
+ *   kEdgeUlps个float，encode()与encodeReference()逐值对比
+ * - 每个编码边界两侧的float路径保护带边缘（±0.5~3倍guard）附近逐值对比
+ * - 随机量程内输入，packControl()与原MIT::pack_dynamic_control_data逐帧对比
+ * - 随机量程外输入（含NaN、±inf），encode()与encodeReference()的钳位一致
+ *
+ * 任何不一致都打印输入并以非0退出。
+ */
+#include "twai/mit_codec.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace mit_codec;
+
+namespace {
+
+constexpr int kEdgeUlps = 8;
+constexpr int kRandomFrames = 5000000;
+constexpr int kRandomOutOfRange = 1000000;
+
+/**
+ * @brief 原MIT::pack_dynamic_control_data（double）逐字复制，作为对照
+ */
+void packLegacy(double position, double velocity, double kp, double kd,
+                double torque, uint8_t data[8]) {
+    uint16_t pos_int = (uint16_t)((position + 15.91) * 65535.0 / 31.82);
+    data[0] = (uint8_t)(pos_int >> 8);
+    data[1] = (uint8_t)(pos_int & 0xFF);
+
+    int16_t vel_int = (int16_t)((velocity + 82.73) * 4095.0 / 165.46);
+    data[2] = (uint8_t)(vel_int >> 4);
+    data[3] = (uint8_t)((vel_int & 0x0F) << 4);
+
+    int16_t kp_int = (int16_t)(kp * 4095.0 / 500.0);
+    data[3] |= (uint8_t)((kp_int >> 8) & 0x0F);
+    data[4] = (uint8_t)(kp_int & 0xFF);
+
+    int16_t kd_int = (int16_t)(kd * 4095.0 / 5.0);
+    data[5] = (uint8_t)(kd_int >> 4);
+    data[6] = (uint8_t)((kd_int & 0x0F) << 4);
+
+    int16_t torque_int = (int16_t)((torque + 6.24) * 4095.0 / (12.48));
+    data[6] |= (uint8_t)((torque_int >> 8) & 0x0F);
+    data[7] = (uint8_t)(torque_int & 0xFF);
+}
+
+struct NamedField {
+    const char *name;
+    const Field &field;
+};
+
+const NamedField kFields[] = {{"position", kPosition},
+                              {"velocity", kVelocity},
+                              {"kp", kKp},
+                              {"kd", kKd},
+                              {"torque", kTorque}};
+
+int g_failures = 0;
+
+void fail(const char *what, const char *name, float x, uint32_t got,
+          uint32_t want) {
+    if (g_failures < 10) {
+        std::printf("FAIL %s %s: x=%.9g encode=%u reference=%u\n", what, name,
+                    x, got, want);
+    }
+    g_failures++;
+}
+
+/**
+ * @brief 每个编码边界附近逐个float对比，返回检查的输入数
+ */
+uint64_t sweepEdges(const NamedField &nf) {
+    const Field &f = nf.field;
+    uint64_t checked = 0;
+    uint64_t fallbacks = 0;
+    for (uint32_t code = 0; code <= f.max + 1; code++) {
+        float x = (float)(code * f.span / f.max - f.offset);
+        for (int i = 0; i < kEdgeUlps; i++) {
+            x = std::nextafter(x, -INFINITY);
+        }
+        for (int i = -kEdgeUlps; i <= kEdgeUlps; i++) {
+            uint32_t got = encode(f, x);
+            uint32_t want = encodeReference(f, x);
+            if (got != want) {
+                fail("edge", nf.name, x, got, want);
+            }
+            float t = x * f.scale + f.bias;
+            float frac = t - std::floor(t);
+            if (frac < f.guard || frac > 1.0f - f.guard) {
+                fallbacks++;
+            }
+            checked++;
+            x = std::nextafter(x, INFINITY);
+        }
+    }
+    std::printf("edge sweep %-8s codes=%u inputs=%llu (%llu in guard band)\n",
+                nf.name, f.max + 1, (unsigned long long)checked,
+                (unsigned long long)fallbacks);
+    return checked;
+}
+
+/**
+ * @brief 每个编码边界两侧的保护带边缘（float路径与回退路径的分界）逐值对比
+ */
+uint64_t sweepGuards(const NamedField &nf) {
+    const Field &f = nf.field;
+    const double kMultiples[] = {-3.0, -1.5, -1.0, -0.5, 0.5, 1.0, 1.5, 3.0};
+    uint64_t checked = 0;
+    for (uint32_t code = 0; code <= f.max; code++) {
+        for (double m : kMultiples) {
+            double t = code + m * f.guard;
+            float x = (float)((t * f.span) / f.max - f.offset);
+            for (int i = 0; i < 4; i++) {
+                x = std::nextafter(x, -INFINITY);
+            }
+            for (int i = -4; i <= 4; i++) {
+                uint32_t got = encode(f, x);
+                uint32_t want = encodeReference(f, x);
+                if (got != want) {
+                    fail("guard", nf.name, x, got, want);
+                }
+                checked++;
+                x = std::nextafter(x, INFINITY);
+            }
+        }
+    }
+    std::printf("guard sweep %-8s inputs=%llu\n", nf.name,
+                (unsigned long long)checked);
+    return checked;
+}
+
+}  // namespace
+
+int main() {
+    for (const NamedField &nf : kFields) {
+        sweepEdges(nf);
+        sweepGuards(nf);
+    }
+
+    // 量程内随机帧：与原实现逐字节对比
+    std::mt19937 rng(20261018);
+    auto uniform = [&rng](const Field &f) {
+        std::uniform_real_distribution<float> d((float)-f.offset,
+                                                (float)(f.span - f.offset));
+        float x = d(rng);
+        // 原实现在量程上端回绕，上端点本身不参与帧对比
+        return x >= (float)(f.span - f.offset) ? (float)-f.offset : x;
+    };
+    int frame_mismatches = 0;
+    for (int i = 0; i < kRandomFrames; i++) {
+        float pos = uniform(kPosition), vel = uniform(kVelocity),
+              kp = uniform(kKp), kd = uniform(kKd), t = uniform(kTorque);
+        uint8_t a[8], b[8];
+        packControl(pos, vel, kp, kd, t, a);
+        packLegacy(pos, vel, kp, kd, t, b);
+        if (std::memcmp(a, b, sizeof(a)) != 0) {
+            if (frame_mismatches < 10) {
+                std::printf("FAIL frame: pos=%.9g vel=%.9g kp=%.9g kd=%.9g "
+                            "t=%.9g\n",
+                            pos, vel, kp, kd, t);
+            }
+            frame_mismatches++;
+        }
+    }
+    g_failures += frame_mismatches;
+    std::printf("random frames: %d, mismatches %d\n", kRandomFrames,
+                frame_mismatches);
+
+    // 量程外与特殊值：钳位行为一致
+    const float specials[] = {std::numeric_limits<float>::quiet_NaN(),
+                              INFINITY, -INFINITY, 1e30f, -1e30f, 0.0f,
+                              -0.0f};
+    for (const NamedField &nf : kFields) {
+        for (float x : specials) {
+            uint32_t got = encode(nf.field, x);
+            uint32_t want = encodeReference(nf.field, x);
+            if (got != want) {
+                fail("special", nf.name, x, got, want);
+            }
+        }
+        std::uniform_real_distribution<float> wide(
+            (float)(-nf.field.offset - nf.field.span),
+            (float)(2.0 * nf.field.span - nf.field.offset));
+        for (int i = 0; i < kRandomOutOfRange; i++) {
+            float x = wide(rng);
+            uint32_t got = encode(nf.field, x);
+            uint32_t want = encodeReference(nf.field, x);
+            if (got != want) {
+                fail("wide", nf.name, x, got, want);
+            }
+        }
+    }
+    std::printf("wide-range inputs: %d per field\n", kRandomOutOfRange);
+
+    if (g_failures != 0) {
+        std::printf("%d failures\n", g_failures);
+        return 1;
+    }
+    std::printf("all bit-exact\n");
+    return 0;
+}
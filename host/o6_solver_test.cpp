@@ -0,0 +1,121 @@
+/**
+ * @brief O6解算器主机测试：solve_robot_kinematics_f与原double解算器对比
+ *
+ * 在O6Executor的输入范围内取kGrid^6个位姿（x/y ±3，z ±6，roll/pitch/yaw
+ * ±25度，z与执行器一样加19.3），逐位姿对比两个解算器：
+ * - 有解/无解必须一致（double解含NaN视为无解）
+ * - 有解时6个摇臂角的最大绝对误差 < kMaxErrRad
+ *
+ * 另打印两个解算器在主机上的单次耗时，仅供对比。
+ * 任何不一致都打印位姿并以非0退出。
+ */
+#include "geometry/o6_geometry.hpp"
+#include "geometry/o6_solver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using namespace geometry;
+
+namespace {
+
+constexpr int kGrid = 9;
+// 主机实测最大误差约9.3e-5 rad（0.0053度），舵机脉宽分辨率约1.6e-3 rad
+constexpr double kMaxErrRad = 2e-4;
+
+float gridValue(float limit, int i) {
+    return -limit + 2.0f * limit * i / (kGrid - 1);
+}
+
+int g_failures = 0;
+
+void fail(const char *what, const float pose[6], double err) {
+    if (g_failures < 10) {
+        std::printf("FAIL %s: x=%g y=%g z=%g roll=%g pitch=%g yaw=%g err=%.3g\n",
+                    what, pose[0], pose[1], pose[2], pose[3], pose[4],
+                    pose[5], err);
+    }
+    g_failures++;
+}
+
+}  // namespace
+
+int main() {
+    const O6BaseGeometry base = make_o6_base_geometry();
+
+    double max_err = 0.0;
+    float worst[6] = {};
+    int poses = 0;
+    int solved = 0;
+    std::chrono::duration<double, std::micro> double_us{0};
+    std::chrono::duration<double, std::micro> float_us{0};
+
+    int idx[6] = {};
+    for (;;) {
+        const float pose[6] = {
+            gridValue(3.0f, idx[0]),  gridValue(3.0f, idx[1]),
+            gridValue(6.0f, idx[2]),  gridValue(25.0f, idx[3]),
+            gridValue(25.0f, idx[4]), gridValue(25.0f, idx[5])};
+
+        auto t0 = std::chrono::steady_clock::now();
+        auto ref = solve_robot_kinematics(pose[0], pose[1], pose[2] + 19.3,
+                                          pose[3], pose[4], pose[5]);
+        auto t1 = std::chrono::steady_clock::now();
+        std::array<float, 6> out;
+        bool ok = solve_robot_kinematics_f(base, pose[0], pose[1],
+                                           pose[2] + 19.3f, pose[3], pose[4],
+                                           pose[5], out);
+        auto t2 = std::chrono::steady_clock::now();
+        double_us += t1 - t0;
+        float_us += t2 - t1;
+        poses++;
+
+        bool ref_ok = ref.has_value();
+        if (ref_ok) {
+            for (double v : *ref) {
+                ref_ok = ref_ok && std::isfinite(v);
+            }
+        }
+        if (ok != ref_ok) {
+            fail(ok ? "float solved, double did not"
+                    : "double solved, float did not",
+                 pose, 0.0);
+        } else if (ok) {
+            solved++;
+            for (int i = 0; i < 6; i++) {
+                double err = std::fabs((double)out[i] - (*ref)[i]);
+                if (err > max_err) {
+                    max_err = err;
+                    std::copy(pose, pose + 6, worst);
+                }
+            }
+        }
+
+        int d = 0;
+        while (d < 6 && ++idx[d] == kGrid) {
+            idx[d++] = 0;
+        }
+        if (d == 6) {
+            break;
+        }
+    }
+
+    std::printf("%d poses, %d solved: max_err=%.3g rad (%.4f deg) at "
+                "x=%g y=%g z=%g roll=%g pitch=%g yaw=%g (bound %.3g)\n",
+                poses, solved, max_err, max_err * 180.0 / M_PI, worst[0],
+                worst[1], worst[2], worst[3], worst[4], worst[5], kMaxErrRad);
+    std::printf("per call: double=%.2f us, float=%.2f us\n",
+                double_us.count() / poses, float_us.count() / poses);
+
+    if (max_err >= kMaxErrRad) {
+        fail("max error above bound", worst, max_err);
+    }
+    if (g_failures != 0) {
+        std::printf("%d failures\n", g_failures);
+        return 1;
+    }
+    std::printf("all solutions match\n");
+    return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "esp_event_base.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 创建默认事件循环（独立分发线程），已存在时返回ESP_ERR_INVALID_STATE
+ */
+esp_err_t esp_event_loop_create_default(void);
+
+esp_err_t esp_event_handler_register(esp_event_base_t event_base,
+                                     int32_t event_id,
+                                     esp_event_handler_t event_handler,
+                                     void* event_handler_arg);
+esp_err_t esp_event_handler_unregister(esp_event_base_t event_base,
+                                       int32_t event_id,
+                                       esp_event_handler_t event_handler);
+
+/**
+ * @brief 投递事件，数据被复制；事件队列满时最多等待ticks_to_wait
+ */
+esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id,
+                         const void* event_data, size_t event_data_size,
+                         TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,4 @@
+#pragma once
+
+// 主机仿真不启动HTTP服务，只需要句柄类型
+typedef void* httpd_handle_t;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+typedef int (*vprintf_like_t)(const char*, va_list);
+
+/**
+ * @brief 设置单个TAG的日志级别（"*"为默认级别）
+ */
+void esp_log_level_set(const char* tag, esp_log_level_t level);
+
+/**
+ * @brief 读取TAG的日志级别
+ */
+esp_log_level_t esp_log_level_get(const char* tag);
+
+/**
+ * @brief 替换日志输出函数，返回原函数（默认为vprintf）
+ */
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t func);
+
+/**
+ * @brief 启动以来的毫秒数
+ */
+uint32_t esp_log_timestamp(void);
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* format,
+                   ...) __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOG_LEVEL(level, letter, tag, format, ...)                       \
+    do {                                                                     \
+        if (esp_log_level_get(tag) >= (level)) {                             \
+            esp_log_write((level), (tag),                                    \
+                          letter " (%" PRIu32 ") %s: " format "\n",          \
+                          esp_log_timestamp(), (tag), ##__VA_ARGS__);        \
+        }                                                                    \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...) \
+    ESP_LOG_LEVEL(ESP_LOG_ERROR, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) \
+    ESP_LOG_LEVEL(ESP_LOG_WARN, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) \
+    ESP_LOG_LEVEL(ESP_LOG_INFO, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) \
+    ESP_LOG_LEVEL(ESP_LOG_DEBUG, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) \
+    ESP_LOG_LEVEL(ESP_LOG_VERBOSE, "V", tag, format, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
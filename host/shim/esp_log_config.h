@@ -0,0 +1,3 @@
+#pragma once
+
+// 主机仿真：日志级别在运行时按TAG过滤，见esp_log.h
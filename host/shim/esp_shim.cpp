@@ -0,0 +1,860 @@
+/**
+ * @brief 主机仿真用的FreeRTOS / esp_timer / esp_event / esp_log实现
+ *
+ * 只实现固件用到的接口，语义与ESP-IDF一致，基于std::thread：
+ * - 任务：每个任务一个分离线程，任务通知、删除见task.h
+ * - 队列/信号量/事件组：互斥锁+条件变量，超时按FreeRTOS节拍换算
+ * - esp_timer：一个分发线程按到期时刻调用回调，周期定时器不累积漂移
+ * - 默认事件循环：一个分发线程，事件数据复制后排队（深度与固件一致为32）
+ * - 日志：按TAG过滤级别，可用esp_log_set_vprintf接管输出
+ *
+ * 线程不设优先级，主机多核上任务真正并行，比单核ESP32-C3更容易暴露竞争。
+ */
+#include <pthread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "esp_cpu.h"
+#include "esp_err.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+struct tskTaskControlBlock {
+    std::string name;
+    TaskFunction_t fn = nullptr;
+    void* arg = nullptr;
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notify_value = 0;
+    bool notify_pending = false;
+    std::atomic<bool> deleted{false};
+    std::atomic<bool> blocked{false};  // 在阻塞接口中等待，不会执行任务代码
+    std::atomic<bool> exited{false};
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 删除其他任务时等待其阻塞或退出
+std::mutex delete_mutex;
+std::condition_variable delete_cv;
+
+// 阻塞等待中检查删除标志的间隔
+constexpr auto kDeletePoll = std::chrono::milliseconds(10);
+
+thread_local TaskHandle_t current_task = nullptr;
+
+/**
+ * @brief 当前线程的任务控制块，非任务线程（如main）首次调用时创建
+ */
+TaskHandle_t self() {
+    if (current_task == nullptr) {
+        current_task = new tskTaskControlBlock();
+        current_task->name = "main";
+    }
+    return current_task;
+}
+
+bool selfDeleted() {
+    return current_task != nullptr && current_task->deleted.load();
+}
+
+/**
+ * @brief 阻塞接口返回前检查本任务是否已被删除
+ */
+void exitIfDeleted() {
+    if (selfDeleted()) {
+        pthread_exit(nullptr);
+    }
+}
+
+/**
+ * @brief 标记当前任务在阻塞接口中（vTaskDelete据此判断可以返回）
+ */
+void setBlocked(bool blocked) {
+    if (current_task == nullptr) {
+        return;
+    }
+    current_task->blocked.store(blocked);
+    if (blocked) {
+        std::lock_guard<std::mutex> lock(delete_mutex);
+        delete_cv.notify_all();
+    }
+}
+
+const Clock::time_point kBoot = Clock::now();
+
+/**
+ * @brief 节拍数换算为等待截止时刻，portMAX_DELAY为永久
+ */
+struct Deadline {
+    explicit Deadline(TickType_t ticks)
+        : forever(ticks == portMAX_DELAY),
+          at(Clock::now() + std::chrono::milliseconds(pdTICKS_TO_MS(ticks))) {}
+    bool forever;
+    Clock::time_point at;
+};
+
+/**
+ * @brief 按截止时刻等待条件成立，超时返回false
+ *
+ * 当前任务被删除时也返回false（不消费条件），调用者释放锁后exitIfDeleted()。
+ * 删除标志按kDeletePoll轮询；离开阻塞状态后再检查一次删除标志，与vTaskDelete
+ * 先置删除标志、再读阻塞状态的顺序配合，删除返回后任务不会再执行任务代码。
+ */
+template <typename Pred>
+bool waitUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+               const Deadline& deadline, Pred pred) {
+    setBlocked(true);
+    bool ok = true;
+    while (!pred() && !selfDeleted()) {
+        Clock::time_point slice = Clock::now() + kDeletePoll;
+        if (!deadline.forever && deadline.at <= slice) {
+            ok = cv.wait_until(lock, deadline.at,
+                               [&]() { return pred() || selfDeleted(); });
+            break;
+        }
+        cv.wait_until(lock, slice);
+    }
+    setBlocked(false);
+    return ok && !selfDeleted();
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------- esp_err
+
+extern "C" const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:
+            return "ESP_OK";
+        case ESP_FAIL:
+            return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:
+            return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:
+            return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:
+            return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:
+            return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:
+            return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:
+            return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:
+            return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE:
+            return "ESP_ERR_INVALID_RESPONSE";
+        default:
+            return "UNKNOWN ERROR";
+    }
+}
+
+// ---------------------------------------------------------------- esp_log
+
+namespace {
+
+std::mutex log_mutex;
+std::map<std::string, esp_log_level_t> log_levels;
+esp_log_level_t log_default = (esp_log_level_t)CONFIG_LOG_DEFAULT_LEVEL;
+vprintf_like_t log_vprintf = vprintf;
+
+}  // namespace
+
+extern "C" void esp_log_level_set(const char* tag, esp_log_level_t level) {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (strcmp(tag, "*") == 0) {
+        log_default = level;
+        log_levels.clear();
+    } else {
+        log_levels[tag] = level;
+    }
+}
+
+extern "C" esp_log_level_t esp_log_level_get(const char* tag) {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    auto it = log_levels.find(tag);
+    return it != log_levels.end() ? it->second : log_default;
+}
+
+extern "C" vprintf_like_t esp_log_set_vprintf(vprintf_like_t func) {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    vprintf_like_t prev = log_vprintf;
+    log_vprintf = func;
+    return prev;
+}
+
+extern "C" uint32_t esp_log_timestamp(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+extern "C" void esp_log_write(esp_log_level_t level, const char* tag,
+                              const char* format, ...) {
+    vprintf_like_t out;
+    {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        out = log_vprintf;
+    }
+    va_list args;
+    va_start(args, format);
+    out(format, args);
+    va_end(args);
+}
+
+// ---------------------------------------------------------------- esp_cpu
+
+extern "C" uint32_t esp_cpu_get_cycle_count(void) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now().time_since_epoch())
+        .count();
+}
+
+// ---------------------------------------------------------------- 任务
+
+extern "C" BaseType_t xTaskCreate(TaskFunction_t fn, const char* name,
+                                  uint32_t stack, void* arg,
+                                  UBaseType_t priority, TaskHandle_t* handle) {
+    TaskHandle_t task = new tskTaskControlBlock();
+    task->name = name != nullptr ? name : "";
+    task->fn = fn;
+    task->arg = arg;
+    // 句柄先于任务运行写出，与FreeRTOS中高优先级任务创建后立即运行时一致
+    if (handle != nullptr) {
+        *handle = task;
+    }
+    std::thread([task]() {
+        // 返回或pthread_exit退出（栈展开）时都标记已退出
+        struct ExitMark {
+            TaskHandle_t task;
+            ~ExitMark() {
+                std::lock_guard<std::mutex> lock(delete_mutex);
+                task->exited.store(true);
+                delete_cv.notify_all();
+            }
+        } exit_mark{task};
+        current_task = task;
+        pthread_setname_np(pthread_self(), task->name.substr(0, 15).c_str());
+        task->fn(task->arg);
+        // FreeRTOS任务函数不能返回，返回即视为删除自身
+        task->deleted.store(true, std::memory_order_release);
+    }).detach();
+    return pdPASS;
+}
+
+extern "C" BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn,
+                                              const char* name, uint32_t stack,
+                                              void* arg, UBaseType_t priority,
+                                              TaskHandle_t* handle,
+                                              BaseType_t core) {
+    return xTaskCreate(fn, name, stack, arg, priority, handle);
+}
+
+extern "C" void vTaskDelete(TaskHandle_t handle) {
+    TaskHandle_t task = handle != nullptr ? handle : self();
+    task->deleted.store(true);
+    if (task == current_task) {
+        pthread_exit(nullptr);
+    }
+    // 唤醒可能在等待通知的任务，使其退出
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->cv.notify_all();
+    }
+    // FreeRTOS删除后任务不再运行；这里等它退出或停在阻塞接口中（之后直接退出），
+    // 调用者随后释放任务用到的对象是安全的
+    std::unique_lock<std::mutex> lock(delete_mutex);
+    delete_cv.wait(lock,
+                   [task]() { return task->exited.load() || task->blocked.load(); });
+}
+
+extern "C" void vTaskDelay(TickType_t ticks) {
+    setBlocked(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(
+        ticks == 0 ? 0 : pdTICKS_TO_MS(ticks)));
+    if (ticks == 0) {
+        std::this_thread::yield();
+    }
+    setBlocked(false);
+    exitIfDeleted();
+}
+
+extern "C" TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(esp_timer_get_time() * configTICK_RATE_HZ / 1000000);
+}
+
+extern "C" TaskHandle_t xTaskGetCurrentTaskHandle(void) { return self(); }
+
+extern "C" BaseType_t xTaskNotify(TaskHandle_t handle, uint32_t value,
+                                  eNotifyAction action) {
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    switch (action) {
+        case eNoAction:
+            break;
+        case eSetBits:
+            handle->notify_value |= value;
+            break;
+        case eIncrement:
+            handle->notify_value++;
+            break;
+        case eSetValueWithOverwrite:
+            handle->notify_value = value;
+            break;
+        case eSetValueWithoutOverwrite:
+            if (handle->notify_pending) {
+                return pdFAIL;
+            }
+            handle->notify_value = value;
+            break;
+    }
+    handle->notify_pending = true;
+    handle->cv.notify_all();
+    return pdPASS;
+}
+
+extern "C" BaseType_t xTaskNotifyWait(uint32_t clear_on_entry,
+                                      uint32_t clear_on_exit, uint32_t* value,
+                                      TickType_t ticks) {
+    TaskHandle_t task = self();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    if (!task->notify_pending) {
+        task->notify_value &= ~clear_on_entry;
+    }
+    bool got = waitUntil(task->cv, lock, Deadline(ticks), [task]() {
+        return task->notify_pending || task->deleted.load();
+    });
+    if (value != nullptr) {
+        *value = task->notify_value;
+    }
+    if (got && task->notify_pending) {
+        task->notify_value &= ~clear_on_exit;
+        task->notify_pending = false;
+    } else {
+        got = false;
+    }
+    lock.unlock();
+    exitIfDeleted();
+    return got ? pdTRUE : pdFALSE;
+}
+
+extern "C" BaseType_t xTaskNotifyGive(TaskHandle_t handle) {
+    return xTaskNotify(handle, 0, eIncrement);
+}
+
+extern "C" void vTaskNotifyGiveFromISR(TaskHandle_t handle, BaseType_t* woken) {
+    xTaskNotify(handle, 0, eIncrement);
+}
+
+extern "C" uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit,
+                                     TickType_t ticks) {
+    TaskHandle_t task = self();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    waitUntil(task->cv, lock, Deadline(ticks), [task]() {
+        return task->notify_value != 0 || task->deleted.load();
+    });
+    uint32_t value = task->notify_value;
+    if (value != 0) {
+        task->notify_value = clear_on_exit ? 0 : value - 1;
+    }
+    task->notify_pending = false;
+    lock.unlock();
+    exitIfDeleted();
+    return value;
+}
+
+// ---------------------------------------------------------------- 队列
+
+struct QueueDefinition {
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    size_t item_size;
+    size_t length;
+    size_t head = 0;   // 最早一项
+    size_t count = 0;  // 项数
+    std::vector<uint8_t> storage;
+
+    uint8_t* slot(size_t i) {
+        return storage.data() + ((head + i) % length) * item_size;
+    }
+};
+
+extern "C" QueueHandle_t xQueueCreate(UBaseType_t length,
+                                      UBaseType_t item_size) {
+    if (length == 0) {
+        return nullptr;
+    }
+    QueueHandle_t queue = new QueueDefinition();
+    queue->item_size = item_size;
+    queue->length = length;
+    queue->storage.resize((size_t)length * item_size);
+    return queue;
+}
+
+extern "C" QueueHandle_t xQueueCreateCounting(UBaseType_t max,
+                                              UBaseType_t initial) {
+    QueueHandle_t queue = xQueueCreate(max, 0);
+    if (queue != nullptr) {
+        queue->count = initial;
+    }
+    return queue;
+}
+
+extern "C" void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+namespace {
+
+BaseType_t queueSend(QueueHandle_t queue, const void* item, TickType_t ticks,
+                     bool front) {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitUntil(queue->not_full, lock, Deadline(ticks), [queue]() {
+            return queue->count < queue->length;
+        })) {
+        lock.unlock();
+        exitIfDeleted();
+        return pdFALSE;
+    }
+    if (front) {
+        queue->head = (queue->head + queue->length - 1) % queue->length;
+        memcpy(queue->slot(0), item, queue->item_size);
+    } else {
+        memcpy(queue->slot(queue->count), item, queue->item_size);
+    }
+    queue->count++;
+    queue->not_empty.notify_one();
+    return pdTRUE;
+}
+
+}  // namespace
+
+extern "C" BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item,
+                                       TickType_t ticks) {
+    return queueSend(queue, item, ticks, false);
+}
+
+extern "C" BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item,
+                                        TickType_t ticks) {
+    return queueSend(queue, item, ticks, true);
+}
+
+extern "C" BaseType_t xQueueReceive(QueueHandle_t queue, void* item,
+                                    TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitUntil(queue->not_empty, lock, Deadline(ticks),
+                   [queue]() { return queue->count > 0; })) {
+        lock.unlock();
+        exitIfDeleted();
+        return pdFALSE;
+    }
+    if (queue->item_size > 0) {
+        memcpy(item, queue->slot(0), queue->item_size);
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    queue->not_full.notify_one();
+    return pdTRUE;
+}
+
+extern "C" BaseType_t xQueuePeek(QueueHandle_t queue, void* item,
+                                 TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitUntil(queue->not_empty, lock, Deadline(ticks),
+                   [queue]() { return queue->count > 0; })) {
+        lock.unlock();
+        exitIfDeleted();
+        return pdFALSE;
+    }
+    if (queue->item_size > 0) {
+        memcpy(item, queue->slot(0), queue->item_size);
+    }
+    return pdTRUE;
+}
+
+extern "C" BaseType_t xQueueReset(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->head = 0;
+    queue->count = 0;
+    queue->not_full.notify_all();
+    return pdPASS;
+}
+
+extern "C" UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return (UBaseType_t)queue->count;
+}
+
+extern "C" UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return (UBaseType_t)(queue->length - queue->count);
+}
+
+// ---------------------------------------------------------------- 事件组
+
+struct EventGroupDef_t {
+    std::mutex mutex;
+    std::condition_variable cv;
+    EventBits_t bits = 0;
+};
+
+namespace {
+
+// FreeRTOS事件组的高8位保留给内核
+constexpr EventBits_t kEventBitsMask = 0x00FFFFFF;
+
+}  // namespace
+
+extern "C" EventGroupHandle_t xEventGroupCreate(void) {
+    return new EventGroupDef_t();
+}
+
+extern "C" void vEventGroupDelete(EventGroupHandle_t group) { delete group; }
+
+extern "C" EventBits_t xEventGroupSetBits(EventGroupHandle_t group,
+                                          EventBits_t bits) {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    group->bits |= bits & kEventBitsMask;
+    group->cv.notify_all();
+    return group->bits;
+}
+
+extern "C" EventBits_t xEventGroupClearBits(EventGroupHandle_t group,
+                                            EventBits_t bits) {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    EventBits_t prev = group->bits;
+    group->bits &= ~bits;
+    return prev;
+}
+
+extern "C" EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    return group->bits;
+}
+
+extern "C" EventBits_t xEventGroupWaitBits(EventGroupHandle_t group,
+                                           EventBits_t bits,
+                                           BaseType_t clear_on_exit,
+                                           BaseType_t wait_for_all,
+                                           TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(group->mutex);
+    auto satisfied = [group, bits, wait_for_all]() {
+        return wait_for_all ? (group->bits & bits) == bits
+                            : (group->bits & bits) != 0;
+    };
+    bool got = waitUntil(group->cv, lock, Deadline(ticks), satisfied);
+    EventBits_t value = group->bits;
+    if (got && clear_on_exit) {
+        group->bits &= ~bits;
+    }
+    lock.unlock();
+    exitIfDeleted();
+    return value;
+}
+
+// ---------------------------------------------------------------- esp_timer
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    std::string name;
+    bool armed = false;
+    int64_t alarm_us = 0;
+    uint64_t period_us = 0;  // 0为单次
+};
+
+namespace {
+
+std::mutex timer_mutex;
+std::condition_variable timer_cv;
+std::vector<esp_timer_handle_t> timers;
+bool timer_thread_started = false;
+esp_timer_handle_t running_timer = nullptr;  // 正在执行回调的定时器
+thread_local bool in_timer_thread = false;
+
+void timerThread() {
+    pthread_setname_np(pthread_self(), "esp_timer");
+    in_timer_thread = true;
+    std::unique_lock<std::mutex> lock(timer_mutex);
+    while (true) {
+        esp_timer_handle_t next = nullptr;
+        for (esp_timer_handle_t t : timers) {
+            if (t->armed && (next == nullptr || t->alarm_us < next->alarm_us)) {
+                next = t;
+            }
+        }
+        if (next == nullptr) {
+            timer_cv.wait(lock);
+            continue;
+        }
+        int64_t now = esp_timer_get_time();
+        if (next->alarm_us > now) {
+            timer_cv.wait_for(lock,
+                              std::chrono::microseconds(next->alarm_us - now));
+            continue;
+        }
+
+        // 周期定时器按上次到期时刻推进，回调超时时依次补发
+        if (next->period_us > 0) {
+            next->alarm_us += next->period_us;
+        } else {
+            next->armed = false;
+        }
+        esp_timer_cb_t callback = next->callback;
+        void* arg = next->arg;
+        running_timer = next;
+        lock.unlock();
+        callback(arg);
+        lock.lock();
+        running_timer = nullptr;
+        timer_cv.notify_all();
+    }
+}
+
+esp_err_t arm(esp_timer_handle_t timer, uint64_t timeout_us,
+              uint64_t period_us) {
+    std::lock_guard<std::mutex> lock(timer_mutex);
+    if (timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = true;
+    timer->alarm_us = esp_timer_get_time() + (int64_t)timeout_us;
+    timer->period_us = period_us;
+    timer_cv.notify_all();
+    return ESP_OK;
+}
+
+}  // namespace
+
+extern "C" int64_t esp_timer_get_time(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                                 kBoot)
+        .count();
+}
+
+extern "C" esp_err_t esp_timer_create(const esp_timer_create_args_t* args,
+                                      esp_timer_handle_t* out_handle) {
+    if (args == nullptr || args->callback == nullptr || out_handle == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_timer_handle_t timer = new esp_timer();
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+    timer->name = args->name != nullptr ? args->name : "";
+
+    std::lock_guard<std::mutex> lock(timer_mutex);
+    timers.push_back(timer);
+    if (!timer_thread_started) {
+        timer_thread_started = true;
+        std::thread(timerThread).detach();
+    }
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_start_once(esp_timer_handle_t timer,
+                                          uint64_t timeout_us) {
+    return arm(timer, timeout_us, 0);
+}
+
+extern "C" esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer,
+                                              uint64_t period) {
+    return arm(timer, period, period);
+}
+
+extern "C" esp_err_t esp_timer_restart(esp_timer_handle_t timer,
+                                       uint64_t timeout_us) {
+    std::lock_guard<std::mutex> lock(timer_mutex);
+    if (!timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->alarm_us = esp_timer_get_time() + (int64_t)timeout_us;
+    if (timer->period_us > 0) {
+        timer->period_us = timeout_us;
+    }
+    timer_cv.notify_all();
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    std::lock_guard<std::mutex> lock(timer_mutex);
+    if (!timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = false;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    std::unique_lock<std::mutex> lock(timer_mutex);
+    if (timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // ESP32-C3单核上esp_timer任务优先级最高，删除时不会有回调执行到一半；
+    // 主机上等待进行中的回调结束（回调中删除自身除外）
+    if (!in_timer_thread) {
+        timer_cv.wait(lock, [timer]() { return running_timer != timer; });
+    }
+    timers.erase(std::remove(timers.begin(), timers.end(), timer),
+                 timers.end());
+    delete timer;
+    return ESP_OK;
+}
+
+extern "C" bool esp_timer_is_active(esp_timer_handle_t timer) {
+    std::lock_guard<std::mutex> lock(timer_mutex);
+    return timer->armed;
+}
+
+// ---------------------------------------------------------------- esp_event
+
+namespace {
+
+constexpr size_t kEventQueueLen = 32;  // CONFIG_ESP_SYSTEM_EVENT_QUEUE_SIZE
+
+struct Handler {
+    esp_event_base_t base;
+    int32_t id;
+    esp_event_handler_t fn;
+    void* arg;
+};
+
+struct Event {
+    esp_event_base_t base;
+    int32_t id;
+    std::vector<uint8_t> data;
+};
+
+std::mutex event_mutex;
+std::recursive_mutex dispatch_mutex;  // 调用处理器期间持有，注销时等待
+std::condition_variable event_not_empty;
+std::condition_variable event_not_full;
+bool event_loop_created = false;
+std::vector<Handler> handlers;
+std::deque<Event> events;
+
+void eventThread() {
+    pthread_setname_np(pthread_self(), "sys_evt");
+    while (true) {
+        Event event;
+        std::vector<Handler> matched;
+        {
+            std::unique_lock<std::mutex> lock(event_mutex);
+            event_not_empty.wait(lock, []() { return !events.empty(); });
+            event = std::move(events.front());
+            events.pop_front();
+            event_not_full.notify_one();
+            for (const Handler& h : handlers) {
+                if ((h.base == ESP_EVENT_ANY_BASE || h.base == event.base) &&
+                    (h.id == ESP_EVENT_ANY_ID || h.id == event.id)) {
+                    matched.push_back(h);
+                }
+            }
+        }
+        // 与ESP-IDF事件循环相同，注销返回后不再调用该处理器
+        std::lock_guard<std::recursive_mutex> dispatch(dispatch_mutex);
+        for (const Handler& h : matched) {
+            bool registered;
+            {
+                std::lock_guard<std::mutex> lock(event_mutex);
+                registered = std::any_of(
+                    handlers.begin(), handlers.end(), [&](const Handler& r) {
+                        return r.base == h.base && r.id == h.id &&
+                               r.fn == h.fn && r.arg == h.arg;
+                    });
+            }
+            if (registered) {
+                h.fn(h.arg, event.base, event.id,
+                     event.data.empty() ? nullptr : event.data.data());
+            }
+        }
+    }
+}
+
+}  // namespace
+
+extern "C" esp_err_t esp_event_loop_create_default(void) {
+    std::lock_guard<std::mutex> lock(event_mutex);
+    if (event_loop_created) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    event_loop_created = true;
+    std::thread(eventThread).detach();
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_event_handler_register(esp_event_base_t event_base,
+                                                int32_t event_id,
+                                                esp_event_handler_t handler,
+                                                void* arg) {
+    std::lock_guard<std::mutex> lock(event_mutex);
+    if (!event_loop_created) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // 与ESP-IDF相同，重复注册同一处理器只更新参数
+    for (Handler& h : handlers) {
+        if (h.base == event_base && h.id == event_id && h.fn == handler) {
+            h.arg = arg;
+            return ESP_OK;
+        }
+    }
+    handlers.push_back({event_base, event_id, handler, arg});
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_event_handler_unregister(esp_event_base_t event_base,
+                                                  int32_t event_id,
+                                                  esp_event_handler_t handler) {
+    std::lock_guard<std::recursive_mutex> dispatch(dispatch_mutex);
+    std::lock_guard<std::mutex> lock(event_mutex);
+    handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
+                                  [&](const Handler& h) {
+                                      return h.base == event_base &&
+                                             h.id == event_id &&
+                                             h.fn == handler;
+                                  }),
+                   handlers.end());
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_event_post(esp_event_base_t event_base,
+                                    int32_t event_id, const void* event_data,
+                                    size_t event_data_size,
+                                    TickType_t ticks_to_wait) {
+    std::unique_lock<std::mutex> lock(event_mutex);
+    if (!event_loop_created) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!waitUntil(event_not_full, lock, Deadline(ticks_to_wait),
+                   []() { return events.size() < kEventQueueLen; })) {
+        lock.unlock();
+        exitIfDeleted();
+        return ESP_ERR_TIMEOUT;
+    }
+    Event event;
+    event.base = event_base;
+    event.id = event_id;
+    if (event_data != nullptr && event_data_size > 0) {
+        const uint8_t* p = static_cast<const uint8_t*>(event_data);
+        event.data.assign(p, p + event_data_size);
+    }
+    events.push_back(std::move(event));
+    event_not_empty.notify_one();
+    return ESP_OK;
+}
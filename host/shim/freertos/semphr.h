@@ -0,0 +1,24 @@
+#pragma once
+
+#include "freertos/queue.h"
+
+// 与FreeRTOS相同，二值信号量是项大小为0、长度为1的队列
+typedef QueueHandle_t SemaphoreHandle_t;
+
+#define xSemaphoreCreateBinary() xQueueCreate(1, 0)
+#define xSemaphoreCreateCounting(max, initial) \
+    xQueueCreateCounting(max, initial)
+#define xSemaphoreGive(sem) xQueueSendToBack(sem, NULL, 0)
+#define xSemaphoreGiveFromISR(sem, woken) xQueueSendToBack(sem, NULL, 0)
+#define xSemaphoreTake(sem, ticks) xQueueReceive(sem, NULL, ticks)
+#define vSemaphoreDelete(sem) vQueueDelete(sem)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+QueueHandle_t xQueueCreateCounting(UBaseType_t max, UBaseType_t initial);
+
+#ifdef __cplusplus
+}
+#endif
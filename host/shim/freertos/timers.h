@@ -0,0 +1,6 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+// 主机仿真不使用软件定时器，只提供句柄类型
+typedef struct tmrTimerControl* TimerHandle_t;
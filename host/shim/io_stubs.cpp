@@ -0,0 +1,38 @@
+/**
+ * @brief 主机仿真中executor.cpp引用的网络/串口/统计接口
+ *
+ * 仿真只经global_rx_queue送入TCode，响应（D0/D1等）打印到标准输出，
+ * 其余来源没有连接，直接丢弃。
+ */
+#include <cstdio>
+
+#include "analysis.h"
+#include "http/websocket_server.h"
+#include "tcp_server.hpp"
+#include "uart/uart.h"
+#include "udp_server.hpp"
+
+extern "C" esp_err_t uart_send_response(const char* data, size_t len) {
+    fwrite(data, 1, len, stdout);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t tcp_server_send_response(int client_fd, const char* data,
+                                              size_t len) {
+    return ESP_FAIL;
+}
+
+extern "C" esp_err_t udp_server_send_response(
+    int server_fd, const struct sockaddr_in* client_addr, const char* data,
+    size_t len) {
+    return ESP_FAIL;
+}
+
+extern "C" esp_err_t websocket_send_to_client(httpd_handle_t server,
+                                              int client_fd,
+                                              const char* message,
+                                              size_t len) {
+    return ESP_FAIL;
+}
+
+extern "C" void analysis_motion_tick(bool idle, uint32_t period_us) {}
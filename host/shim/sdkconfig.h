@@ -0,0 +1,9 @@
+#pragma once
+
+// 主机仿真使用的配置：ESP32-C3 + SR6CAN，TWAI驱动调用转到twai_sim
+#define CONFIG_IDF_TARGET "esp32c3"
+#define CONFIG_IDF_TARGET_ESP32C3 1
+#define CONFIG_SERVO_MODE_SR6CAN 1
+#define CONFIG_TWAI_SIM 1
+#define CONFIG_FREERTOS_HZ 100
+#define CONFIG_LOG_DEFAULT_LEVEL 3
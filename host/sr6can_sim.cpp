@@ -0,0 +1,649 @@
+/**
+ * @brief SR6CAN端到端主机仿真
+ *
+ * 固件的SR6CANExecutor、MIT、CanTx/CanRx/CanHealth/CanSchedule原样编译，跑在
+ * shim/中的FreeRTOS/esp_timer实现上，TWAI驱动调用经CONFIG_TWAI_SIM转到twai_sim
+ * （进程内虚拟总线与6个模拟电机）。TCode经global_rx_queue送入，与串口来源相同。
+ *
+ * 依次运行：
+ * - 稳态：正弦轨迹，统计吞吐、往返延迟、总线负载与跟踪误差
+ * - 前馈A/B（SR6CAN_FEEDFORWARD=2）：前馈开启时总体及各关节的跟踪误差RMS
+ *   不大于关闭时，且固件打印的窗口RMS与遥测按同一定义算出的一致
+ * - 单节点掉线：setNodeOnline()，该节点反馈停止更新，其余节点与总线不受影响，
+ *   重新上线后反馈恢复
+ * - 总线关闭+电机异常：setNodeFault() + injectBusOff()，恢复时清除异常并
+ *   重新进入闭环
+ * - 恢复中节点掉线：injectBusOff()时一个节点离线，恢复回调失败并重试，节点
+ *   上线后完成恢复
+ * - 全部掉线：帧无ACK，控制器进入错误被动，节点上线后恢复
+ * - 重建后总线关闭：经ExecutorFactory::rebuild()重建执行器（与保存设置的
+ *   路径相同），新执行器正常跟踪，随后电机异常+总线关闭仍由新执行器的恢复
+ *   回调清除异常并重新使能
+ *
+ * 任何检查失败都打印原因并以非0退出。
+ *
+ * 用法：sr6can_sim [--steady 毫秒] [--telemetry 文件] [--window-telemetry 前缀]
+ * - --steady：稳态阶段时长，默认5000
+ * - --telemetry：稳态阶段结束时保存遥测快照
+ * - --window-telemetry：开启跟踪前馈时，每个跟踪误差统计窗口结束时保存快照
+ *   到“前缀-序号-ff-on/off.tlm”（A/B模式下开、关窗口交替）
+ * 快照格式与GET /api/telemetry相同，可用scripts/telemetry_dump.py解析。
+ */
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdarg>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "executor/executor_factory.hpp"
+#include "executor/sr6can_executor.hpp"
+#include "globals.hpp"
+#include "select_thread.hpp"
+#include "setting_config.hpp"
+#include "telemetry.hpp"
+#include "twai/can_health.hpp"
+#include "twai/can_rx.hpp"
+#include "twai/can_schedule.hpp"
+#include "twai/mit.hpp"
+#include "twai/twai_sim.hpp"
+
+extern Setting default_setting;
+
+namespace {
+
+constexpr int kCommandMs = 20;           // TCode发送间隔
+constexpr int kSettleMs = 1000;          // 故障注入后的观察时长
+constexpr int kRecoverTimeoutMs = 3000;  // 等待恢复完成的最长时间
+constexpr int64_t kFreshUs = 100000;     // 反馈在此时间内更新视为正常
+constexpr float kMaxErrorRatio = 0.5f;   // 跟踪误差RMS相对轨迹幅度的上限
+constexpr uint32_t kRecentTicks = 150;   // 恢复后统计跟踪误差的节拍数
+constexpr int kAbWindows = 4;            // 前馈A/B阶段统计的窗口数
+constexpr double kMaxAbMismatch = 0.05;  // 固件与遥测窗口RMS的最大相对差
+
+std::atomic<bool> g_feeding{true};
+int g_failures = 0;
+int g_steady_ms = 5000;                     // 稳态统计时长
+const char *g_window_prefix = nullptr;      // 跟踪误差窗口快照的文件名前缀
+int g_window_index = 0;
+
+/**
+ * @brief 前馈A/B阶段收集的跟踪误差窗口
+ *
+ * firmware为TrackingFeedForward::report()打印的RMS，telemetry为同一窗口末尾
+ * 遥测快照按相同定义（只计新反馈样本）算出的RMS。
+ */
+struct AbWindows {
+    std::atomic<bool> collecting{false};
+    int count[2] = {};             // [0]前馈关，[1]前馈开
+    double firmware_sum[2] = {};
+    double telemetry_sum[2] = {};
+    double joint_sq[2][SR6CANServoNum] = {};  // 各关节误差平方和（遥测）
+    uint32_t joint_samples[2][SR6CANServoNum] = {};
+    double max_mismatch = 0.0;     // 两种算法的最大相对差
+};
+AbWindows g_ab;
+
+void check(bool ok, const char *what) {
+    std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok) {
+        g_failures++;
+    }
+}
+
+void sleepMs(int ms) { vTaskDelay(pdMS_TO_TICKS(ms)); }
+
+/**
+ * @brief 按串口来源的格式把一行TCode送入global_rx_queue（由解析任务释放）
+ */
+void sendTCode(const char *line) {
+    size_t len = strlen(line);
+    data_packet_t *packet = (data_packet_t *)malloc(sizeof(data_packet_t));
+    packet->source = DATA_SOURCE_UART;
+    packet->client_fd = -1;
+    packet->data = (uint8_t *)malloc(len);
+    memcpy(packet->data, line, len);
+    packet->length = len;
+    packet->user_data = nullptr;
+    if (xQueueSend(global_rx_queue, &packet, 0) != pdTRUE) {
+        free(packet->data);
+        free(packet);
+    }
+}
+
+/**
+ * @brief 各轴不同频率的正弦轨迹，每kCommandMs一条带插值间隔的TCode
+ */
+void feeder() {
+    const float kHz[] = {0.8f, 0.5f, 0.6f, 0.7f, 0.9f};  // L0 L1 L2 R1 R2
+    const float kAmp[] = {0.35f, 0.2f, 0.2f, 0.25f, 0.25f};
+    int64_t start = esp_timer_get_time();
+    while (g_feeding.load()) {
+        float t = (esp_timer_get_time() - start) * 1e-6f;
+        int v[5];
+        for (int i = 0; i < 5; i++) {
+            float x = 0.5f + kAmp[i] * std::sin(2.0f * (float)M_PI * kHz[i] * t);
+            v[i] = (int)(x * 9999.0f);
+        }
+        char line[96];
+        snprintf(line, sizeof(line),
+                 "L0%04dI%d L1%04dI%d L2%04dI%d R1%04dI%d R2%04dI%d\n", v[0],
+                 kCommandMs, v[1], kCommandMs, v[2], kCommandMs, v[3],
+                 kCommandMs, v[4], kCommandMs);
+        sendTCode(line);
+        std::this_thread::sleep_for(std::chrono::milliseconds(kCommandMs));
+    }
+}
+
+/**
+ * @brief 节点最近一次位置反馈（cmd 9）距今的时间，未收到过为INT64_MAX
+ */
+int64_t feedbackAge(uint8_t node) {
+    CanRx::Frame frame;
+    if (!CanRx::read(node, MIT::CMD_GET_ENCODER_ESTIMATES, frame)) {
+        return INT64_MAX;
+    }
+    return esp_timer_get_time() - frame.timestamp_us;
+}
+
+bool allFresh() {
+    for (uint8_t node = 1; node <= SR6CANServoNum; node++) {
+        if (feedbackAge(node) > kFreshUs) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 读出遥测快照（与GET /api/telemetry的下载内容相同）
+ */
+std::vector<uint8_t> telemetrySnapshot() {
+    std::vector<uint8_t> data;
+    esp_err_t ret = Telemetry::getInstance().stream(
+        [](void *arg, const char *chunk, size_t len) -> esp_err_t {
+            auto *out = static_cast<std::vector<uint8_t> *>(arg);
+            out->insert(out->end(), chunk, chunk + len);
+            return ESP_OK;
+        },
+        &data);
+    if (ret != ESP_OK) {
+        data.clear();
+    }
+    return data;
+}
+
+/**
+ * @brief 保存遥测快照
+ */
+void saveTelemetry(const char *path) {
+    std::vector<uint8_t> data = telemetrySnapshot();
+    FILE *f = data.empty() ? nullptr : fopen(path, "wb");
+    if (f == nullptr) {
+        std::printf("cannot save telemetry to %s\n", path);
+        return;
+    }
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+}
+
+/**
+ * @brief 一个关节在遥测窗口内的跟踪误差
+ */
+struct Tracking {
+    float rms;         // 新反馈样本与同一节拍指令之差的RMS，无样本为inf
+    float motion;      // 指令自身的标准差，即轨迹幅度
+    uint32_t samples;  // 新反馈样本数
+};
+
+/**
+ * @brief 由遥测快照最近last条记录计算各关节跟踪误差
+ *
+ * 与TrackingFeedForward的定义相同：只计实测值相对上一条记录有变化的记录
+ * （即本节拍收到的新反馈样本），误差为该样本与同一节拍轨迹目标之差。
+ * 陈旧反馈若逐节拍重复计入，误差里会多出“目标速度 × 反馈年龄”，这部分与
+ * 电机跟踪和前馈都无关，且随轨迹相位变化。
+ * @return 记录条数，无数据时为0
+ */
+uint32_t measureTracking(uint32_t last, Tracking *out) {
+    std::vector<uint8_t> data = telemetrySnapshot();
+    if (data.size() < sizeof(telemetry_header_t)) {
+        return 0;
+    }
+
+    telemetry_header_t header;
+    memcpy(&header, data.data(), sizeof(header));
+    size_t words = 1 + 2 * header.joints;
+    uint32_t first = header.records > last ? header.records - last : 0;
+    auto field = [&](uint32_t r, size_t index) {
+        float v;
+        memcpy(&v,
+               data.data() + sizeof(header) + (r * words + index) * sizeof(float),
+               sizeof(float));
+        return v;
+    };
+    for (size_t j = 0; j < header.joints && j < SR6CANServoNum; j++) {
+        double sq_sum = 0.0, sum = 0.0, cmd_sq = 0.0;
+        uint32_t samples = 0, records = 0;
+        for (uint32_t r = first; r < header.records; r++) {
+            float cmd = field(r, 1 + j);
+            float meas = field(r, 1 + header.joints + j);
+            if (std::isnan(meas)) {
+                continue;
+            }
+            sum += cmd;
+            cmd_sq += (double)cmd * cmd;
+            records++;
+            if (r > first && meas != field(r - 1, 1 + header.joints + j)) {
+                sq_sum += (double)(meas - cmd) * (meas - cmd);
+                samples++;
+            }
+        }
+        if (samples == 0) {
+            out[j] = {INFINITY, 0.0f, 0};
+            continue;
+        }
+        double mean = sum / records;
+        out[j].rms = (float)std::sqrt(sq_sum / samples);
+        out[j].motion = (float)std::sqrt(
+            std::fmax(cmd_sq / records - mean * mean, 0.0));
+        out[j].samples = samples;
+    }
+    return header.records - first;
+}
+
+/**
+ * @brief 记录一个前馈A/B窗口：固件打印的RMS与遥测按相同定义算出的RMS
+ */
+void collectAbWindow(const char *line) {
+    const char *rms = strstr(line, "rms=");
+    double firmware = rms != nullptr ? atof(rms + 4) : -1.0;
+    // 与固件窗口相同的区间：窗口开头的开关过渡之后直到窗口结束
+    uint32_t ticks = (uint32_t)((TRACKING_REPORT_MS / 1000.0f - TRACKING_RAMP_S) *
+                                CanSchedule::plan().tick_hz);
+    Tracking joints[SR6CANServoNum];
+    double sq_sum = 0.0;
+    uint32_t samples = 0;
+    measureTracking(ticks, joints);
+    for (const Tracking &t : joints) {
+        if (t.samples > 0) {
+            sq_sum += (double)t.rms * t.rms * t.samples;
+            samples += t.samples;
+        }
+    }
+    if (firmware <= 0.0 || samples == 0) {
+        return;
+    }
+    double telemetry = std::sqrt(sq_sum / samples);
+    int on = strstr(line, "ff=on") != nullptr ? 1 : 0;
+    for (int j = 0; j < SR6CANServoNum; j++) {
+        if (joints[j].samples > 0) {
+            g_ab.joint_sq[on][j] +=
+                (double)joints[j].rms * joints[j].rms * joints[j].samples;
+            g_ab.joint_samples[on][j] += joints[j].samples;
+        }
+    }
+    g_ab.count[on]++;
+    g_ab.firmware_sum[on] += firmware;
+    g_ab.telemetry_sum[on] += telemetry;
+    g_ab.max_mismatch = std::fmax(g_ab.max_mismatch,
+                                  std::fabs(telemetry - firmware) / firmware);
+    std::printf("window ff=%s: firmware rms %.4f, telemetry rms %.4f "
+                "(%lu samples)\n",
+                on ? "on" : "off", firmware, telemetry, (unsigned long)samples);
+}
+
+/**
+ * @brief 日志输出：照常打印，遇到跟踪误差窗口统计时保存该窗口的遥测快照，
+ *        A/B阶段同时记录该窗口的RMS
+ *
+ * 在执行器任务中（TrackingFeedForward::report）调用，快照只含该窗口末尾的
+ * TELEMETRY_RING_TICKS个节拍，不含窗口开头的开关过渡。
+ */
+int logHook(const char *format, va_list args) {
+    char line[512];
+    va_list copy;
+    va_copy(copy, args);
+    int n = vsnprintf(line, sizeof(line), format, copy);
+    va_end(copy);
+    if (n < 0 || n >= (int)sizeof(line)) {
+        return vprintf(format, args);
+    }
+    fputs(line, stdout);
+    if (strstr(line, "Tracking [") != nullptr && g_ab.collecting.load()) {
+        collectAbWindow(line);
+    }
+    if (strstr(line, "Tracking [") != nullptr && g_window_prefix != nullptr) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s-%02d-ff-%s.tlm", g_window_prefix,
+                 g_window_index++, strstr(line, "ff=on") ? "on" : "off");
+        saveTelemetry(path);
+    }
+    return n;
+}
+
+/**
+ * @brief 跟踪误差是否明显小于轨迹幅度（电机不出力时两者相当）
+ */
+bool tracks(const Tracking &t) { return t.rms < kMaxErrorRatio * t.motion; }
+
+/**
+ * @brief 等待CanHealth完成恢复次数达到target，返回耗时（毫秒），超时为-1
+ */
+int waitRecoveries(uint32_t target) {
+    int64_t start = esp_timer_get_time();
+    while (esp_timer_get_time() - start < kRecoverTimeoutMs * 1000ll) {
+        if (CanHealth::getStats().recoveries >= target &&
+            CanHealth::state() == CanHealth::State::ACTIVE) {
+            return (int)((esp_timer_get_time() - start) / 1000);
+        }
+        sleepMs(10);
+    }
+    return -1;
+}
+
+/**
+ * @brief 稳态：吞吐、延迟、负载与跟踪误差
+ */
+void steadyState(const char *telemetry_path) {
+    std::printf("\n== steady state (%d ms)\n", g_steady_ms);
+    twai_sim::takeStats();
+    int64_t start = esp_timer_get_time();
+    sleepMs(g_steady_ms);
+    twai_sim::Stats s = twai_sim::takeStats();
+    float window_s = (esp_timer_get_time() - start) * 1e-6f;
+
+    CanSchedule::Plan plan = CanSchedule::plan();
+    uint32_t delivered = s.replies - s.filtered - s.rx_missed;
+    float rtt_avg = delivered > 0 ? (float)s.rtt_sum_us / delivered : 0.0f;
+    float load = s.busy_us / (window_s * 1e6f);
+    Tracking joints[SR6CANServoNum];
+    uint32_t records = measureTracking(TELEMETRY_RING_TICKS, joints);
+    if (telemetry_path != nullptr) {
+        saveTelemetry(telemetry_path);
+    }
+    std::printf("tick %lu Hz, planned load %.1f%%, feedback %.0f Hz\n",
+                (unsigned long)plan.tick_hz, plan.planned_load * 100.0f,
+                plan.feedback_hz);
+    std::printf("tx %.0f frames/s, replies %.0f/s, bus load %.1f%% "
+                "(schedule measured %.1f%%)\n",
+                s.tx_frames / window_s, s.replies / window_s, load * 100.0f,
+                CanSchedule::measuredLoad() * 100.0f);
+    std::printf("request->reply rtt avg %.0f us, max %lu us, tx queue max %lu\n",
+                rtt_avg, (unsigned long)s.rtt_max_us,
+                (unsigned long)s.tx_queue_max);
+    bool all_track = records > 0;
+    for (int j = 0; j < SR6CANServoNum; j++) {
+        std::printf("joint %d: tracking rms %.4f rad, motion %.4f rad\n", j,
+                    joints[j].rms, joints[j].motion);
+        all_track = all_track && tracks(joints[j]);
+    }
+
+    float control_rate = (float)plan.tick_hz * SR6CANServoNum;
+    check(s.tx_frames / window_s >= 0.95f * control_rate,
+          "control frames keep up with the tick rate");
+    check(s.unacked == 0 && s.rx_missed == 0, "no unacked frames or rx drops");
+    check(load < 1.0f && load > 0.0f, "bus load below 100%");
+    check(allFresh(), "feedback fresh on every node");
+    check(all_track, "every joint tracks its trajectory");
+}
+
+#if SR6CAN_FEEDFORWARD == 2
+/**
+ * @brief 跟踪前馈A/B：开启时的跟踪误差RMS不大于关闭时，且固件打印的RMS与
+ *        遥测按同一定义算出的RMS一致
+ */
+void feedForwardAB() {
+    std::printf("\n== feed-forward A/B (%d windows of %d ms)\n", kAbWindows,
+                TRACKING_REPORT_MS);
+    g_ab.collecting = true;
+    sleepMs(kAbWindows * TRACKING_REPORT_MS + TRACKING_REPORT_MS / 2);
+    g_ab.collecting = false;
+
+    double firmware[2], telemetry[2];
+    for (int on = 0; on < 2; on++) {
+        int n = g_ab.count[on] > 0 ? g_ab.count[on] : 1;
+        firmware[on] = g_ab.firmware_sum[on] / n;
+        telemetry[on] = g_ab.telemetry_sum[on] / n;
+    }
+    std::printf("ff off -> on: firmware rms %.4f -> %.4f (%+.0f%%), "
+                "telemetry rms %.4f -> %.4f (%+.0f%%)\n",
+                firmware[0], firmware[1],
+                (firmware[1] / firmware[0] - 1.0) * 100.0, telemetry[0],
+                telemetry[1], (telemetry[1] / telemetry[0] - 1.0) * 100.0);
+    std::printf("max firmware/telemetry mismatch %.0f%%\n",
+                g_ab.max_mismatch * 100.0);
+    bool joints_ok = true;
+    for (int j = 0; j < SR6CANServoNum; j++) {
+        double rms[2];
+        for (int on = 0; on < 2; on++) {
+            uint32_t n = g_ab.joint_samples[on][j];
+            rms[on] = n > 0 ? std::sqrt(g_ab.joint_sq[on][j] / n) : INFINITY;
+        }
+        std::printf("joint %d: ff off %.4f -> on %.4f rad\n", j, rms[0],
+                    rms[1]);
+        joints_ok = joints_ok && rms[1] <= rms[0];
+    }
+    check(g_ab.count[0] > 0 && g_ab.count[1] > 0,
+          "A/B windows measured with feed-forward on and off");
+    check(firmware[1] <= firmware[0],
+          "feed-forward does not worsen tracking (firmware report)");
+    check(telemetry[1] <= telemetry[0],
+          "feed-forward does not worsen tracking (telemetry)");
+    check(joints_ok, "feed-forward does not worsen any joint");
+    check(g_ab.max_mismatch < kMaxAbMismatch,
+          "firmware and telemetry tracking rms agree");
+}
+#endif
+
+/**
+ * @brief 单个节点掉线再上线
+ */
+void nodeDropout() {
+    const uint8_t node = 3;
+    std::printf("\n== node %u offline\n", node);
+    CanHealth::Stats before = CanHealth::getStats();
+    twai_sim::setNodeOnline(node, false);
+    sleepMs(kSettleMs);
+    twai_sim::Stats s = twai_sim::takeStats();
+    check(std::isnan(twai_sim::nodePosition(node)), "offline node not simulated");
+    check(feedbackAge(node) > kSettleMs * 1000ll / 2, "offline node feedback stale");
+    check(s.unacked == 0, "other nodes still ACK");
+    CanHealth::Stats after = CanHealth::getStats();
+    check(after.bus_off == before.bus_off &&
+              after.error_passive == before.error_passive &&
+              CanHealth::state() == CanHealth::State::ACTIVE,
+          "bus stays error active");
+
+    twai_sim::setNodeOnline(node, true);
+    sleepMs(kSettleMs);
+    check(allFresh(), "feedback resumes after node returns");
+}
+
+/**
+ * @brief 电机异常 + 总线关闭：恢复时清除异常并重新使能
+ */
+void busOffWithFault() {
+    const uint8_t node = 2;
+    std::printf("\n== bus-off with node %u faulted\n", node);
+    CanHealth::Stats before = CanHealth::getStats();
+    uint32_t generation = CanHealth::generation();
+    twai_sim::setNodeFault(node, 0x0000000100000000ull);
+    twai_sim::injectBusOff();
+    int ms = waitRecoveries(before.recoveries + 1);
+    CanHealth::Stats after = CanHealth::getStats();
+    std::printf("recovered in %d ms (CanHealth last %lu ms)\n", ms,
+                (unsigned long)after.last_recovery_ms);
+    check(ms >= 0, "recovery completes");
+    check(after.bus_off == before.bus_off + 1, "one bus-off counted");
+    check(after.resume_failures == before.resume_failures,
+          "fault cleared on the first resume");
+    check(CanHealth::generation() == generation + 1, "generation advanced");
+
+    sleepMs(kSettleMs);
+    check(allFresh(), "feedback fresh after recovery");
+    // 异常未清除时模拟电机不出力，跟踪误差与轨迹幅度相当
+    Tracking joints[SR6CANServoNum];
+    measureTracking(kRecentTicks, joints);
+    std::printf("node %u tracking rms %.4f rad, motion %.4f rad\n", node,
+                joints[node - 1].rms, joints[node - 1].motion);
+    check(tracks(joints[node - 1]), "faulted node tracks again");
+}
+
+/**
+ * @brief 恢复期间节点掉线：恢复回调失败并重试，节点上线后完成
+ */
+void resumeWithNodeMissing() {
+    const uint8_t node = 5;
+    std::printf("\n== bus-off with node %u offline\n", node);
+    CanHealth::Stats before = CanHealth::getStats();
+    twai_sim::setNodeOnline(node, false);
+    twai_sim::injectBusOff();
+    sleepMs(kSettleMs);
+    CanHealth::Stats mid = CanHealth::getStats();
+    std::printf("resume failures while offline: %lu\n",
+                (unsigned long)(mid.resume_failures - before.resume_failures));
+    check(mid.resume_failures > before.resume_failures,
+          "resume fails while a node is missing");
+    check(!CanHealth::streaming(), "control output held");
+
+    twai_sim::setNodeOnline(node, true);
+    int ms = waitRecoveries(before.recoveries + 1);
+    std::printf("recovered %d ms after node returned\n", ms);
+    check(ms >= 0, "recovery completes once the node is back");
+    sleepMs(kSettleMs);
+    check(allFresh(), "feedback fresh after recovery");
+}
+
+/**
+ * @brief 全部节点掉线：无ACK进入错误被动，上线后恢复
+ */
+void allNodesOffline() {
+    std::printf("\n== all nodes offline\n");
+    CanHealth::Stats before = CanHealth::getStats();
+    for (uint8_t node = 1; node <= SR6CANServoNum; node++) {
+        twai_sim::setNodeOnline(node, false);
+    }
+    sleepMs(kSettleMs);
+    CanHealth::Stats mid = CanHealth::getStats();
+    twai_sim::Stats s = twai_sim::takeStats();
+    std::printf("unacked attempts %lu\n", (unsigned long)s.unacked);
+    check(s.unacked > 0, "frames without ACK");
+    check(mid.error_passive == before.error_passive + 1,
+          "controller enters error passive");
+    check(mid.bus_off == before.bus_off, "no bus-off from ACK errors");
+
+    for (uint8_t node = 1; node <= SR6CANServoNum; node++) {
+        twai_sim::setNodeOnline(node, true);
+    }
+    int ms = waitRecoveries(before.recoveries + 1);
+    std::printf("recovered %d ms after nodes returned\n", ms);
+    check(ms >= 0, "recovery completes once nodes are back");
+    sleepMs(kSettleMs);
+    check(allFresh(), "feedback fresh after recovery");
+}
+
+/**
+ * @brief 重建执行器后总线关闭：恢复回调、发送队列属于新执行器
+ */
+void rebuildThenBusOff(const SettingWrapper &setting) {
+    const uint8_t node = 4;
+    std::printf("\n== rebuild executor, then bus-off with node %u faulted\n",
+                node);
+    ExecutorFactory::rebuild(g_executor, setting);
+    check(g_executor != nullptr, "executor rebuilt");
+    sleepMs(kSettleMs);
+    check(allFresh(), "feedback fresh after rebuild");
+    Tracking joints[SR6CANServoNum];
+    bool all_track = measureTracking(kRecentTicks, joints) > 0;
+    for (int j = 0; j < SR6CANServoNum; j++) {
+        all_track = all_track && tracks(joints[j]);
+    }
+    check(all_track, "every joint tracks after rebuild");
+
+    CanHealth::Stats before = CanHealth::getStats();
+    twai_sim::setNodeFault(node, 0x0000000100000000ull);
+    twai_sim::injectBusOff();
+    int ms = waitRecoveries(before.recoveries + 1);
+    std::printf("recovered in %d ms\n", ms);
+    check(ms >= 0, "recovery completes");
+    sleepMs(kSettleMs);
+    check(allFresh(), "feedback fresh after recovery");
+    measureTracking(kRecentTicks, joints);
+    std::printf("node %u tracking rms %.4f rad, motion %.4f rad\n", node,
+                joints[node - 1].rms, joints[node - 1].motion);
+    check(tracks(joints[node - 1]),
+          "rebuilt executor's resume handler re-enables the faulted node");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const char *telemetry_path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetry_path = argv[++i];
+        } else if (strcmp(argv[i], "--steady") == 0 && i + 1 < argc) {
+            g_steady_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--window-telemetry") == 0 &&
+                   i + 1 < argc) {
+            g_window_prefix = argv[++i];
+        }
+    }
+
+    // 每条TCode一行INFO日志，仿真中只保留告警
+    esp_log_level_set("TCode", ESP_LOG_WARN);
+    if (g_window_prefix != nullptr || SR6CAN_FEEDFORWARD == 2) {
+        esp_log_set_vprintf(logHook);
+    }
+    global_rx_queue = xQueueCreate(32, sizeof(data_packet_t *));
+
+    // 仿真电机：惯量0.002、阻尼0.01，kp=20/kd=0.3约100 rad/s、阻尼比0.78
+    Setting setting = default_setting;
+    setting.servo = getDefaultServoConfig();
+    setting.servo.MODE = 8;  // SR6CAN
+    float *gains[][2] = {{&setting.mit.Kp_a, &setting.mit.Kd_a},
+                         {&setting.mit.Kp_b, &setting.mit.Kd_b},
+                         {&setting.mit.Kp_c, &setting.mit.Kd_c},
+                         {&setting.mit.Kp_d, &setting.mit.Kd_d},
+                         {&setting.mit.Kp_e, &setting.mit.Kd_e},
+                         {&setting.mit.Kp_f, &setting.mit.Kd_f}};
+    for (auto &g : gains) {
+        *g[0] = 20.0f;
+        *g[1] = 0.3f;
+    }
+
+    // 最后一个执行器不析构：任务与定时器随进程结束
+    SettingWrapper wrapper(setting);
+    ExecutorFactory::rebuild(g_executor, wrapper);
+    std::thread(feeder).detach();
+    sleepMs(kSettleMs);
+
+    steadyState(telemetry_path);
+#if SR6CAN_FEEDFORWARD == 2
+    feedForwardAB();
+#endif
+    nodeDropout();
+    busOffWithFault();
+    resumeWithNodeMissing();
+    allNodesOffline();
+    rebuildThenBusOff(wrapper);
+
+    g_feeding = false;
+    CanHealth::Stats h = CanHealth::getStats();
+    std::printf("\nCanHealth: bus_off=%lu error_passive=%lu recoveries=%lu "
+                "resume_failures=%lu max_recovery=%lu ms\n",
+                (unsigned long)h.bus_off, (unsigned long)h.error_passive,
+                (unsigned long)h.recoveries, (unsigned long)h.resume_failures,
+                (unsigned long)h.max_recovery_ms);
+    std::printf(g_failures == 0 ? "all checks passed\n" : "%d failures\n",
+                g_failures);
+    fflush(stdout);
+    _exit(g_failures == 0 ? 0 : 1);
+}
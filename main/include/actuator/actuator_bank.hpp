@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "actuator/ledc_allocator.hpp"
+#include "actuator/ledc_duty.hpp"
+#include "driver/ledc.h"
+
+// 置1时启动阶段运行actuator::benchmarkActuatorBank()，对比逐通道与批量写入耗时
+#ifndef ACTUATOR_BANK_BENCHMARK
+#define ACTUATOR_BANK_BENCHMARK 0
+#endif
+
+// 相邻通道脉冲起点（hpoint）错开的时间（微秒），0表示所有通道在同一边沿开始，
+// 非0时lane i延后i*ACTUATOR_BANK_STAGGER_US，错开多个舵机同时启动的电流峰值
+#ifndef ACTUATOR_BANK_STAGGER_US
+#define ACTUATOR_BANK_STAGGER_US 0
+#endif
+
+namespace actuator {
+
+/**
+ * @brief LEDC舵机组，按节拍批量写入
+ *
+ * 每个通道可使用不同的PWM频率，由LedcTimerAllocator把相同频率的通道分到
+ * 同一个LEDC定时器，同一定时器下的通道共用一个周期边界。ActuatorBank先为
+ * 所有通道计算并写入占空比，再集中触发ledc_update_duty，使各通道在各自定时器
+ * 的下一个周期生效；占空比换算参数在添加通道时预先计算，写入路径无虚函数
+ * 调用、无逐通道加锁（调用方负责串行化，执行器中已由m_compute_mutex保护）。
+ *
+ * 输入与LEDCActuator一致：-1到1映射到500-2500us，自动加上各通道offset。
+ */
+class ActuatorBank {
+   public:
+    static constexpr size_t MAX_LANES = 6;
+
+    /**
+     * @brief 构造函数，定时器在添加通道时按频率分配
+     */
+    ActuatorBank();
+
+    /**
+     * @brief 析构函数，停止所有通道输出
+     */
+    ~ActuatorBank();
+
+    ActuatorBank(const ActuatorBank&) = delete;
+    ActuatorBank& operator=(const ActuatorBank&) = delete;
+
+    /**
+     * @brief 绑定一个通道
+     * @param lane 通道序号（0到MAX_LANES-1，对应舵机A-F）
+     * @param gpio_num GPIO引脚号，-1表示该通道未使用
+     * @param channel LEDC通道号
+     * @param freq_hz PWM频率（50-333Hz）
+     * @param offset 偏移量
+     * @throws std::runtime_error 序号越界、频率非法、定时器不足或通道配置失败
+     */
+    void addLane(size_t lane, int gpio_num, ledc_channel_t channel,
+                 uint32_t freq_hz, float offset = 0.0f);
+
+    /**
+     * @brief 批量设置目标值并在同一PWM周期生效
+     * @param targets 目标值数组，范围[-1, 1]，targets[i]对应lane i
+     * @param count 数组长度，超出MAX_LANES的部分忽略
+     */
+    void setTargets(const float* targets, size_t count);
+
+    /**
+     * @brief 获取通道最近一次的目标值（含offset、已限幅）
+     */
+    float getTarget(size_t lane) const {
+        return lane < MAX_LANES ? m_lanes[lane].target : 0.0f;
+    }
+
+    /**
+     * @brief 通道是否已绑定
+     */
+    bool hasLane(size_t lane) const {
+        return lane < MAX_LANES && m_lanes[lane].enabled;
+    }
+
+   private:
+    struct Lane {
+        bool enabled;
+        ledc_channel_t channel;
+        float offset;
+        float target;
+        uint32_t residual;  // 占空比量化余数（Q16），LEDC_DUTY_DITHER时使用
+        uint32_t hpoint;    // 脉冲起点（错相时非0）
+        LedcDutyMapper mapper;  // 按该通道频率和分辨率预先计算的换算参数
+    };
+
+    LedcTimerAllocator m_timers;
+    std::array<Lane, MAX_LANES> m_lanes;
+};
+
+/**
+ * @brief 对比LEDCActuator逐通道写入与ActuatorBank批量写入的耗时
+ * @param gpio_nums 6个GPIO引脚号（-1表示不使用）
+ * @param freq_hz PWM频率
+ */
+void benchmarkActuatorBank(const int gpio_nums[ActuatorBank::MAX_LANES],
+                           uint32_t freq_hz);
+
+}  // namespace actuator
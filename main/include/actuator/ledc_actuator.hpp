@@ -2,6 +2,7 @@
 
 #include <mutex>
 #include "actuator/actuator.hpp"
+#include "actuator/ledc_duty.hpp"
 #include "driver/ledc.h"
 
 namespace actuator {
@@ -10,9 +11,10 @@ namespace actuator {
  * @brief LEDC执行器实现类
  *
  * 使用LEDC外设实现PWM输出，将-1到1的输入映射到500-2500us的高电平持续时间
- * 使用14位分辨率实现精确的PWM控制
+ * 使用14位分辨率实现精确的PWM控制，占空比换算系数在构造时预先计算，
+ * 可选LEDC_DUTY_DITHER时间抖动提高平均脉宽分辨率
  */
-class LEDCActuator : public Actuator {
+class LEDCActuator final : public Actuator {
    public:
     /**
      * @brief 构造函数
@@ -21,8 +23,10 @@ class LEDCActuator : public Actuator {
      * @param timer LEDC定时器号
      * @param freq_hz PWM频率，默认50Hz
      * @param offset 偏移量，默认为0.0f
+     * @param resolution 占空比分辨率，默认14位（见LedcTimerAllocator::bestResolution）
      */
-    LEDCActuator(int gpio_num, ledc_channel_t channel, ledc_timer_t timer, uint32_t freq_hz = 50, float offset = 0.0f);
+    LEDCActuator(int gpio_num, ledc_channel_t channel, ledc_timer_t timer, uint32_t freq_hz = 50, float offset = 0.0f,
+                 ledc_timer_bit_t resolution = LEDC_TIMER_14_BIT);
 
     /**
      * @brief 析构函数
@@ -48,8 +52,10 @@ class LEDCActuator : public Actuator {
     ledc_channel_t m_channel;                                // LEDC通道
     ledc_timer_t m_timer;                                    // LEDC定时器
     uint32_t m_freq_hz;                                      // PWM频率
-    ledc_timer_bit_t m_duty_resolution = LEDC_TIMER_14_BIT;  // PWM分辨率(14位)
+    ledc_timer_bit_t m_duty_resolution;                      // PWM分辨率
     std::mutex m_mutex;                                      // 互斥锁
+    LedcDutyMapper m_duty_mapper;                            // 占空比换算
+    uint32_t m_duty_residual = 0;                            // 量化余数（Q16）
 
     /**
      * @brief 初始化LEDC
@@ -62,7 +68,9 @@ class LEDCActuator : public Actuator {
      * @param target 目标值，范围[-1, 1]
      * @return PWM占空比值
      */
-    uint32_t targetToDuty(float target);
+    uint32_t targetToDuty(float target) {
+        return m_duty_mapper.toDuty(target, m_duty_residual);
+    }
 };
 
 }  // namespace actuator
\ No newline at end of file
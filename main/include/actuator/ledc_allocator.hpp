@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "driver/ledc.h"
+
+namespace actuator {
+
+/**
+ * @brief 分配得到的LEDC定时器
+ */
+struct LedcTimerSlot {
+    ledc_timer_t timer;            // 定时器号
+    ledc_timer_bit_t resolution;   // 该频率下可用的最高占空比分辨率
+    uint32_t freq_hz;              // PWM频率
+};
+
+/**
+ * @brief LEDC定时器分配器
+ *
+ * 一个LEDC定时器决定一组通道的频率和分辨率。分配器按请求的频率分组：
+ * 相同频率的通道共用一个定时器，新频率占用下一个空闲定时器，并选择该频率
+ * 下时钟分频允许的最高分辨率。定时器用完（C3共4个，即最多4种频率）或
+ * 频率无法实现时抛出异常并在日志中列出已占用的频率。
+ *
+ * 每个执行器持有一个分配器，执行器独占全部LEDC定时器。
+ */
+class LedcTimerAllocator {
+   public:
+    static constexpr size_t MAX_TIMERS = LEDC_TIMER_MAX;
+
+    /**
+     * @brief 获取指定频率的定时器，首次使用时配置
+     * @param freq_hz PWM频率
+     * @return 定时器及其分辨率
+     * @throws std::runtime_error 定时器已用完、频率无法实现或配置失败
+     */
+    LedcTimerSlot acquire(uint32_t freq_hz);
+
+    /**
+     * @brief 计算频率可用的最高分辨率
+     * @param freq_hz PWM频率
+     * @return 分辨率位数，0表示无法实现
+     */
+    static uint32_t bestResolution(uint32_t freq_hz);
+
+    size_t timersUsed() const { return m_used; }
+
+   private:
+    std::array<LedcTimerSlot, MAX_TIMERS> m_slots{};
+    size_t m_used = 0;
+};
+
+}  // namespace actuator
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+// 置1时启用占空比时间抖动：每次更新把量化余数累加到下一次，
+// 多个PWM周期平均后的脉宽分辨率优于1个LEDC步进（14位/50Hz下约1.22us）
+#ifndef LEDC_DUTY_DITHER
+#define LEDC_DUTY_DITHER 0
+#endif
+
+namespace actuator {
+
+/**
+ * @brief 舵机目标值到LEDC占空比的定点换算
+ *
+ * 构造时按频率和分辨率预先计算Q16定点系数，之后每次换算只需一次浮点乘法、
+ * 一次取整和若干整数运算。-1到1映射到500-2500us高电平，与LEDCActuator原有
+ * 映射一致。
+ *
+ * 余数（Q16的低16位）由调用方按通道保存：关闭抖动时直接截断；开启抖动时
+ * 余数在多次更新间累加，满1个步进时本次输出加1，相当于一阶sigma-delta，
+ * 输出的时间平均值逼近理想占空比。
+ *
+ * 误差：Q16系数取整和浮点乘法的误差只有几个Q16单位，因此恰好落在步进边界
+ * 附近的目标值可能与原浮点实现（或double精确截断）相差1个步进，不会超过1个
+ * 步进。14位下每2M个随机目标值约有41~1246个相差1（50~333Hz），1个步进在
+ * 50Hz下约1.22us。
+ */
+class LedcDutyMapper {
+   public:
+    static constexpr int FRAC_BITS = 16;
+    static constexpr uint32_t FRAC_ONE = 1u << FRAC_BITS;
+    static constexpr uint32_t FRAC_MASK = FRAC_ONE - 1;
+
+    LedcDutyMapper() = default;
+
+    /**
+     * @brief 预先计算换算系数
+     * @param freq_hz PWM频率
+     * @param resolution_bits 占空比分辨率位数
+     */
+    LedcDutyMapper(uint32_t freq_hz, uint32_t resolution_bits) {
+        m_duty_limit = (1u << resolution_bits) - 1;
+        // 1us对应的占空比步数（Q16），用double计算一次避免累积误差
+        double steps_per_us = (double)m_duty_limit * freq_hz / 1000000.0;
+        double q_per_us = steps_per_us * FRAC_ONE;
+        m_center_q = (int32_t)(1500.0 * q_per_us + 0.5);
+        m_per_unit_q = (float)(1000.0 * q_per_us);
+        m_min_q = (int32_t)(500.0 * q_per_us + 0.5);
+        m_max_q = (int32_t)(2500.0 * q_per_us + 0.5);
+        uint32_t limit_q = m_duty_limit << FRAC_BITS;
+        if ((uint32_t)m_max_q > limit_q) {
+            m_max_q = (int32_t)limit_q;
+        }
+    }
+
+    /**
+     * @brief 目标值转换为占空比
+     * @param target 目标值，范围[-1, 1]（调用方已限幅）
+     * @param residual 该通道的量化余数（Q16），开启抖动时读写
+     * @return LEDC占空比
+     */
+    inline uint32_t toDuty(float target, uint32_t& residual) const {
+        int32_t q = m_center_q + (int32_t)(target * m_per_unit_q);
+        if (q < m_min_q) {
+            q = m_min_q;
+        } else if (q > m_max_q) {
+            q = m_max_q;
+        }
+        uint32_t duty = (uint32_t)q >> FRAC_BITS;
+#if LEDC_DUTY_DITHER
+        residual += (uint32_t)q & FRAC_MASK;
+        if (residual >= FRAC_ONE) {
+            residual -= FRAC_ONE;
+            if (duty < m_duty_limit) {
+                duty++;
+            }
+        }
+#else
+        (void)residual;
+#endif
+        return duty;
+    }
+
+    /**
+     * @brief 1个LEDC步进对应的脉宽（纳秒），用于日志
+     */
+    uint32_t stepNs(uint32_t freq_hz) const {
+        return m_duty_limit ? (uint32_t)(1000000000ull / freq_hz / m_duty_limit)
+                            : 0;
+    }
+
+   private:
+    int32_t m_center_q = 0;      // 1500us对应的占空比（Q16）
+    float m_per_unit_q = 0.0f;   // 目标值每1.0对应的占空比（Q16）
+    int32_t m_min_q = 0;         // 500us对应的占空比（Q16）
+    int32_t m_max_q = 0;         // 2500us对应的占空比（Q16）
+    uint32_t m_duty_limit = 0;   // 分辨率允许的最大占空比
+};
+
+}  // namespace actuator
@@ -4,6 +4,12 @@
 #include "actuator/actuator.hpp"
 #include "driver/rmt_tx.h"
 
+// 置1时RMT以硬件循环方式持续输出完整PWM周期，更新目标只改写脉宽；
+// 置0时恢复每次setTarget发送单个脉冲的方式
+#ifndef RMT_ACTUATOR_LOOP
+#define RMT_ACTUATOR_LOOP 1
+#endif
+
 namespace actuator {
 
 /**
@@ -11,15 +17,22 @@ namespace actuator {
  *
  * 使用RMT外设实现精确的脉冲输出，将-1到1的输入映射到500-2500us的高电平持续时间
  * 适合控制舵机、编码器等需要精确时序的设备
+ *
+ * RMT_ACTUATOR_LOOP模式下，一个RMT符号即一个完整周期（高电平脉宽+低电平补足周期），
+ * 以loop_count=-1无限循环发送，舵机刷新由硬件定时，与运动节拍无关。
+ * 更新脉宽时直接改写通道RAM中的该符号（32位单次写入），下一个周期生效；
+ * 若符号不在通道RAM中（例如启用了DMA），则在低电平段重启循环发送；调用时若
+ * 正处于高电平段，不在运动节拍中等待，而是推迟到下一次actuate（下一节拍）。
  */
-class RMTActuator : public Actuator {
+class RMTActuator final : public Actuator {
    public:
     /**
      * @brief 构造函数
      * @param gpio_num 输出GPIO引脚号
      * @param offset 偏移量，默认为0.0f
+     * @param freq_hz PWM频率（循环模式使用），默认50Hz
      */
-    RMTActuator(int gpio_num, float offset = 0.0f);
+    RMTActuator(int gpio_num, float offset = 0.0f, uint32_t freq_hz = 50);
 
     /**
      * @brief 析构函数
@@ -42,6 +55,19 @@ class RMTActuator : public Actuator {
     rmt_transmit_config_t m_tx_config;  // 传输配置
     std::mutex m_mutex;                 // 互斥锁
     bool m_initialized = false;         // 初始化标志
+    uint32_t m_period_us;               // PWM周期(微秒)
+    uint32_t m_pulse_width = 0;         // 当前输出的脉宽(微秒)，0表示尚未输出
+    int64_t m_loop_start_us = 0;        // 循环发送开始时间，用于判断周期相位
+    volatile uint32_t* m_hw_symbol = nullptr;  // 循环符号在通道RAM中的地址
+    bool m_restart_pending = false;     // 重启因处于高电平段被推迟
+
+    /**
+     * @brief 以循环方式重新发送当前脉宽
+     *
+     * 正在循环时若处于高电平段则只标记m_restart_pending，由下一次actuate重试
+     * @return true 成功或已推迟，false 失败
+     */
+    bool restartLoop();
 
     /**
      * @brief 初始化RMT
@@ -56,6 +82,16 @@ class RMTActuator : public Actuator {
      */
     uint32_t targetToPulseWidth(float target);
 
+    /**
+     * @brief 生成RMT符号
+     * @param high_us 高电平时长(微秒)
+     * @param low_us 低电平时长(微秒)，0表示结束标志
+     */
+    static uint32_t makeSymbol(uint32_t high_us, uint32_t low_us) {
+        // 位域布局: duration0(15bits) | level0(1bit) | duration1(15bits) | level1(1bit)
+        return (high_us & 0x7FFF) | (1u << 15) | ((low_us & 0x7FFF) << 16);
+    }
+
     /**
      * @brief 编码器函数，将脉冲宽度转换为RMT符号
      */
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "driver/rmt_tx.h"
+#include "soc/soc_caps.h"
+
+// 相邻通道脉冲起点错开的时间（微秒），0表示所有通道在同一边沿开始，
+// 非0时第i个通道延后i*RMT_SERVO_BANK_STAGGER_US，错开多个舵机同时启动的电流峰值
+#ifndef RMT_SERVO_BANK_STAGGER_US
+#define RMT_SERVO_BANK_STAGGER_US 0
+#endif
+
+namespace actuator {
+
+/**
+ * @brief RMT舵机组，多个TX通道同步输出
+ *
+ * 所有通道由rmt_new_sync_manager绑定，同一次启动、同一时钟，循环发送完整的
+ * PWM周期（与RMT_ACTUATOR_LOOP相同），因此各通道脉冲相位对齐，可选按通道错开
+ * 固定延时。更新目标值时原位改写通道RAM中的符号，下一个周期生效；若符号不在
+ * 通道RAM中，则在所有通道的低电平段一起重启并重新同步；调用时若有通道正处于
+ * 高电平段，不在运动节拍中等待，而是推迟到下一次setTargets（下一节拍）。
+ *
+ * 接口与ActuatorBank一致：-1到1映射到500-2500us，自动加上各通道offset，
+ * 批量setTargets。调用方负责串行化。
+ */
+class RMTServoBank {
+   public:
+    static constexpr size_t MAX_LANES = SOC_RMT_TX_CANDIDATES_PER_GROUP;
+
+    /**
+     * @brief 构造函数，创建并同步启动所有通道，初始输出中位
+     * @param gpio_nums GPIO引脚号数组
+     * @param offsets 各通道偏移量数组
+     * @param count 通道数量（1到MAX_LANES）
+     * @param freq_hz PWM频率（50-333Hz）
+     * @param stagger_us 相邻通道脉冲起点错开的时间（微秒）
+     * @throws std::runtime_error 参数非法或RMT初始化失败
+     */
+    RMTServoBank(const int* gpio_nums, const float* offsets, size_t count,
+                 uint32_t freq_hz,
+                 uint32_t stagger_us = RMT_SERVO_BANK_STAGGER_US);
+
+    /**
+     * @brief 析构函数，停止并释放所有通道
+     */
+    ~RMTServoBank();
+
+    RMTServoBank(const RMTServoBank&) = delete;
+    RMTServoBank& operator=(const RMTServoBank&) = delete;
+
+    /**
+     * @brief 批量设置目标值
+     * @param targets 目标值数组，范围[-1, 1]，targets[i]对应lane i
+     * @param count 数组长度，超出通道数的部分忽略
+     */
+    void setTargets(const float* targets, size_t count);
+
+    /**
+     * @brief 获取通道最近一次的目标值（含offset、已限幅）
+     */
+    float getTarget(size_t lane) const {
+        return lane < m_count ? m_lanes[lane].target : 0.0f;
+    }
+
+    size_t laneCount() const { return m_count; }
+
+    /**
+     * @brief 最近一次setTargets的耗时（微秒）
+     */
+    uint32_t lastLatencyUs() const { return m_last_latency_us; }
+
+    /**
+     * @brief setTargets的最大耗时（微秒）
+     */
+    uint32_t maxLatencyUs() const { return m_max_latency_us; }
+
+   private:
+    struct Lane {
+        rmt_channel_handle_t channel;
+        rmt_encoder_handle_t encoder;
+        float offset;
+        float target;
+        uint32_t pulse_us;                // 当前脉宽
+        uint32_t delay_us;                // 周期内脉冲起点延时
+        rmt_symbol_word_t symbols[2];     // 一个周期的波形
+        size_t symbol_count;
+        volatile uint32_t* hw_symbols;    // 符号在通道RAM中的地址
+    };
+
+    std::array<Lane, MAX_LANES> m_lanes;
+    size_t m_count = 0;
+    uint32_t m_period_us;
+    rmt_sync_manager_handle_t m_sync = nullptr;
+    int64_t m_start_us = 0;               // 最近一次同步启动的时间
+    bool m_restart_pending = false;       // 重启因处于高电平段被推迟
+    uint32_t m_last_latency_us = 0;
+    uint32_t m_max_latency_us = 0;
+    uint32_t m_ticks = 0;
+
+    /**
+     * @brief 按脉宽和延时生成一个周期的符号
+     */
+    void encodeLane(Lane& lane) const;
+
+    /**
+     * @brief 同步（重新）启动所有通道的循环发送
+     *
+     * 重启时若有通道处于高电平段则只标记m_restart_pending，由下一次setTargets重试
+     * @return true 成功或已推迟，false 失败
+     */
+    bool start();
+
+    /**
+     * @brief 释放所有RMT资源
+     */
+    void release();
+
+    /**
+     * @brief 编码器函数，复制通道的符号并记录其在通道RAM中的地址
+     */
+    static size_t encoderCallback(const void* data,
+                                  size_t data_size,
+                                  size_t symbols_written,
+                                  size_t symbols_free,
+                                  rmt_symbol_word_t* symbols,
+                                  bool* done,
+                                  void* arg);
+};
+
+}  // namespace actuator
@@ -13,7 +13,7 @@ namespace actuator {
  * 使用SPI外设实现执行器输出，将-1到1的输入映射到SPI数据输出
  * 适合控制需要SPI通信的执行器设备
  */
-class SPIActuator : public Actuator {
+class SPIActuator final : public Actuator {
    public:
     /**
      * @brief 构造函数
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include "driver/spi_master.h"
+#include "esp_timer.h"
+
+// 位流时钟，即时隙分辨率：1MHz对应1us
+#ifndef SPI_SERVO_BANK_CLOCK_HZ
+#define SPI_SERVO_BANK_CLOCK_HZ (1 * 1000 * 1000)
+#endif
+
+namespace actuator {
+
+/**
+ * @brief SPI-DMA位流舵机组
+ *
+ * 把SPI的数据线当作并行输出：每个SPI时钟为一个时隙，每个时隙n位（单线1位、
+ * DIO 2位、QIO 4位），第k位对应数据线Dk（D0=MOSI, D1=MISO, D2=WP, D3=HD），
+ * 即一条数据线驱动一个舵机。各舵机的脉冲在每帧开头同时拉高，按各自脉宽拉低，
+ * 整帧只渲染0-2500us的有效窗口（末尾补若干低电平时隙），每个PWM周期由
+ * esp_timer排队一次DMA事务发送，周期剩余时间数据线保持低电平。
+ *
+ * 时序与开销（默认1MHz位流时钟）：
+ * - 脉宽分辨率为1个时隙（1us，50Hz下LEDC 14位为1.22us），由SPI时钟硬件定时
+ * - 帧周期由esp_timer定时，抖动只影响帧间隔，不影响脉宽
+ * - 缓冲区：每帧约2500*n/8字节（QIO约1.25KB），双缓冲
+ * - 每个运动节拍：一次setTargets渲染后缓冲区（按脉宽排序后分段memset），
+ *   不直接操作外设
+ * - 每帧：一次spi_device_queue_trans，发送过程由DMA完成
+ *
+ * C3只有SPI2一个通用SPI主机；LED灯带使用SPI后端时总线已被占用，此时构造
+ * 抛出BusBusy，且不触碰任何引脚。
+ * 析构时spi_bus_free会复位本组的数据线引脚，因此必须先析构本组、再由其他
+ * 外设（如重建后的执行器）认领这些引脚，ExecutorFactory::rebuild保证该顺序。
+ * 调用方负责串行化setTargets。
+ */
+class SPIServoBank {
+   public:
+    static constexpr size_t MAX_LANES = 4;
+
+    /**
+     * @brief SPI主机已被其他驱动（LED灯带或另一个舵机组）占用
+     */
+    class BusBusy : public std::runtime_error {
+       public:
+        BusBusy() : std::runtime_error("SPI bus already in use") {}
+    };
+
+    /**
+     * @brief 构造函数，初始化SPI总线并开始按帧发送（初始输出中位）
+     * @param host_id SPI主机ID
+     * @param gpio_nums 各通道GPIO引脚号，依次绑定D0-D3
+     * @param offsets 各通道偏移量
+     * @param count 通道数量，只能是1、2或4（对应单线/DIO/QIO）
+     * @param freq_hz PWM频率（50-333Hz）
+     * @param clock_hz 位流时钟（时隙分辨率）
+     * @throws BusBusy SPI主机已被占用
+     * @throws std::runtime_error 参数非法、内存不足或SPI初始化失败
+     */
+    SPIServoBank(spi_host_device_t host_id, const int* gpio_nums,
+                 const float* offsets, size_t count, uint32_t freq_hz,
+                 uint32_t clock_hz = SPI_SERVO_BANK_CLOCK_HZ);
+
+    /**
+     * @brief 析构函数，停止发送并释放SPI总线（同时复位数据线引脚）
+     */
+    ~SPIServoBank();
+
+    SPIServoBank(const SPIServoBank&) = delete;
+    SPIServoBank& operator=(const SPIServoBank&) = delete;
+
+    /**
+     * @brief 批量设置目标值，渲染到后缓冲区，下一帧生效
+     * @param targets 目标值数组，范围[-1, 1]，targets[i]对应lane i
+     * @param count 数组长度，超出通道数的部分忽略
+     */
+    void setTargets(const float* targets, size_t count);
+
+    /**
+     * @brief 获取通道最近一次的目标值（含offset、已限幅）
+     */
+    float getTarget(size_t lane) const {
+        return lane < m_count ? m_lanes[lane].target : 0.0f;
+    }
+
+    size_t laneCount() const { return m_count; }
+
+    /**
+     * @brief 最近一次setTargets的耗时（微秒）
+     */
+    uint32_t lastLatencyUs() const { return m_last_latency_us; }
+
+    /**
+     * @brief 因上一帧未发送完成而跳过的帧数
+     */
+    uint32_t skippedFrames() const { return m_skipped_frames; }
+
+   private:
+    struct Lane {
+        float offset;
+        float target;
+        uint32_t pulse_slots;  // 脉宽（时隙数）
+    };
+
+    using DmaBuffer = std::unique_ptr<uint8_t[], void (*)(uint8_t*)>;
+
+    spi_host_device_t m_host_id;
+    spi_device_handle_t m_device = nullptr;
+    bool m_bus_owner = false;
+    esp_timer_handle_t m_frame_timer = nullptr;
+
+    std::array<Lane, MAX_LANES> m_lanes;
+    size_t m_count;
+    uint32_t m_bits_per_slot;  // 每个时隙的位数（1/2/4）
+    uint32_t m_clock_hz;
+    uint32_t m_slots;          // 每帧时隙数
+    size_t m_frame_bytes;      // 每帧字节数
+
+    // 双缓冲：m_buffers[m_front]由DMA发送，m_buffers[1 - m_front]由节拍渲染
+    DmaBuffer m_buffers[2];
+    int m_front = 0;
+    bool m_back_ready = false;
+    std::mutex m_buffer_mutex;
+
+    spi_transaction_t m_trans;
+    bool m_trans_pending = false;
+    uint32_t m_last_latency_us = 0;
+    uint32_t m_skipped_frames = 0;
+
+    /**
+     * @brief 将脉宽渲染为位流
+     */
+    void render(uint8_t* buffer) const;
+
+    /**
+     * @brief 把[begin, end)时隙填充为同一个通道掩码
+     */
+    void fillSlots(uint8_t* buffer, uint32_t begin, uint32_t end,
+                   uint8_t mask) const;
+
+    /**
+     * @brief 帧定时器回调：交换缓冲区并排队一次DMA事务
+     */
+    static void frameCallback(void* arg);
+
+    void release();
+};
+
+}  // namespace actuator
@@ -24,6 +24,7 @@ typedef struct {
     float cpu_usage_percent;    // CPU使用率百分比
     size_t free_heap_size;      // 可用堆内存大小
     size_t total_heap_size;     // 总堆内存大小
+    float motion_idle_percent;  // 执行器静止（跳过计算）时间占比
 } analysis_cpu_usage_event_data_t;
 
 // 全局定时器声明
@@ -40,6 +41,13 @@ void analysis_timer_callback(TimerHandle_t xTimer);
 float get_cpu_usage(void);
 void reset_cpu_stats(void);
 
+/**
+ * @brief 记录一个执行器节拍
+ * @param idle true表示该节拍静止被跳过
+ * @param period_us 该节拍对应的时长（微秒）
+ */
+void analysis_motion_tick(bool idle, uint32_t period_us);
+
 // 事件相关函数声明
 esp_err_t analysis_event_init(void);
 void analysis_cpu_usage_event_handler(void* handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
@@ -237,7 +237,7 @@ READ_WRITE_CHR(
           // 使用SettingWrapper解码protobuf数据
           SettingWrapper setting(buffer.get(), recv_size);
           setting.saveToFile();
-          g_executor = ExecutorFactory::createExecutor(setting);
+          ExecutorFactory::rebuild(g_executor, setting);
 
           // 检查 WiFi 配置是否变化
           if (old_setting.isWifiConfigChanged(setting)) {
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include "tcode.hpp"
 #include "setting.hpp"
+#include "joint_limiter.hpp"
+#include "telemetry.hpp"
 
+#include "esp_cpu.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "esp_event.h"
@@ -19,6 +23,37 @@ ESP_EVENT_DECLARE_BASE(EXECUTOR_EVENT);
 #define EXECUTOR_STATS_WINDOW_SECONDS 1
 #endif
 
+// 执行器节拍以编译期组合的方式直接调用compute/execute（见PipelineExecutor），
+// 置0时退回经虚函数分派的通用节拍，便于对比
+#ifndef EXECUTOR_DEVIRTUALIZE
+#define EXECUTOR_DEVIRTUALIZE 1
+#endif
+
+// 统计每个节拍的CPU周期数，随统计窗口打印
+#ifndef EXECUTOR_TICK_PROFILE
+#define EXECUTOR_TICK_PROFILE 0
+#endif
+
+// 静止节拍跳过：轴向量无变化且无插值时跳过compute/execute
+#ifndef EXECUTOR_IDLE_SKIP
+#define EXECUTOR_IDLE_SKIP 1
+#endif
+
+// 静止时节拍降频倍数（1表示不降频）
+#ifndef EXECUTOR_IDLE_TICK_DIVIDER
+#define EXECUTOR_IDLE_TICK_DIVIDER 4
+#endif
+
+// 判定轴值变化的阈值（轴值范围0.0~1.0）
+#ifndef EXECUTOR_IDLE_EPSILON
+#define EXECUTOR_IDLE_EPSILON 0.00001f
+#endif
+
+// 停止时等待执行任务完成当前节拍的最长时间（毫秒），超时则直接删除任务
+#ifndef EXECUTOR_STOP_TIMEOUT_MS
+#define EXECUTOR_STOP_TIMEOUT_MS 1000
+#endif
+
 // 事件ID定义
 typedef enum {
     EXECUTOR_EVENT_COMPUTE = 0,
@@ -53,6 +88,11 @@ typedef struct {
     float execute_max_ms;      // 最大耗时（毫秒）
     float execute_freq;        // 执行频率（Hz）
 
+    // 关节限幅统计（触发限制的节拍占比）
+    float limit_velocity_percent;  // 速度限制（%）
+    float limit_accel_percent;     // 加速度限制（%）
+    float limit_jerk_percent;      // 加加速度限制（%）
+
     // 窗口信息
     float window_seconds;      // 统计窗口时长（秒）
 } motion_stats_event_data_t;
@@ -70,6 +110,13 @@ class Executor {
     explicit Executor(const SettingWrapper& setting);
     virtual ~Executor();
 
+    /**
+     * @brief 停止节拍与解析任务（可重复调用）
+     * 等待执行任务完成当前节拍后返回，之后不再调用compute/execute。
+     * 派生类析构时应先调用，避免节拍与派生类的清理（及成员析构）并发
+     */
+    void stop();
+
     /**
      * @brief 计算
      */
@@ -80,7 +127,102 @@ class Executor {
      */
     virtual void execute() = 0;
 
+    /**
+     * @brief 读取各关节的实测位置
+     * 单位与execute()输出的关节目标一致，开环舵机执行器没有反馈。
+     * 反馈按关节而非按actuator::Actuator提供：带反馈的CAN电机由执行器直接
+     * 收发帧，不经过Actuator对象
+     * @param measured 输出数组，长度为关节数
+     * @param count 数组长度
+     * @return true 有反馈并已写入，false 无反馈
+     */
+    virtual bool getJointFeedback(float* measured, size_t count) {
+        return false;
+    }
+
    protected:
+    /**
+     * @brief 执行一个节拍（compute + execute及其计时事件）
+     * 默认实现经虚函数调用compute/execute，PipelineExecutor将其重写为直接调用
+     */
+    virtual void tick();
+
+    /**
+     * @brief 修改节拍周期（如受总线带宽限制），派生类应在configureJoints之前调用
+     * @param period_us 节拍周期（微秒）
+     */
+    void setTickPeriod(uint32_t period_us);
+
+    /**
+     * @brief 配置关节限幅与遥测记录，派生类在构造时调用一次
+     * @param joints 关节数量（不超过JointLimiter::MAX_JOINTS）
+     * @param limits 限幅参数，单位与关节目标一致
+     */
+    void configureJoints(size_t joints, const JointLimiter::Limits& limits);
+
+    /**
+     * @brief 记录本节拍的关节指令与实测位置
+     * 由派生类在execute()中、写入执行器之后调用，EXECUTOR_TELEMETRY为0时不做处理
+     * @param commanded 本节拍输出的关节目标
+     */
+    void recordJoints(const float* commanded);
+
+    /**
+     * @brief 是否允许静止时跳过compute/execute
+     * 需要每个节拍持续输出的执行器（如单次发送脉冲的RMT舵机）应返回false
+     * @return true 允许跳过
+     */
+    virtual bool idleSkipAllowed() const { return true; }
+
+    /**
+     * @brief 对关节目标做速度/加速度/加加速度限制
+     * 由派生类在execute()中、写入执行器之前调用，EXECUTOR_JOINT_LIMIT为0时不做处理
+     * @param targets 关节目标数组，原位修改
+     */
+    void limitJoints(float* targets) {
+#if EXECUTOR_JOINT_LIMIT
+        m_limiter.apply(targets);
+#endif
+    }
+
+    /**
+     * @brief 将关节限幅器的起点重置为给定位置（速度清零）
+     * 输出中断后调用，之后的目标按速度/加速度限制从该位置过渡
+     * @param positions 关节位置数组，NaN项保持原位置
+     */
+    void resetJoints(const float* positions) {
+#if EXECUTOR_JOINT_LIMIT
+        m_limiter.reset(positions);
+#endif
+    }
+
+    /**
+     * @brief 判断当前节拍是否静止
+     * 对插值后的轴向量做变化检测，无变化、无插值进行且关节限幅已收敛时视为静止。
+     * 构造后的第一个节拍总是执行（无上一节拍的轴向量），重建后的执行器会重新
+     * 写出一次输出
+     * @return true 静止，可跳过本节拍
+     */
+    bool isStationary();
+
+    /**
+     * @brief 本节拍的插值轴向量（L0, L1, L2, R0, R1, R2）
+     * isStationary()已插值时直接返回其结果，同一节拍只插值一次；由compute()调用
+     * @return 轴向量，至下一节拍前有效
+     */
+    float* tickAxis() {
+        if (m_tick_axis == nullptr) {
+            m_tick_axis = tcode.interpolate();
+        }
+        return m_tick_axis;
+    }
+
+    /**
+     * @brief 切换静止/运动状态，静止时按EXECUTOR_IDLE_TICK_DIVIDER降低节拍频率
+     * @param idle true进入静止，false恢复运动
+     */
+    void setIdle(bool idle);
+
     /**
      * @brief 执行器任务函数
      * @param arg 任务参数
@@ -127,10 +269,26 @@ class Executor {
     TaskHandle_t taskHandle;         // 执行任务句柄
     TaskHandle_t parserTaskHandle;  // 解析任务句柄
     SemaphoreHandle_t semaphore;     // 信号量，用于控制任务执行节拍
+    SemaphoreHandle_t exitSemaphore; // 执行任务退出时释放，stop()等待
     esp_timer_handle_t timer;        // 定时器句柄
     bool taskRunning;                // 执行任务运行标志
     bool parserTaskRunning;          // 解析任务运行标志
     bool taskExecuting;              // 任务正在执行标志
     const char* TAG;                 // 日志标签
     std::mutex m_compute_mutex;      // 计算互斥锁
+
+    uint32_t m_tick_period_us;       // 正常节拍周期（微秒）
+    float m_last_axis[6];            // 上一节拍的插值轴向量
+    float* m_tick_axis;              // 本节拍已插值的轴向量，节拍开始时清空
+    bool m_has_last_axis;            // m_last_axis是否有效
+    bool m_idle;                     // 当前是否处于静止降频状态
+    std::mutex m_idle_mutex;         // 静止状态切换互斥锁
+    JointLimiter m_limiter;          // 关节限幅器，由派生类按关节数和单位配置
+    size_t m_joint_count;            // 关节数量
+
+#if EXECUTOR_TICK_PROFILE
+    std::atomic<uint32_t> m_tick_cycles_sum{0};    // 窗口内节拍周期数累计（1s窗口内不溢出）
+    std::atomic<uint32_t> m_tick_cycles_count{0};  // 窗口内节拍数
+    std::atomic<uint32_t> m_tick_cycles_max{0};    // 窗口内最大节拍周期数
+#endif
 };
@@ -4,6 +4,15 @@
 #include <vector>
 #include "setting.hpp"
 
+// 固定执行器模式：置为某个mode（0/3/6/8/9）时固件只链接该执行器，
+// 其余执行器被链接器丢弃；-1表示按setting.servo.MODE运行时选择
+#ifndef EXECUTOR_FIXED_MODE
+#define EXECUTOR_FIXED_MODE -1
+#endif
+
+#define EXECUTOR_MODE_ENABLED(mode) \
+    (EXECUTOR_FIXED_MODE < 0 || EXECUTOR_FIXED_MODE == (mode))
+
 // 前向声明
 class Executor;
 
@@ -21,12 +30,25 @@ public:
      *          - 6: TrRMax
      *          - 8: SR6CAN
      *          - 9: O6 (6-Axis Parallel Robot)
+     *          EXECUTOR_FIXED_MODE非负时只支持该mode
      * @param setting 配置对象
      * @return Executor 智能指针，如果 mode 无效返回 nullptr
      * @throws std::runtime_error 如果创建 executor 失败
      */
     static std::unique_ptr<Executor> createExecutor(const SettingWrapper &setting);
 
+    /**
+     * @brief 按新配置重建执行器
+     * @details 先停止并析构旧执行器，再创建新执行器：两者使用同一组硬件资源
+     *          （LEDC通道、SPI总线、CAN发送队列与恢复回调），旧执行器的清理
+     *          不能晚于新执行器的初始化。创建失败时executor为空
+     * @param executor 当前执行器，原位替换
+     * @param setting 配置对象
+     * @throws std::runtime_error 如果创建 executor 失败
+     */
+    static void rebuild(std::unique_ptr<Executor> &executor,
+                        const SettingWrapper &setting);
+
     /**
      * @brief 将 mode 值转换为字符串描述
      * @param mode servo mode 值
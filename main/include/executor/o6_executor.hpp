@@ -1,8 +1,9 @@
 #pragma once
 
-#include "executor/executor.hpp"
+#include "executor/pipeline_executor.hpp"
 #include "geometry/o6_geometry.hpp"
-#include "actuator/ledc_actuator.hpp"
+#include "geometry/o6_solver.hpp"
+#include "actuator/actuator_bank.hpp"
 #include "proto/setting.pb.h"
 #include "utils.hpp"
 #include <memory>
@@ -17,7 +18,7 @@
  * Inherits from Executor, used to control 6 servos for 6-axis parallel robot motion control
  * Uses LEDC peripheral for PWM output, implements 6-axis control via inverse kinematics
  */
-class O6Executor : public Executor {
+class O6Executor final : public PipelineExecutor<O6Executor> {
    public:
     /**
      * @brief Constructor
@@ -31,6 +32,8 @@ class O6Executor : public Executor {
     ~O6Executor() override;
 
    protected:
+    friend class PipelineExecutor<O6Executor>;
+
     /**
      * @brief Calculate servo target positions
      * Parse L0-L2, R0-R2 values from tcode and calculate target angles for 6 servos using O6 kinematics
@@ -50,24 +53,17 @@ class O6Executor : public Executor {
      */
     bool initLEDC();
 
-    // Servo actuators (6 channels for A-F)
-    std::unique_ptr<actuator::LEDCActuator> m_servo_a;  // Servo A (channel 0)
-    std::unique_ptr<actuator::LEDCActuator> m_servo_b;  // Servo B (channel 1)
-    std::unique_ptr<actuator::LEDCActuator> m_servo_c;  // Servo C (channel 2)
-    std::unique_ptr<actuator::LEDCActuator> m_servo_d;  // Servo D (channel 3)
-    std::unique_ptr<actuator::LEDCActuator> m_servo_e;  // Servo E (channel 4)
-    std::unique_ptr<actuator::LEDCActuator> m_servo_f;  // Servo F (channel 5)
+    // Servo actuators (6 channels for A-F, LEDC channels 0-5)
+    std::unique_ptr<actuator::ActuatorBank> m_bank;
+
+    // Precomputed base geometry for the float kinematics solver
+    const geometry::O6BaseGeometry m_base;
 
     // Computed theta values (6 servo angles in radians)
-    std::array<double, 6> m_theta_values;
+    std::array<float, 6> m_theta_values;
 
-    // Computed target values for servos (-1.0 to 1.0 range)
-    float m_servo_a_target;
-    float m_servo_b_target;
-    float m_servo_c_target;
-    float m_servo_d_target;
-    float m_servo_e_target;
-    float m_servo_f_target;
+    // Computed target values for servos A-F (-1.0 to 1.0 range)
+    std::array<float, 6> m_servo_targets;
 
     // Initialization flag
     bool m_init_done = false;
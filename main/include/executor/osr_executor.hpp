@@ -1,8 +1,8 @@
 #pragma once
 
-#include "executor.hpp"
+#include "pipeline_executor.hpp"
 #include "proto/setting.pb.h"
-#include "actuator/ledc_actuator.hpp"
+#include "actuator/actuator_bank.hpp"
 #include <memory>
 
 /**
@@ -11,7 +11,7 @@
  * 继承自Executor，用于控制多个舵机实现多轴运动
  * 使用LEDC外设控制PWM输出，实现L0, R0, R1, R2四个轴的控制
  */
-class OSRExecutor : public Executor {
+class OSRExecutor final : public PipelineExecutor<OSRExecutor> {
    public:
     /**
      * @brief 构造函数
@@ -25,6 +25,8 @@ class OSRExecutor : public Executor {
     ~OSRExecutor() override;
 
    protected:
+    friend class PipelineExecutor<OSRExecutor>;
+
     /**
      * @brief 计算舵机目标位置
      * 从tcode中解析L0, R0, R1, R2的值，并计算各个舵机的目标占空比
@@ -38,17 +40,8 @@ class OSRExecutor : public Executor {
     void execute() override;
 
    private:
-    /**
-     * @brief 初始化LEDC定时器
-     * @return true 成功，false 失败
-     */
-    bool initLEDC();
-
-    // 舵机执行器
-    std::unique_ptr<actuator::LEDCActuator> m_servo_a;  // 舵机A
-    std::unique_ptr<actuator::LEDCActuator> m_servo_b;  // 舵机B
-    std::unique_ptr<actuator::LEDCActuator> m_servo_c;  // 舵机C
-    std::unique_ptr<actuator::LEDCActuator> m_servo_d;  // 舵机D
+    // 舵机A-D（LEDC通道0-3，按各自频率分配定时器，批量写入）
+    std::unique_ptr<actuator::ActuatorBank> m_bank;
 
     // 计算结果占空比
     float m_servo_a_duty;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "executor.hpp"
+
+/**
+ * @brief 编译期组合的执行器节拍
+ *
+ * 派生类以自身为模板参数继承（CRTP）并声明为final，节拍经一次虚函数进入
+ * tick()后，compute()/execute()以Derived::限定名直接调用，插值、运动学、
+ * 限幅和执行器组写入在同一个翻译单元内可被内联，不再逐步虚函数分派。
+ * 派生类需将本模板声明为友元以访问受保护的compute()/execute()。
+ *
+ * EXECUTOR_DEVIRTUALIZE为0时沿用Executor::tick()，用于对比节拍周期数。
+ *
+ * @tparam Derived 具体执行器类型
+ */
+template <class Derived>
+class PipelineExecutor : public Executor {
+   public:
+    explicit PipelineExecutor(const SettingWrapper& setting)
+        : Executor(setting) {}
+
+   protected:
+#if EXECUTOR_DEVIRTUALIZE
+    void tick() final {
+        Derived& self = static_cast<Derived&>(*this);
+
+        sendComputeEvent(true);
+        self.Derived::compute();
+        sendComputeEvent(false);
+
+        sendExecuteEvent(true);
+        self.Derived::execute();
+        sendExecuteEvent(false);
+    }
+#endif
+};
@@ -1,20 +1,40 @@
 #pragma once
 
 #include "actuator/actuator.hpp"
-#include "actuator/ledc_actuator.hpp"
-#include "actuator/rmt_actuator.hpp"
-#include "executor.hpp"
+#include "actuator/actuator_bank.hpp"
+#include "actuator/rmt_servo_bank.hpp"
+#include "actuator/spi_servo_bank.hpp"
+#include "pipeline_executor.hpp"
+#include "geometry/lut2d.hpp"
 #include <cmath>
 #include <memory>
 
+// 查表模式：设置加载时把舵臂运动学制成二维查找表，节拍内双线性查表
+#ifndef SR6_KINEMATICS_LUT
+#define SR6_KINEMATICS_LUT 0
+#endif
+
+// 查找表每个维度的采样点数（64时两张表共16KB）
+#ifndef SR6_LUT_RESOLUTION
+#define SR6_LUT_RESOLUTION 64
+#endif
+
+// 置1时主舵机A-D改由SPI-DMA位流输出（QIO四条数据线，共用A的PWM频率），
+// E/F仍使用LEDC。SPI2同时是LED灯带的总线，必须关闭CONFIG_ENABLE_LED，
+// 否则编译报错；运行时总线被占用则构造失败，SPI其他初始化失败时回退到LEDC
+#ifndef SR6_SPI_SERVO_BANK
+#define SR6_SPI_SERVO_BANK 0
+#endif
+
 /**
  * @brief SR6执行器类
  *
  * 继承自Executor，用于控制六个舵机实现SR6运动
- * 使用LEDC外设控制PWM输出，实现A-F六个舵机的控制
+ * 使用LEDC外设控制PWM输出，A-F六个舵机通过ActuatorBank批量写入
+ * （SR6_SPI_SERVO_BANK开启时A-D由SPIServoBank输出）
  * 使用RMT外设控制G舵机
  */
-class SR6Executor : public Executor {
+class SR6Executor final : public PipelineExecutor<SR6Executor> {
 public:
   /**
    * @brief 构造函数
@@ -28,6 +48,8 @@ public:
   ~SR6Executor() override;
 
 protected:
+  friend class PipelineExecutor<SR6Executor>;
+
   /**
    * @brief 计算舵机目标位置
    * 从tcode中解析L0, L1, L2, R0, R1, R2的值，并计算各个舵机的目标占空比
@@ -41,12 +63,6 @@ protected:
   void execute() override;
 
 private:
-  /**
-   * @brief 初始化LEDC定时器
-   * @return true 成功，false 失败
-   */
-  bool initLEDC();
-
   /**
    * @brief 计算主舵机角度
    * @param x 目标x坐标（1/100 mm）
@@ -65,14 +81,33 @@ private:
    */
   float setPitchServo(float x, float y, float z, float pitch);
 
+  /**
+   * @brief 主舵机角度解析计算（查表模式的采样函数和回退路径）
+   */
+  static float mainServoAnalytic(float x, float y);
+
+  /**
+   * @brief 俯仰舵机解析计算
+   * @param lut 非空时用于查询gamma角
+   */
+  static float pitchServoAnalytic(float x, float y, float z, float pitch,
+                                  const geometry::Lut2D *lut);
+
+  /**
+   * @brief 按当前设置的轴范围生成查找表，范围未变化时不重新生成
+   */
+  void buildKinematicsLUT();
+
+  // 运动学查找表
+  geometry::Lut2D m_main_lut;        // 主舵机角度(x, y)，单位1/100 mm
+  geometry::Lut2D m_pitch_gamma_lut; // 俯仰舵机gamma角(x, y)，单位mm
+
   // 舵机执行器
-  std::unique_ptr<actuator::Actuator> m_servo_a; // 舵机A(LEDC)
-  std::unique_ptr<actuator::Actuator> m_servo_b; // 舵机B(LEDC)
-  std::unique_ptr<actuator::Actuator> m_servo_c; // 舵机C(LEDC)
-  std::unique_ptr<actuator::Actuator> m_servo_d; // 舵机D(LEDC)
-  std::unique_ptr<actuator::Actuator> m_servo_e; // 舵机E(LEDC)
-  std::unique_ptr<actuator::Actuator> m_servo_f; // 舵机F(LEDC)
-  std::unique_ptr<actuator::Actuator> m_servo_g; // 舵机G(RMT)
+  std::unique_ptr<actuator::ActuatorBank> m_bank; // 舵机A-F(LEDC)
+  std::unique_ptr<actuator::RMTServoBank> m_servo_g; // 舵机G(RMT，硬件循环刷新)
+#if SR6_SPI_SERVO_BANK
+  std::unique_ptr<actuator::SPIServoBank> m_spi_bank; // 舵机A-D(SPI-DMA)
+#endif
 
   // 计算结果占空比（-1到1范围）
   float m_servo_a_duty;
@@ -1,19 +1,52 @@
 #pragma once
 
-#include "executor.hpp"
+#include "pipeline_executor.hpp"
 #include "pid.hpp"
+#include "tracking_feedforward.hpp"
 #include <mutex>
 
 // SR6 CAN伺服电机数量
 #define SR6CANServoNum 6
 #define SR6CANArrLen 6
+// 电机节点ID 1 ~ SR6CANServoNum
+#define SR6CANNodeMask (((1ull << SR6CANServoNum) - 1) << 1)
+
+// 跟踪前馈（速度前馈+滞后补偿，见TrackingFeedForward）：
+// 0关闭，1开启，2每个统计窗口切换一次开关，打印开/关两种状态的跟踪误差RMS
+#ifndef SR6CAN_FEEDFORWARD
+#define SR6CAN_FEEDFORWARD 0
+#endif
+
+// 前馈开启时，按对齐滞后后的跟踪误差积分输出力矩前馈
+#ifndef SR6CAN_FF_INTEGRAL
+#define SR6CAN_FF_INTEGRAL 0
+#endif
+
+// 力矩前馈积分增益（N·m/(rad·s)），误差按实际反馈间隔积分
+#ifndef SR6CAN_FF_KI
+#define SR6CAN_FF_KI 5.0f
+#endif
+
+// 积分步长上限（秒），反馈中断后的首个样本不按整段间隔积分
+#ifndef SR6CAN_FF_MAX_DT_S
+#define SR6CAN_FF_MAX_DT_S 0.2f
+#endif
+
+// 力矩前馈限幅（N·m），积分同时按此抗饱和
+#ifndef SR6CAN_FF_TORQUE_MAX
+#define SR6CAN_FF_TORQUE_MAX 1.0f
+#endif
+
+// 力矩前馈只做静差校正，限幅需远小于MIT力矩量程（±6.24 N·m）
+static_assert(SR6CAN_FF_TORQUE_MAX > 0.0f && SR6CAN_FF_TORQUE_MAX <= 2.0f,
+              "SR6CAN_FF_TORQUE_MAX must stay well inside the MIT torque range");
 
 /**
  * @brief SR6CAN执行器类
  *
  * 继承自Executor，用于通过CAN总线控制6个MIT协议电机实现SR6运动
  */
-class SR6CANExecutor : public Executor {
+class SR6CANExecutor final : public PipelineExecutor<SR6CANExecutor> {
 public:
     /**
      * @brief 构造函数
@@ -33,7 +66,17 @@ public:
      */
     int getExecuteFrequency() const;
 
+    /**
+     * @brief 读取电机位置反馈（CAN cmd 9，弧度）
+     * @param measured 输出数组
+     * @param count 数组长度
+     * @return true
+     */
+    bool getJointFeedback(float* measured, size_t count) override;
+
 protected:
+    friend class PipelineExecutor<SR6CANExecutor>;
+
     /**
      * @brief 计算电机目标位置
      */
@@ -44,12 +87,48 @@ protected:
      */
     void execute() override;
 
+    /**
+     * @brief CAN恢复后需至少执行一个节拍以重置限幅器起点，此时不允许静止跳过
+     */
+    bool idleSkipAllowed() const override;
+
 private:
     /**
      * @brief 初始化电机
      */
     void initMotors();
 
+    /**
+     * @brief CAN总线恢复回调：清除异常并重新进入闭环
+     * @param arg 未使用
+     * @return ESP_OK 全部电机已重新使能
+     */
+    static esp_err_t resumeMotors(void* arg);
+
+    /**
+     * @brief 以电机实测位置重置关节限幅器，恢复后从当前位置过渡到目标
+     */
+    void resyncJoints();
+
+    /**
+     * @brief 读取电机位置反馈及其接收时刻
+     * @param measured 输出数组（弧度），未收到时为NaN
+     * @param sample_us 输出数组（微秒），未收到时为0
+     */
+    void readFeedback(float* measured, int64_t* sample_us);
+
+#if SR6CAN_FEEDFORWARD
+    /**
+     * @brief 跟踪前馈：由轨迹目标和实测反馈计算下发位置、速度与力矩前馈
+     * @param targets 轨迹目标（含offset，弧度）
+     * @param positions 输出：下发位置
+     * @param velocities 输出：速度前馈
+     * @param torques 输出：力矩前馈
+     */
+    void feedForward(const float* targets, float* positions, float* velocities,
+                     float* torques);
+#endif
+
     /**
      * @brief 计算主舵机角度
      * @param x 目标x坐标（1/100 mm）
@@ -68,18 +147,9 @@ private:
      */
     float SetPitchServo(float x, float y, float z, float pitch);
 
-    /**
-     * @brief CAN接收任务
-     * @param param 任务参数
-     */
-    static void canReceiveTask(void* param);
-
     // 电机位置目标值（弧度）
     float motor_position[SR6CANArrLen];
     
-    // 电机位置反馈值（弧度）
-    float motor_position_feedback[SR6CANArrLen];
-    
     // PID控制器数组
     pid_controller_t motor_pid[SR6CANArrLen];
     
@@ -89,15 +159,24 @@ private:
     float motor_kd[SR6CANArrLen];
     float motor_offset[SR6CANArrLen];  // 角度，不是弧度
     
-    // CAN接收任务句柄
-    TaskHandle_t can_receive_task_handle_;
-    
     // 互斥锁
     std::mutex compute_mutex_;
-    std::mutex feedback_mutex_;
     
     // 初始化完成标志
     bool init_done;
+
+    // 已处理的CAN恢复代数
+    uint32_t can_generation_;
+
+#if SR6CAN_FEEDFORWARD
+    // 跟踪前馈
+    TrackingFeedForward tracking_;
+#if SR6CAN_FF_INTEGRAL
+    // 力矩前馈积分（rad·s）及上一个参与积分的反馈接收时刻（0为无）
+    float ff_integral_[SR6CANArrLen];
+    int64_t ff_sample_us_[SR6CANArrLen];
+#endif
+#endif
     
     // 静态成员变量
     static const char* TAG;
@@ -1,8 +1,8 @@
 #pragma once
 
-#include "executor.hpp"
+#include "pipeline_executor.hpp"
 #include "proto/setting.pb.h"
-#include "actuator/ledc_actuator.hpp"
+#include "actuator/actuator_bank.hpp"
 #include <memory>
 #include <cmath>
 
@@ -12,7 +12,7 @@
  * 继承自Executor，用于控制三个舵机实现TrRMax运动
  * 使用LEDC外设控制PWM输出，实现L0, R1, R2三个轴的控制
  */
-class TrRMaxExecutor : public Executor {
+class TrRMaxExecutor final : public PipelineExecutor<TrRMaxExecutor> {
    public:
     /**
      * @brief 构造函数
@@ -26,6 +26,8 @@ class TrRMaxExecutor : public Executor {
     ~TrRMaxExecutor() override;
 
    protected:
+    friend class PipelineExecutor<TrRMaxExecutor>;
+
     /**
      * @brief 计算舵机目标位置
      * 从tcode中解析L0, R1, R2的值，并计算各个舵机的目标占空比
@@ -39,16 +41,8 @@ class TrRMaxExecutor : public Executor {
     void execute() override;
 
    private:
-    /**
-     * @brief 初始化LEDC定时器
-     * @return true 成功，false 失败
-     */
-    bool initLEDC();
-
-    // 舵机执行器
-    std::unique_ptr<actuator::LEDCActuator> m_servo_a;  // 舵机A
-    std::unique_ptr<actuator::LEDCActuator> m_servo_b;  // 舵机B
-    std::unique_ptr<actuator::LEDCActuator> m_servo_c;  // 舵机C
+    // 舵机A-C（LEDC通道0-2，按各自频率分配定时器，批量写入）
+    std::unique_ptr<actuator::ActuatorBank> m_bank;
 
     // 计算结果占空比（-1到1范围）
     float m_servo_a_duty;
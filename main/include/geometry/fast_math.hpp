@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Fast single-precision math kernels for the servo kinematics.
+ *
+ * The ESP32-C3 has no FPU, so every libm call is a long soft-float routine.
+ * These kernels use range reduction plus short polynomials, tuned to the
+ * input domains used by the SR6/SR6CAN solvers (angles within a few turns,
+ * acos arguments already clamped to [-1, 1], strictly positive distances).
+ *
+ * Error bounds (max absolute error versus libm, measured in float):
+ *   sin / cos : < 2e-6 for |x| <= 8*pi
+ *   atan2     : < 1e-6 rad
+ *   acos      : < 5.7e-7 rad on [-1, 1]
+ *   asin      : < 5.3e-7 rad on [-1, 1]
+ *   (acos/asin checked against double libm for every float in [-1, 1];
+ *    worst case x = -0.4269 gives 5.65e-7 / 5.21e-7)
+ *   sqrt      : < 4e-7 relative on [FLT_MIN, 1e7] (the rsqrt seed assumes a
+ *               normal float; subnormal inputs are far off but never occur)
+ * host/fast_math_test.cpp enforces these bounds against double libm.
+ * Servo pulse resolution is ~1 us over +-1000 us (~1.6e-3 rad), so these
+ * errors are several orders of magnitude below what the output can resolve.
+ *
+ * Set FAST_MATH_ENABLE to 0 to route every call back to libm.
+ */
+
+#ifndef FAST_MATH_ENABLE
+#define FAST_MATH_ENABLE 1
+#endif
+
+// 置1时启动阶段运行fast_math::selfTest()，打印误差和耗时对比
+#ifndef FAST_MATH_SELF_TEST
+#define FAST_MATH_SELF_TEST 0
+#endif
+
+namespace fast_math {
+
+constexpr float kPi = 3.14159265358979f;
+constexpr float kHalfPi = 1.57079632679490f;
+constexpr float kTwoPi = 6.28318530717959f;
+constexpr float kInvTwoPi = 0.159154943091895f;
+
+/**
+ * @brief 1/sqrt(x) for x > 0, bit-level initial guess plus three Newton steps
+ */
+inline float rsqrt(float x) {
+    uint32_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    i = 0x5f375a86u - (i >> 1);
+    float y;
+    std::memcpy(&y, &i, sizeof(y));
+    float hx = 0.5f * x;
+    y = y * (1.5f - hx * y * y);
+    y = y * (1.5f - hx * y * y);
+    y = y * (1.5f - hx * y * y);
+    return y;
+}
+
+/**
+ * @brief sin(x), x reduced to [-pi/2, pi/2], odd polynomial (A&S 4.3.97)
+ */
+inline float sin(float x) {
+#if FAST_MATH_ENABLE
+    // Reduce to [-pi, pi]
+    float q = x * kInvTwoPi;
+    int32_t k = static_cast<int32_t>(q >= 0.0f ? q + 0.5f : q - 0.5f);
+    x -= static_cast<float>(k) * kTwoPi;
+    // Fold to [-pi/2, pi/2] using sin(pi - x) = sin(x)
+    if (x > kHalfPi) {
+        x = kPi - x;
+    } else if (x < -kHalfPi) {
+        x = -kPi - x;
+    }
+    float x2 = x * x;
+    return x * (1.0f +
+                x2 * (-0.1666666664f +
+                      x2 * (0.0083333315f +
+                            x2 * (-0.0001984090f +
+                                  x2 * (0.0000027526f +
+                                        x2 * -0.0000000239f)))));
+#else
+    return sinf(x);
+#endif
+}
+
+/**
+ * @brief cos(x) = sin(x + pi/2)
+ */
+inline float cos(float x) {
+#if FAST_MATH_ENABLE
+    return fast_math::sin(x + kHalfPi);
+#else
+    return cosf(x);
+#endif
+}
+
+/**
+ * @brief atan(x) for |x| <= 1, polynomial in x^2 (A&S 4.4.49)
+ */
+inline float atanUnit(float x) {
+    float x2 = x * x;
+    return x * (1.0f +
+                x2 * (-0.3333314528f +
+                      x2 * (0.1999355085f +
+                            x2 * (-0.1420889944f +
+                                  x2 * (0.1065626393f +
+                                        x2 * (-0.0752896400f +
+                                              x2 * (0.0429096138f +
+                                                    x2 * (-0.0161657367f +
+                                                          x2 * 0.0028662257f))))))));
+}
+
+/**
+ * @brief atan2(y, x), octant reduction onto atanUnit
+ */
+inline float atan2(float y, float x) {
+#if FAST_MATH_ENABLE
+    float ax = std::fabs(x);
+    float ay = std::fabs(y);
+    if (ax == 0.0f && ay == 0.0f) {
+        return 0.0f;
+    }
+    float r;
+    if (ay <= ax) {
+        r = atanUnit(ay / ax);
+    } else {
+        r = kHalfPi - atanUnit(ax / ay);
+    }
+    if (x < 0.0f) {
+        r = kPi - r;
+    }
+    return y < 0.0f ? -r : r;
+#else
+    return atan2f(y, x);
+#endif
+}
+
+/**
+ * @brief acos(x) = sqrt(1 - |x|) * P(|x|) (A&S 4.4.46), input clamped to [-1, 1]
+ */
+inline float acos(float x) {
+#if FAST_MATH_ENABLE
+    if (x > 1.0f) {
+        x = 1.0f;
+    } else if (x < -1.0f) {
+        x = -1.0f;
+    }
+    float ax = std::fabs(x);
+    float p = 1.5707963050f +
+              ax * (-0.2145988016f +
+                    ax * (0.0889789874f +
+                          ax * (-0.0501743046f +
+                                ax * (0.0308918810f +
+                                      ax * (-0.0170881256f +
+                                            ax * (0.0066700901f +
+                                                  ax * -0.0012624911f))))));
+    float s = 1.0f - ax;
+    // sqrt(1 - |x|) via rsqrt, same as fast_math::sqrt
+    float r = s > 0.0f ? s * rsqrt(s) : 0.0f;
+    r *= p;
+    return x < 0.0f ? kPi - r : r;
+#else
+    return acosf(x);
+#endif
+}
+
+/**
+ * @brief asin(x) = pi/2 - acos(x), input clamped to [-1, 1]
+ */
+inline float asin(float x) {
+#if FAST_MATH_ENABLE
+    return kHalfPi - acos(x);
+#else
+    return asinf(x);
+#endif
+}
+
+/**
+ * @brief sqrt(x) = x * rsqrt(x), returns 0 for x <= 0
+ */
+inline float sqrt(float x) {
+#if FAST_MATH_ENABLE
+    if (x <= 0.0f) {
+        return 0.0f;
+    }
+    return x * rsqrt(x);
+#else
+    return sqrtf(x);
+#endif
+}
+
+/**
+ * @brief 在目标板上对比libm，打印各函数及SR6单节拍运动学的最大误差和平均耗时（CPU周期）
+ */
+void selfTest();
+
+}  // namespace fast_math
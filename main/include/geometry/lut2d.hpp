@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace geometry {
+
+/**
+ * @brief 二维查找表，双线性插值
+ *
+ * 在矩形区域[x0, x1] x [y0, y1]上对函数f(x, y)均匀采样，结果以int16定点
+ * （1/LUT2D_SCALE弧度）存储以节省内存。查表时超出区域返回false，调用方回退到
+ * 解析计算。
+ */
+class Lut2D {
+public:
+  static constexpr float LUT2D_SCALE = 10000.0f; // 定点缩放（1e-4弧度/LSB）
+
+  Lut2D() = default;
+
+  /**
+   * @brief 生成查找表
+   * @param f 被采样的函数
+   * @param x0 x下界
+   * @param x1 x上界
+   * @param y0 y下界
+   * @param y1 y上界
+   * @param nx x方向采样点数（>=2）
+   * @param ny y方向采样点数（>=2）
+   * @return true 成功，false 内存分配失败或参数非法
+   */
+  bool build(const std::function<float(float, float)> &f, float x0, float x1,
+             float y0, float y1, int nx, int ny);
+
+  /**
+   * @brief 双线性查表
+   * @param x 输入x
+   * @param y 输入y
+   * @param out 输出值
+   * @return true 命中，false 超出表范围或表未生成
+   */
+  inline bool lookup(float x, float y, float &out) const {
+    if (!m_data) {
+      return false;
+    }
+    float fx = (x - m_x0) * m_inv_dx;
+    float fy = (y - m_y0) * m_inv_dy;
+    if (!(fx >= 0.0f && fy >= 0.0f && fx <= m_nx - 1 && fy <= m_ny - 1)) {
+      return false;
+    }
+    int ix = static_cast<int>(fx);
+    int iy = static_cast<int>(fy);
+    if (ix > m_nx - 2) {
+      ix = m_nx - 2;
+    }
+    if (iy > m_ny - 2) {
+      iy = m_ny - 2;
+    }
+    float tx = fx - ix;
+    float ty = fy - iy;
+    const int16_t *p = &m_data[iy * m_nx + ix];
+    float v00 = p[0], v10 = p[1], v01 = p[m_nx], v11 = p[m_nx + 1];
+    float v0 = v00 + (v10 - v00) * tx;
+    float v1 = v01 + (v11 - v01) * tx;
+    out = (v0 + (v1 - v0) * ty) * (1.0f / LUT2D_SCALE);
+    return true;
+  }
+
+  /**
+   * @brief 在每个单元中心（双线性误差最大处）与原函数对比
+   * @param f 原函数
+   * @return 最大绝对误差
+   */
+  float maxError(const std::function<float(float, float)> &f) const;
+
+  /**
+   * @brief 表占用内存（字节）
+   */
+  size_t memoryBytes() const {
+    return m_data ? sizeof(int16_t) * m_nx * m_ny : 0;
+  }
+
+  bool valid() const { return m_data != nullptr; }
+
+private:
+  std::unique_ptr<int16_t[]> m_data;
+  float m_x0 = 0.0f, m_x1 = 0.0f, m_y0 = 0.0f, m_y1 = 0.0f;
+  float m_inv_dx = 0.0f, m_inv_dy = 0.0f;
+  int m_nx = 0, m_ny = 0;
+};
+
+} // namespace geometry
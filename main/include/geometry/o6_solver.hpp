@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+
+#include "geometry/o6_geometry.hpp"
+
+namespace geometry {
+
+using Point3F = std::array<float, 3>;
+
+/**
+ * Precomputed base geometry for the O6 float solver.
+ * Everything that does not depend on the pose is computed once here:
+ * the three rotated motor pairs, their axis directions and the platform
+ * connection points in the platform frame.
+ */
+struct O6BaseGeometry {
+  float arm;               // Rocker arm length
+  float link;              // Connecting rod length
+  Point3F a[3];            // Motor 1 position of each five-bar
+  Point3F b[3];            // Motor 2 position of each five-bar
+  Point3F mid[3];          // Midpoint of a/b
+  Point3F k[3];            // Unit direction a -> b
+  float half_ab[3];        // |mid - a| (equals |mid - b|)
+  Point3F platform[3];     // Platform connection points (platform frame)
+};
+
+/**
+ * Build the base geometry; arguments match solve_robot_kinematics defaults
+ * @param r: Platform connection radius
+ * @param arm: Rocker arm length
+ * @param link: Connecting rod length
+ * @param a, b: Motor positions of the first five-bar before rotation
+ * @return Precomputed base geometry
+ */
+O6BaseGeometry make_o6_base_geometry(float r = 4.9f, float arm = 6.5f,
+                                     float link = 21.0f,
+                                     Point3F a = {7.8f, -1.25f, 0.0f},
+                                     Point3F b = {7.8f, 1.25f, 0.0f});
+
+/**
+ * Single-precision O6 inverse kinematics.
+ * Same math as solve_robot_kinematics, but float, stack-only, no
+ * exceptions and no heap allocation. host/o6_solver_test.cpp checks it
+ * against the double solver over a dense pose grid.
+ * @param base: Precomputed base geometry
+ * @param x, y, z: Position coordinates
+ * @param roll_deg, pitch_deg, yaw_deg: Attitude angles (degrees)
+ * @param thetas: Output, 6 rocker angles (radians), untouched on failure
+ * @return true if a solution exists
+ */
+bool solve_robot_kinematics_f(const O6BaseGeometry &base, float x, float y,
+                              float z, float roll_deg, float pitch_deg,
+                              float yaw_deg, std::array<float, 6> &thetas);
+
+} // namespace geometry
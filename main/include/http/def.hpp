@@ -7,6 +7,7 @@
 #include "http_router.hpp"
 #include "setting.hpp"
 #include "static_file_handler.hpp"
+#include "telemetry.hpp"
 #include "utils.hpp"
 #include "executor/executor_factory.hpp"
 #include "wifi.hpp"
@@ -381,7 +382,7 @@ POST("/api/setting", [](httpd_req_t *req) -> esp_err_t {
     SettingWrapper setting(reinterpret_cast<const uint8_t *>(buffer.get()),
                            total_received);
     setting.saveToFile();
-    g_executor = ExecutorFactory::createExecutor(setting);
+    ExecutorFactory::rebuild(g_executor, setting);
 
     // 检查 WiFi 配置是否变化
     if (old_setting.isWifiConfigChanged(setting)) {
@@ -512,6 +513,35 @@ GET("/api/modes", [](httpd_req_t *req) -> esp_err_t {
   }
 })
 
+GET("/api/telemetry", [](httpd_req_t *req) -> esp_err_t {
+  static const char *TAG = "api_telemetry";
+
+  // 二进制格式见telemetry_header_t；直接从环形缓冲分块发送，不拷贝整份数据
+  httpd_resp_set_status(req, "200 OK");
+  httpd_resp_set_type(req, "application/octet-stream");
+  httpd_resp_set_hdr(req, "Content-Disposition",
+                     "attachment; filename=\"telemetry.bin\"");
+  esp_err_t ret = Telemetry::getInstance().stream(
+      [](void *arg, const char *data, size_t len) -> esp_err_t {
+        return httpd_resp_send_chunk(static_cast<httpd_req_t *>(arg), data,
+                                     len);
+      },
+      req);
+  if (ret == ESP_ERR_INVALID_STATE) {
+    // 尚未发送任何数据，仍可返回错误状态（EXECUTOR_TELEMETRY为0时总是如此）
+    httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
+                        "Telemetry not available");
+    return ESP_FAIL;
+  }
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "遥测数据发送失败: %s", esp_err_to_name(ret));
+    return ret;
+  }
+
+  ESP_LOGI(TAG, "遥测数据已发送");
+  return httpd_resp_send_chunk(req, nullptr, 0);
+})
+
 // 静态文件处理器 - 使用通配符匹配所有路径
 GET("*", static_file_handler)
 
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 运动学之后的关节限速/限加速度（以及可选的限加加速度）
+#ifndef EXECUTOR_JOINT_LIMIT
+#define EXECUTOR_JOINT_LIMIT 1
+#endif
+
+// 舵机关节默认限制，单位为归一化目标值（-1到1对应500-2500us）
+// 默认值高于常见舵机的机械极限，正常运动不受影响，只截断单节拍跳变
+#ifndef SERVO_LIMIT_VELOCITY
+#define SERVO_LIMIT_VELOCITY 10.0f  // 每秒
+#endif
+#ifndef SERVO_LIMIT_ACCEL
+#define SERVO_LIMIT_ACCEL 1000.0f  // 每秒^2
+#endif
+#ifndef SERVO_LIMIT_JERK
+#define SERVO_LIMIT_JERK 0.0f  // 每秒^3，0表示不限制
+#endif
+
+// MIT电机关节默认限制，单位为弧度
+#ifndef MOTOR_LIMIT_VELOCITY
+#define MOTOR_LIMIT_VELOCITY 30.0f  // rad/s
+#endif
+#ifndef MOTOR_LIMIT_ACCEL
+#define MOTOR_LIMIT_ACCEL 3000.0f  // rad/s^2
+#endif
+#ifndef MOTOR_LIMIT_JERK
+#define MOTOR_LIMIT_JERK 0.0f  // rad/s^3，0表示不限制
+#endif
+
+/**
+ * @brief 关节轨迹限幅器
+ *
+ * 放在compute()与execute()之间，对每个关节的目标位置做速度、加速度和可选的
+ * 加加速度限制，每节拍每关节固定开销（一次开方和若干比较）。
+ *
+ * 期望速度取“恰好能以最大加速度刹停在目标”的速度：
+ * v_des = sign(e) * min(v_max, sqrt(2 * a_max * |e|), |e| / dt)，
+ * 再按加速度（以及加加速度）限制逼近v_des。最后一项保证接近目标时不越过。
+ *
+ * 统计每个节拍是否有关节触发各项限制，供执行器统计窗口读取。
+ */
+class JointLimiter {
+   public:
+    static constexpr size_t MAX_JOINTS = 8;
+
+    /**
+     * @brief 限制参数
+     */
+    struct Limits {
+        float velocity;  // 最大速度，<=0表示不限制
+        float accel;     // 最大加速度，<=0表示不限制
+        float jerk;      // 最大加加速度，<=0表示不限制
+    };
+
+    /**
+     * @brief 触发统计
+     */
+    struct Stats {
+        uint32_t ticks;          // 统计的节拍数
+        uint32_t velocity_hits;  // 触发速度限制的节拍数
+        uint32_t accel_hits;     // 触发加速度限制的节拍数
+        uint32_t jerk_hits;      // 触发加加速度限制的节拍数
+    };
+
+    /**
+     * @brief 配置限幅器，清除关节状态
+     * @param joints 关节数量（不超过MAX_JOINTS）
+     * @param limits 限制参数
+     * @param dt_s 节拍周期（秒）
+     */
+    void configure(size_t joints, const Limits& limits, float dt_s);
+
+    /**
+     * @brief 原位限幅一组目标
+     * 首次调用时以目标值为初始位置，不做限制
+     * @param targets 关节目标数组，长度为configure时的joints，输出限幅后的位置
+     */
+    void apply(float* targets);
+
+    /**
+     * @brief 以给定位置为起点、速度为零重新开始
+     * 用于输出中断后从实测位置平滑过渡到目标，NaN项保持原位置
+     * @param positions 关节位置数组，长度为configure时的joints
+     */
+    void reset(const float* positions);
+
+    /**
+     * @brief 所有关节是否已到达上次的目标并停止
+     */
+    bool settled() const { return m_settled; }
+
+    /**
+     * @brief 取出并清零触发统计（线程安全）
+     */
+    Stats takeStats();
+
+   private:
+    struct Joint {
+        float pos;
+        float vel;
+        float acc;
+    };
+
+    Joint m_joints[MAX_JOINTS] = {};
+    size_t m_count = 0;
+    Limits m_limits = {0.0f, 0.0f, 0.0f};
+    float m_dt = 0.0f;
+    float m_inv_dt = 0.0f;
+    bool m_initialized = false;
+    bool m_settled = true;
+
+    std::atomic<uint32_t> m_ticks{0};
+    std::atomic<uint32_t> m_velocity_hits{0};
+    std::atomic<uint32_t> m_accel_hits{0};
+    std::atomic<uint32_t> m_jerk_hits{0};
+};
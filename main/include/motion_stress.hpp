@@ -0,0 +1,39 @@
+#pragma once
+
+#include "esp_err.h"
+
+// 置1时启动后持续制造SPIFFS读取和Wi-Fi发送负载，用于对比CONFIG_MOTION_IRAM
+// 开关前后执行器统计中的节拍最大耗时（compute/execute max，配合
+// EXECUTOR_TICK_PROFILE=1可看到节拍最大CPU周期数）
+#ifndef MOTION_STRESS_TEST
+#define MOTION_STRESS_TEST 0
+#endif
+
+// UDP广播目标端口
+#ifndef MOTION_STRESS_UDP_PORT
+#define MOTION_STRESS_UDP_PORT 9999
+#endif
+
+// 负载统计打印间隔（秒）
+#ifndef MOTION_STRESS_REPORT_SECONDS
+#define MOTION_STRESS_REPORT_SECONDS 5
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 启动负载任务
+ *
+ * - SPIFFS任务：循环读取/spiffs下所有文件，持续占用flash读取
+ * - Wi-Fi任务：以UDP广播连续发送1KB报文（Wi-Fi未连接时发送失败，仅计数）
+ * 两个任务优先级低于执行器任务，只通过flash cache与执行器竞争
+ *
+ * @return ESP_OK 启动成功，ESP_FAIL 任务创建失败
+ */
+esp_err_t motion_stress_start(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -73,6 +73,20 @@ class TCode {
        return m_interpolatedValues;
    }
 
+   /**
+    * @brief 是否有轴正在插值
+    * @return true 任一轴的'I'插值尚未结束，false 所有轴均已到达目标值
+    */
+   bool isInterpolating() const {
+       uint64_t currentTime = static_cast<uint64_t>(esp_timer_get_time());
+       return isAxisInterpolating(L0_current, currentTime) ||
+              isAxisInterpolating(L1_current, currentTime) ||
+              isAxisInterpolating(L2_current, currentTime) ||
+              isAxisInterpolating(R0_current, currentTime) ||
+              isAxisInterpolating(R1_current, currentTime) ||
+              isAxisInterpolating(R2_current, currentTime);
+   }
+
     TCode() : m_interpolatedValues{0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f} {
         // 设置默认插值实现
         m_interpolateFunc = defaultInterpolate;
@@ -412,6 +426,21 @@ class TCode {
         return lastValue + (currentValue - lastValue) * t;
     }
 
+    /**
+     * @brief 判断单个轴是否处于插值过程中（静态辅助方法）
+     * @param cmd 轴当前命令
+     * @param currentTime 当前时间（微秒）
+     * @return true 插值未结束
+     */
+    static inline bool isAxisInterpolating(const TCodeComand& cmd,
+                                           uint64_t currentTime) {
+        if (cmd.extendType != 'I' || cmd.extendValue == 0) {
+            return false;
+        }
+        int64_t elapsed = static_cast<int64_t>(currentTime - cmd.receiveTime);
+        return elapsed < static_cast<int64_t>(cmd.extendValue) * 1000;
+    }
+
     // 内联函数用于字符类型检查
     inline bool is_letter(char c) {
         return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
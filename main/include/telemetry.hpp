@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "esp_err.h"
+
+// 关节遥测记录：每个执行节拍记录各关节的指令位置与实测位置。
+// 默认关闭：开启后常驻TELEMETRY_RING_TICKS * (1 + 2 * 关节数) * 4字节
+// （7关节约26KB），调参时按需置1
+#ifndef EXECUTOR_TELEMETRY
+#define EXECUTOR_TELEMETRY 0
+#endif
+
+// 环形缓冲的节拍数，6关节时每节拍52字节
+#ifndef TELEMETRY_RING_TICKS
+#define TELEMETRY_RING_TICKS 512
+#endif
+
+/**
+ * @brief 遥测下载文件头（小端，紧随其后为按时间顺序排列的records条记录）
+ *
+ * 每条记录为：uint32_t 时间戳（esp_timer低32位，微秒），
+ * float 指令位置[joints]，float 实测位置[joints]（无反馈时为NaN）。
+ * 位置单位与执行器一致：舵机为归一化目标值，MIT电机为弧度。
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;           // TELEMETRY_MAGIC
+    uint16_t version;         // TELEMETRY_VERSION
+    uint16_t joints;          // 关节数
+    uint32_t records;         // 记录条数
+    uint32_t tick_period_us;  // 执行节拍周期（微秒）
+    uint32_t dropped;         // 因下载占用缓冲而丢弃的节拍数
+} telemetry_header_t;
+
+#define TELEMETRY_MAGIC 0x314D4C54u  // "TLM1"
+#define TELEMETRY_VERSION 1
+
+/**
+ * @brief 关节遥测记录器（单例）
+ *
+ * 固定大小的环形缓冲，执行器任务每节拍写入一条，下载时直接从环形缓冲分段
+ * 输出，不另行拷贝。写入侧只做try_lock，下载期间的节拍直接丢弃并计数，
+ * 不阻塞执行器。
+ * 执行器重建时重新begin()，缓冲区按关节数重新分配。
+ */
+class Telemetry {
+   public:
+    /**
+     * @brief 下载输出回调，返回ESP_OK以外的值时中止下载
+     * @param arg stream()传入的参数
+     * @param data 数据
+     * @param len 数据长度
+     */
+    typedef esp_err_t (*Writer)(void* arg, const char* data, size_t len);
+
+    /**
+     * @brief 获取单例实例
+     */
+    static Telemetry& getInstance();
+
+    /**
+     * @brief 开始新的记录，清空缓冲
+     * @param joints 关节数
+     * @param tick_period_us 执行节拍周期（微秒）
+     */
+    void begin(size_t joints, uint32_t tick_period_us);
+
+    /**
+     * @brief 记录一个节拍
+     * 关节数与begin()不一致时忽略（执行器切换期间旧执行器的最后几个节拍）
+     * @param commanded 指令位置
+     * @param measured 实测位置，nullptr表示无反馈
+     * @param joints 数组长度
+     */
+    void record(const float* commanded, const float* measured, size_t joints);
+
+    /**
+     * @brief 输出下载数据（文件头+按时间顺序的全部记录）
+     * 分文件头、环形缓冲两段至多三次调用writer，期间持有缓冲锁
+     * @param writer 输出回调（如httpd_resp_send_chunk）
+     * @param arg 回调参数
+     * @return ESP_OK；未开始记录时ESP_ERR_INVALID_STATE；否则为writer的返回值
+     */
+    esp_err_t stream(Writer writer, void* arg);
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+   private:
+    Telemetry() = default;
+
+    std::mutex m_mutex;
+    std::unique_ptr<uint32_t[]> m_ring;  // 每条记录1 + 2 * joints个字
+    size_t m_joints = 0;
+    size_t m_record_words = 0;
+    size_t m_head = 0;   // 下一条写入位置
+    size_t m_count = 0;  // 有效记录条数
+    uint32_t m_tick_period_us = 0;
+    std::atomic<uint32_t> m_dropped{0};
+};
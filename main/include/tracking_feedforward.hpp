@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 指令-位置滞后估计的最大节拍数
+#ifndef TRACKING_LAG_MAX_TICKS
+#define TRACKING_LAG_MAX_TICKS 12
+#endif
+
+// 每次滞后估计使用的运动中反馈样本数（每关节）
+#ifndef TRACKING_LAG_SAMPLES
+#define TRACKING_LAG_SAMPLES 100
+#endif
+
+// 目标速度低于此值（关节单位/秒）的样本不参与滞后估计，静止时各滞后无法区分
+#ifndef TRACKING_MIN_VELOCITY
+#define TRACKING_MIN_VELOCITY 0.5f
+#endif
+
+// 前馈开关时的过渡时间（秒），避免超前量一次性跳变
+#ifndef TRACKING_RAMP_S
+#define TRACKING_RAMP_S 0.2f
+#endif
+
+// 跟踪误差打印间隔（毫秒），A/B模式下同时是前馈开关的切换间隔
+#ifndef TRACKING_REPORT_MS
+#define TRACKING_REPORT_MS 5000
+#endif
+
+/**
+ * @brief 基于实测反馈的跟踪前馈
+ *
+ * 放在关节限幅之后、写入执行器之前，每节拍每关节：
+ * - 速度前馈：轨迹目标的差分（插值轨迹经运动学后的导数）
+ * - 滞后补偿：下发位置 = 目标 + 速度 × 估计滞后
+ *
+ * 滞后估计：保存最近若干节拍的下发位置，每个新反馈样本按接收时刻找到对应
+ * 节拍，对0~TRACKING_LAG_MAX_TICKS个候选滞后累加 (实测 - 下发[k - d])²，
+ * 攒够TRACKING_LAG_SAMPLES个运动中样本后取最小值（抛物线插值到亚节拍）并
+ * 平滑。与实测比较的是下发位置而非目标，因此补偿生效后估计仍是电机本身的
+ * 滞后，不会随补偿漂移。
+ *
+ * 跟踪误差：每个新反馈样本与收到它的节拍的轨迹目标之差，按窗口打印各关节
+ * RMS。陈旧反馈不重复计入，否则误差里会多出与前馈无关的“速度 × 反馈年龄”。
+ * scripts/telemetry_dump.py与主机仿真由遥测（实测值有变化的记录）按同一定义
+ * 计算，两者可直接比较。A/B模式下每个窗口切换一次前馈开关，打印开、关两种
+ * 状态下的RMS对比。开关过渡期间（TRACKING_RAMP_S）的节拍不计入RMS，各窗口
+ * 只统计前馈完全开启或完全关闭时的样本。
+ *
+ * 位置单位与关节目标一致，反馈为NaN或未更新的关节不参与统计。
+ */
+class TrackingFeedForward {
+   public:
+    static constexpr size_t MAX_JOINTS = 8;
+
+    /**
+     * @brief 配置，清除全部状态
+     * @param joints 关节数量（不超过MAX_JOINTS）
+     * @param dt_s 节拍周期（秒）
+     * @param ab_test true时每个打印窗口切换一次前馈开关
+     */
+    void configure(size_t joints, float dt_s, bool ab_test);
+
+    /**
+     * @brief 输出中断后重新开始（保留滞后估计）
+     */
+    void reset();
+
+    /**
+     * @brief 计算本节拍的下发位置与速度前馈
+     * @param targets 轨迹目标
+     * @param positions 输出：下发位置
+     * @param velocities 输出：速度前馈（前馈关闭时为0）
+     */
+    void apply(const float* targets, float* positions, float* velocities);
+
+    /**
+     * @brief 送入实测反馈，更新滞后估计与跟踪误差统计，在apply()之后调用
+     * @param measured 实测位置，NaN表示无反馈
+     * @param sample_us 各反馈的接收时刻（微秒），与上次相同视为未更新
+     * @param now_us 当前时刻（微秒）
+     * @param aligned 输出：实测时刻往前推估计滞后的下发位置，即电机此刻应到达
+     *                的位置；非新样本为NaN。供积分校正使用
+     */
+    void observe(const float* measured, const int64_t* sample_us,
+                 int64_t now_us, float* aligned);
+
+    /**
+     * @brief 前馈当前是否开启（A/B模式下随窗口切换）
+     */
+    bool active() const { return m_active; }
+
+   private:
+    static constexpr size_t HISTORY = 32;  // 历史节拍数，需容纳反馈延迟与最大滞后
+    static_assert(TRACKING_LAG_MAX_TICKS < HISTORY / 2,
+                  "TRACKING_LAG_MAX_TICKS too large for the history ring");
+
+    struct Joint {
+        float target[HISTORY];    // 轨迹目标
+        float sent[HISTORY];      // 下发位置
+        float velocity[HISTORY];  // 目标速度
+        float last_target;        // 上一节拍目标，NaN为无
+        int64_t last_sample_us;   // 上一个反馈样本的接收时刻
+        float lag_ticks;          // 估计滞后（节拍）
+        bool lag_valid;
+        float cost[TRACKING_LAG_MAX_TICKS + 1];  // 各候选滞后的误差平方和
+        uint32_t lag_samples;
+        float sq_sum;             // 窗口内跟踪误差平方和
+        uint32_t samples;
+    };
+
+    /**
+     * @brief 由累加的误差平方和更新滞后估计
+     */
+    void estimateLag(Joint& j);
+
+    /**
+     * @brief 打印窗口统计，A/B模式下切换前馈开关
+     */
+    void report(int64_t now_us);
+
+    Joint m_joints[MAX_JOINTS] = {};
+    size_t m_count = 0;
+    float m_dt = 0.0f;
+    float m_inv_dt = 0.0f;
+    uint32_t m_tick = 0;  // 已apply的节拍数
+    bool m_ab_test = false;
+    bool m_active = true;
+    float m_gain = 0.0f;  // 当前前馈比例，按TRACKING_RAMP_S逼近开关状态
+    int64_t m_window_start_us = 0;
+    float m_rms_on = -1.0f;  // 最近一个开/关窗口的RMS，<0为无
+    float m_rms_off = -1.0f;
+};
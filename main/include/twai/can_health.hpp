@@ -0,0 +1,150 @@
+#pragma once
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+// 健康监测任务优先级，低于执行器任务（5），恢复中的阻塞请求不占用节拍
+#ifndef CAN_HEALTH_TASK_PRIORITY
+#define CAN_HEALTH_TASK_PRIORITY 4
+#endif
+
+// 无告警时轮询驱动状态的间隔（毫秒），兜底漏掉的告警，也是恢复失败后的重试间隔
+#ifndef CAN_HEALTH_POLL_MS
+#define CAN_HEALTH_POLL_MS 100
+#endif
+
+/**
+ * @brief CAN总线健康状态机
+ *
+ * 由CanRx转发的错误告警唤醒，并定期读取驱动状态兜底：
+ * - ACTIVE -> ERROR_PASSIVE：错误计数达到128（如接头松动无人应答），仍可发送
+ * - 任意 -> BUS_OFF：发起twai_initiate_recovery，等待总线恢复后重启驱动
+ * - BUS_OFF / ERROR_PASSIVE -> RESUMING：总线恢复正常后调用恢复回调
+ *   （重新使能电机），成功后回到ACTIVE，恢复代数加一；失败则保持RESUMING
+ *   并按轮询间隔重试
+ *
+ * 执行器在streaming()为false时保持不发控制帧，发现恢复代数变化后从电机
+ * 实测位置重新起步。每次恢复打印故障到恢复完成的耗时。
+ */
+class CanHealth {
+   public:
+    /**
+     * @brief 总线状态
+     */
+    enum class State : uint8_t {
+        ACTIVE,         // 错误主动，正常收发
+        ERROR_PASSIVE,  // 错误被动，仍可发送
+        BUS_OFF,        // 总线关闭，恢复中
+        RESUMING,       // 驱动已恢复，正在重新使能电机
+    };
+
+    /**
+     * @brief 恢复回调，在健康监测任务中调用，可阻塞（调用期间不持有统计锁）
+     * @param arg 注册时的参数
+     * @return ESP_OK 电机已重新使能且均无异常；其他值（含仍有电机报告异常）
+     *         计为一次恢复失败，在下个轮询间隔重试
+     */
+    typedef esp_err_t (*ResumeHandler)(void* arg);
+
+    /**
+     * @brief 累计统计
+     */
+    struct Stats {
+        uint32_t bus_off;           // 总线关闭次数
+        uint32_t error_passive;     // 进入错误被动次数
+        uint32_t recoveries;        // 完成恢复次数
+        uint32_t resume_failures;   // 恢复回调失败次数（含电机仍有异常）
+        uint32_t last_recovery_ms;  // 最近一次故障到恢复完成的耗时
+        uint32_t max_recovery_ms;   // 最长恢复耗时
+    };
+
+    /**
+     * @brief 启动健康监测任务（需先启动TWAI，重复调用直接返回）
+     * @return esp_err_t 错误码
+     */
+    static esp_err_t start();
+
+    /**
+     * @brief 转发TWAI错误告警，唤醒健康监测任务
+     * @param alerts 告警位
+     */
+    static void notifyAlerts(uint32_t alerts);
+
+    /**
+     * @brief 注册恢复回调（nullptr取消注册，会等待进行中的回调结束）
+     * @param handler 回调
+     * @param arg 回调参数
+     */
+    static void setResumeHandler(ResumeHandler handler, void* arg);
+
+    /**
+     * @brief 回调参数仍为arg时取消注册（会等待进行中的回调结束）
+     * 供注册者析构时调用：回调已被之后注册的对象替换时保持不变
+     * @param arg 注册时的回调参数
+     */
+    static void clearResumeHandler(void* arg);
+
+    /**
+     * @brief 当前状态
+     */
+    static State state() { return current.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 是否可以下发控制帧（ACTIVE或ERROR_PASSIVE）
+     */
+    static bool streaming() {
+        State s = state();
+        return s == State::ACTIVE || s == State::ERROR_PASSIVE;
+    }
+
+    /**
+     * @brief 恢复代数，每次完成恢复加一（先于状态回到ACTIVE更新）
+     */
+    static uint32_t generation() {
+        return resume_generation.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 读取累计统计
+     * @return Stats 统计数据
+     */
+    static Stats getStats();
+
+   private:
+    static std::atomic<State> current;
+    static std::atomic<uint32_t> resume_generation;
+    static TaskHandle_t task_handle;
+    static std::mutex mutex;          // 保护统计
+    static std::mutex handler_mutex;  // 保护回调，调用回调期间持有
+    static ResumeHandler resume_handler;
+    static void* resume_arg;
+    static Stats stats;
+    static int64_t fault_time_us;  // 本次故障开始时间
+    static int64_t bus_time_us;    // 总线恢复正常的时间
+
+    /**
+     * @brief 健康监测任务
+     * @param arg 任务参数
+     */
+    static void healthTask(void* arg);
+
+    /**
+     * @brief 进入故障状态并记录开始时间
+     * @param next BUS_OFF或ERROR_PASSIVE
+     */
+    static void enterFault(State next);
+
+    /**
+     * @brief 调用恢复回调，成功后回到ACTIVE
+     */
+    static void resume();
+
+    /**
+     * @brief 状态名称
+     */
+    static const char* stateName(State s);
+};
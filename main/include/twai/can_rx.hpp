@@ -0,0 +1,165 @@
+#pragma once
+
+#include <driver/twai.h>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/task.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+// 缓存状态的节点数（节点ID 0 ~ CAN_RX_MAX_NODES-1）
+#ifndef CAN_RX_MAX_NODES
+#define CAN_RX_MAX_NODES 8
+#endif
+
+// 同时等待响应的请求数上限（不超过事件组可用位数24）
+#ifndef CAN_RX_MAX_WAITERS
+#define CAN_RX_MAX_WAITERS 8
+#endif
+
+// 接收任务优先级，高于执行器任务（5），反馈在节拍读取前即已入槽
+#ifndef CAN_RX_TASK_PRIORITY
+#define CAN_RX_TASK_PRIORITY 6
+#endif
+
+// 接收统计打印间隔（毫秒）
+#ifndef CAN_RX_REPORT_MS
+#define CAN_RX_REPORT_MS 5000
+#endif
+
+/**
+ * @brief CAN接收分发器
+ *
+ * 唯一调用TWAI::receive的任务，由TWAI告警驱动：RX_DATA告警时取空驱动
+ * 接收队列，错误告警（总线关闭、错误被动、接收队列满等）即时记录，
+ * 无需等某次发送失败才发现。每帧按 CAN ID = (node_id << 5) | cmd_id
+ * 拆分后：
+ * - 写入该节点的状态槽（每个cmd保留最新一帧），槽位以seqlock保护，
+ *   单写者为接收任务，读者（执行器节拍等）无锁读取
+ * - 唤醒所有等待该 (node_id, cmd_id) 的请求
+ *
+ * 请求/响应调用先expect()登记再发送，响应早于wait()到达也不会丢失；
+ * 流式反馈与请求/响应互不抢帧。
+ */
+class CanRx {
+   public:
+    static constexpr uint8_t ANY_NODE = 0xFF;  // expect()匹配任意节点
+
+    /**
+     * @brief 接收到的帧
+     */
+    struct Frame {
+        uint8_t node;          // 节点ID
+        uint8_t cmd;           // 命令ID
+        uint8_t len;           // 数据长度
+        uint8_t data[8];       // 数据
+        int64_t timestamp_us;  // 接收时间
+    };
+
+    /**
+     * @brief 统计窗口数据
+     */
+    struct Stats {
+        uint32_t received;       // 接收帧数（通过硬件过滤器）
+        uint32_t unwanted;       // 其中不属于配置接收集合的帧数
+        uint32_t completed;      // 完成的请求数
+        uint32_t timeouts;       // 超时的请求数
+        uint32_t unmatched;      // 既不在状态槽范围内也无人等待的帧数
+        uint32_t dropped;        // 驱动接收队列溢出丢失的帧数
+        uint32_t rx_queue_full;  // 接收队列满告警次数
+        uint32_t bus_errors;     // 总线错误告警次数
+        uint32_t error_passive;  // 进入错误被动次数
+        uint32_t bus_off;        // 总线关闭次数
+    };
+
+    /**
+     * @brief 启动接收任务（需先启动TWAI，重复调用直接返回）
+     * @return esp_err_t 错误码
+     */
+    static esp_err_t start();
+
+    /**
+     * @brief 读取节点某命令的最新一帧（无锁）
+     * @param node 节点ID
+     * @param cmd 命令ID
+     * @param frame 输出参数：帧
+     * @return true 已收到过该帧，false 未收到或节点超出范围
+     */
+    static bool read(uint8_t node, uint8_t cmd, Frame& frame);
+
+    /**
+     * @brief 登记等待一个响应（须在发送请求前调用）
+     * @param node 节点ID，ANY_NODE匹配任意节点
+     * @param cmd 命令ID
+     * @return int 票据，-1表示等待位已满
+     */
+    static int expect(uint8_t node, uint8_t cmd);
+
+    /**
+     * @brief 等待登记的响应并释放票据
+     * @param ticket expect()返回的票据
+     * @param timeout_ms 超时时间（毫秒）
+     * @param frame 输出参数：响应帧
+     * @return ESP_OK 收到，ESP_ERR_TIMEOUT 超时，ESP_ERR_INVALID_ARG 票据无效
+     */
+    static esp_err_t wait(int ticket, int timeout_ms, Frame& frame);
+
+    /**
+     * @brief 不等待直接释放票据（请求发送失败时）
+     * @param ticket 票据
+     */
+    static void release(int ticket);
+
+    /**
+     * @brief 取出并清零统计窗口
+     * @return Stats 统计数据
+     */
+    static Stats takeStats();
+
+   private:
+    struct NodeSlot {
+        std::atomic<uint32_t> seq;  // 奇数表示正在写入
+        uint32_t valid_mask;        // 已收到过的cmd
+        Frame frames[32];           // 按cmd索引
+    };
+
+    struct Waiter {
+        bool used;
+        bool done;
+        uint8_t node;
+        uint8_t cmd;
+        Frame frame;
+    };
+
+    static NodeSlot nodes[CAN_RX_MAX_NODES];
+    static Waiter waiters[CAN_RX_MAX_WAITERS];
+    static EventGroupHandle_t waiter_events;  // 第i位：第i个等待者已完成
+    static TaskHandle_t task_handle;
+    static std::mutex mutex;  // 保护等待者与统计
+    static Stats stats;
+
+    /**
+     * @brief 接收任务
+     * @param arg 任务参数
+     */
+    static void rxTask(void* arg);
+
+    /**
+     * @brief 分发一帧
+     * @param frame 帧
+     */
+    static void dispatch(const Frame& frame);
+
+    /**
+     * @brief 取空驱动接收队列
+     */
+    static void drain();
+
+    /**
+     * @brief 记录错误告警
+     * @param alerts 告警位
+     */
+    static void handleErrorAlerts(uint32_t alerts);
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <driver/twai.h>
+#include <esp_event.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+// 总线负载预算（占总线时间比例），控制帧与反馈轮询合计不超过此值
+#ifndef CAN_LOAD_BUDGET
+#define CAN_LOAD_BUDGET 0.7f
+#endif
+
+// 每个节点反馈轮询的最低频率（Hz），选择节拍频率时先为其预留总线时间
+#ifndef CAN_FEEDBACK_MIN_HZ
+#define CAN_FEEDBACK_MIN_HZ 10
+#endif
+
+// 每个控制帧引起的应答帧数（MIT控制帧由电机回复一帧状态）
+#ifndef CAN_CONTROL_REPLIES
+#define CAN_CONTROL_REPLIES 1
+#endif
+
+// 计划与实测负载的打印间隔（毫秒）
+#ifndef CAN_SCHEDULE_REPORT_MS
+#define CAN_SCHEDULE_REPORT_MS 5000
+#endif
+
+/**
+ * @brief 按负载预算分配每节拍CAN时隙
+ *
+ * 每个节拍的总线时间分为两部分：
+ * - 控制帧：每个电机一帧及其应答，固定占用
+ * - 反馈轮询：CMD_GET_ENCODER_ESTIMATES远程帧及其应答，用剩余预算轮流请求各节点
+ *
+ * configure()按帧长（calculate_message_transmission_time）计算：在为每个节点
+ * 预留CAN_FEEDBACK_MIN_HZ轮询后，预算能支持的最高节拍频率，请求值超过时
+ * 降到该频率；余下预算全部分给反馈轮询（每节拍最多轮询所有节点一次）。
+ *
+ * 运行中订阅TWAI总线负载事件，实测负载（含其他节点的流量）超出预算时按差额
+ * 降低反馈轮询频率，回落后逐步恢复到计划值，但不超过计划值。
+ */
+class CanSchedule {
+   public:
+    /**
+     * @brief 时隙分配结果
+     */
+    struct Plan {
+        uint32_t tick_hz;     // 节拍频率（不超过请求值）
+        uint32_t control_us;  // 每节拍控制帧及应答占用的总线时间（微秒）
+        uint32_t poll_us;     // 一次反馈轮询（请求+应答）占用的总线时间（微秒）
+        float feedback_hz;    // 计划反馈轮询频率（所有节点合计）
+        float planned_load;   // 计划负载（0.0-1.0）
+    };
+
+    /**
+     * @brief 计算时隙分配并开始订阅总线负载
+     * @param bitrate 波特率
+     * @param requested_hz 期望的节拍频率
+     * @param control_frames 每节拍控制帧数
+     * @param node_mask 反馈轮询的节点掩码（第n位对应节点n）
+     * @return Plan 分配结果
+     */
+    static Plan configure(uint32_t bitrate, uint32_t requested_hz,
+                          size_t control_frames, uint64_t node_mask);
+
+    /**
+     * @brief 生成本节拍应发送的反馈请求（远程帧），由执行器在节拍中调用
+     * @param frames 输出数组
+     * @param max 数组长度
+     * @return size_t 生成的帧数
+     */
+    static size_t feedbackRequests(twai_message_t* frames, size_t max);
+
+    /**
+     * @brief 当前分配结果
+     */
+    static Plan plan();
+
+    /**
+     * @brief 最近一次实测总线负载（0.0-1.0）
+     */
+    static float measuredLoad() {
+        return measured_load.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 当前反馈轮询频率（所有节点合计，Hz）
+     */
+    static float feedbackHz() {
+        return feedback_hz.load(std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr size_t MAX_NODES = 64;
+
+    static std::mutex mutex;  // 保护分配结果与统计
+    static Plan current;
+    static uint8_t nodes[MAX_NODES];
+    static size_t node_count;
+    static size_t next_node;  // 轮询位置（仅执行器任务访问）
+    static float credit;      // 请求数累加器（仅执行器任务访问）
+    static std::atomic<float> feedback_hz;
+    static std::atomic<float> measured_load;
+    static bool handler_registered;
+
+    // 打印窗口
+    static uint32_t window_start_ms;
+    static float window_load_sum;
+    static uint32_t window_samples;
+
+    /**
+     * @brief 总线负载更新事件处理器，调整反馈轮询频率
+     */
+    static void busLoadHandler(void* arg, esp_event_base_t base, int32_t id,
+                               void* data);
+};
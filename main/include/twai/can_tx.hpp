@@ -0,0 +1,139 @@
+#pragma once
+
+#include <driver/twai.h>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+
+// 待发送帧槽位数（同一CAN ID共用一个槽位）
+#ifndef CAN_TX_SLOTS
+#define CAN_TX_SLOTS 16
+#endif
+
+// 发送任务优先级，高于执行器任务（5），提交或发送完成后立即补充驱动队列
+#ifndef CAN_TX_TASK_PRIORITY
+#define CAN_TX_TASK_PRIORITY 6
+#endif
+
+// 驱动发送队列满时单帧最长等待时间（毫秒），超时则丢弃该帧；
+// 队列达到CAN_TX_DRIVER_DEPTH而未收到发送完成告警时也按此间隔重新检查
+#ifndef CAN_TX_TIMEOUT_MS
+#define CAN_TX_TIMEOUT_MS 5
+#endif
+
+// 驱动发送队列（含正在发送的帧）最多保留的帧数。
+// 2帧时总线上一帧发完下一帧已就绪，帧间没有空闲；其余帧留在槽位中，
+// 总线跟不上时仍可被同ID新帧合并
+#ifndef CAN_TX_DRIVER_DEPTH
+#define CAN_TX_DRIVER_DEPTH 2
+#endif
+
+// 发送统计打印间隔（毫秒）
+#ifndef CAN_TX_REPORT_MS
+#define CAN_TX_REPORT_MS 5000
+#endif
+
+/**
+ * @brief 非阻塞批量CAN发送调度器
+ *
+ * 执行器每个节拍调用submit()提交整组电机命令帧，帧写入按CAN ID索引的槽位后
+ * 立即返回，由独立的发送任务搬运到TWAI驱动队列。驱动队列中的帧已无法撤回，
+ * 因此发送任务只在驱动队列深度（msgs_to_tx）低于CAN_TX_DRIVER_DEPTH时取出
+ * 槽位中的帧，发送完成告警（由CanRx转发）到来时再补充。总线跟不上时，
+ * 同一ID尚未发出的旧帧留在槽位中被新帧覆盖（合并），电机总是收到最新目标，
+ * 执行器任务不会因驱动队列满而阻塞。
+ */
+class CanTx {
+   public:
+    /**
+     * @brief 统计窗口数据
+     */
+    struct Stats {
+        uint32_t submitted;         // 提交帧数
+        uint32_t sent;              // 进入驱动发送队列的帧数
+        uint32_t completed;         // 驱动报告发送结束（成功或失败）的帧数
+        uint32_t coalesced;         // 未发出即被同ID新帧覆盖的帧数
+        uint32_t failed;            // 驱动队列满或总线错误而丢弃的帧数
+        uint32_t pending_max;       // 待发送槽位最大占用数
+        uint32_t driver_queue_max;  // 驱动发送队列最大深度
+        uint32_t latency_avg_us;    // 提交到发送结束的平均延迟
+        uint32_t latency_max_us;    // 提交到发送结束的最大延迟
+    };
+
+    /**
+     * @brief 启动发送任务（需先启动TWAI，重复调用直接返回）
+     * @return esp_err_t 错误码
+     */
+    static esp_err_t start();
+
+    /**
+     * @brief 提交一组帧，不阻塞
+     * @param frames 帧数组
+     * @param count 帧数
+     * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 未启动，
+     *         ESP_ERR_NO_MEM 槽位已满（多余的帧被丢弃）
+     */
+    static esp_err_t submit(const twai_message_t* frames, size_t count);
+
+    /**
+     * @brief 发送完成通知（TWAI_TX_ALERTS），由接收任务调用
+     */
+    static void notifyTxDone();
+
+    /**
+     * @brief 丢弃所有待发送帧并等待正在发送的帧完成
+     *
+     * 在直接经TWAI发送停止等命令前调用，避免旧的控制帧排在其后发出。
+     *
+     * @param timeout_ms 等待超时（毫秒）
+     */
+    static void cancel(int timeout_ms = 50);
+
+    /**
+     * @brief 取出并清零统计窗口
+     * @return Stats 统计数据
+     */
+    static Stats takeStats();
+
+   private:
+    struct Slot {
+        twai_message_t msg;
+        int64_t submit_time;  // 提交时间（微秒）
+        bool pending;         // 有待发送帧
+    };
+
+    static Slot slots[CAN_TX_SLOTS];
+    static size_t slot_count;
+    static bool in_flight;  // 发送任务持有一帧正在交给驱动
+    static TaskHandle_t task_handle;
+    static std::mutex mutex;  // 保护槽位与统计
+
+    // 已交给驱动、尚未发送结束的本模块帧的提交时间（FIFO，受mutex保护）
+    static int64_t driver_submit_times[CAN_TX_DRIVER_DEPTH];
+    static size_t driver_head;
+    static size_t driver_count;
+
+    // 统计累加值（受mutex保护）
+    static Stats stats;
+    static uint64_t latency_sum_us;
+
+    /**
+     * @brief 按驱动队列深度回收已发送结束的帧并统计延迟
+     *
+     * 驱动按FIFO发送，队列中最多剩queued帧属于本模块，更早的即已结束。
+     * 其他模块直接经TWAI发送的帧排在本模块帧之后时，结束时刻会略晚记录。
+     *
+     * @param queued 驱动发送队列深度（msgs_to_tx）
+     * @param now 当前时间（微秒）
+     */
+    static void retire(uint32_t queued, int64_t now);
+
+    /**
+     * @brief 发送任务：等待提交或发送完成通知，驱动队列未满时按槽位顺序发出待发送帧
+     * @param arg 任务参数
+     */
+    static void txTask(void* arg);
+};
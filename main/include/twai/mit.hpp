@@ -2,9 +2,15 @@
 
 #include <driver/twai.h>
 #include <esp_err.h>
+#include <stdint.h>
 #include <string>
 #include <mutex>
 
+// 并行启动时每个节点等待响应的超时时间（毫秒）
+#ifndef MIT_BRING_UP_TIMEOUT_MS
+#define MIT_BRING_UP_TIMEOUT_MS 200
+#endif
+
 /**
  * @brief MIT协议实现类
  *
@@ -92,14 +98,14 @@ public:
    * @brief 电机控制参数结构体
    */
   struct MotorControl {
-    double position; // 位置 (弧度)
-    double velocity; // 速度 (弧度/秒)
-    double kp;       // 位置增益
-    double kd;       // 速度增益
-    double torque;   // 力矩 (N.m)
+    float position; // 位置 (弧度)
+    float velocity; // 速度 (弧度/秒)
+    float kp;       // 位置增益
+    float kd;       // 速度增益
+    float torque;   // 力矩 (N.m)
 
     MotorControl()
-        : position(0.0), velocity(0.0), kp(0.0), kd(0.0), torque(0.0) {}
+        : position(0.0f), velocity(0.0f), kp(0.0f), kd(0.0f), torque(0.0f) {}
   };
 
   /**
@@ -107,23 +113,26 @@ public:
    */
   struct MotorStatus {
     uint8_t can_id;      // CAN ID
-    double position;     // 位置 (弧度)
-    double velocity;     // 速度 (弧度/秒)
-    double torque;       // 力矩 (N.m)
+    float position;      // 位置 (弧度)
+    float velocity;      // 速度 (弧度/秒)
+    float torque;        // 力矩 (N.m)
     uint64_t fault_code; // 异常代码
 
     MotorStatus()
-        : can_id(0), position(0.0), velocity(0.0), torque(0.0), fault_code(0) {}
+        : can_id(0), position(0.0f), velocity(0.0f), torque(0.0f),
+          fault_code(0) {}
   };
   /**
    * @brief 初始化MIT协议
    * @param tx_pin TWAI TX引脚
    * @param rx_pin TWAI RX引脚
    * @param bitrate 波特率
+   * @param node_mask 在线电机节点掩码（第n位对应节点n），据此只接收这些
+   *                  节点的响应帧；0表示接收全部
    * @return esp_err_t 错误码
    */
   static esp_err_t init(int tx_pin = 2, int rx_pin = 3,
-                        uint32_t bitrate = 500000);
+                        uint32_t bitrate = 500000, uint64_t node_mask = 0);
 
   /**
    * @brief 获取电机异常
@@ -162,6 +171,41 @@ public:
    */
   static esp_err_t set_state(uint8_t nodeid, AxisState state);
 
+  /**
+   * @brief 并行启动结果
+   */
+  struct BringUpResult {
+    uint64_t responded;    // 按时响应的节点掩码
+    uint64_t late;         // 超时未响应的节点掩码
+    uint64_t unsent;       // 未能发出命令的节点掩码（CanRx等待位不足或发送失败）
+    uint64_t faulted;      // 响应中带异常代码的节点掩码
+    uint32_t elapsed_ms;   // 总耗时
+    uint32_t slowest_us;   // 最慢节点从发出请求到收到响应的时间
+    uint8_t slowest_node;  // 最慢的节点
+  };
+
+  /**
+   * @brief 并行启动一组电机
+   *
+   * 对所有节点连续发出（可选的清除异常、）设置轴状态和查询异常命令，不逐个
+   * 等待；同一节点的命令按顺序处理，查询异常的响应即说明状态已切换。响应经
+   * CanRx同时等待，每个节点从各自的请求发出起计算超时。
+   *
+   * @param node_mask 节点掩码（第n位对应节点n）
+   * @param state 目标轴状态
+   * @param clear_faults 是否先清除异常
+   * @param timeout_ms 每个节点的响应超时(毫秒)
+   * @param result 输出参数：启动结果，各类节点掩码
+   * @return esp_err_t ESP_OK 全部按时响应且均无异常；
+   *         ESP_FAIL 有节点未能发出命令（result.unsent）；
+   *         ESP_ERR_TIMEOUT 有节点超时（result.late）；
+   *         ESP_ERR_INVALID_STATE 有节点响应异常代码（result.faulted）。
+   *         多种情况同时出现时按以上顺序返回
+   */
+  static esp_err_t bring_up(uint64_t node_mask, AxisState state,
+                            bool clear_faults, int timeout_ms,
+                            BringUpResult &result);
+
   /**
    * @brief 动态控制电机
    * @param nodeid 电机节点ID
@@ -170,6 +214,19 @@ public:
    */
   static esp_err_t dynamic_control(uint8_t nodeid, const MotorControl &control);
 
+  /**
+   * @brief 组装动态控制帧（只打包，不发送）
+   *
+   * 供CanTx批量提交使用
+   *
+   * @param nodeid 电机节点ID
+   * @param control 控制参数
+   * @param frame 输出参数：CAN帧
+   */
+  static void build_dynamic_control_frame(uint8_t nodeid,
+                                          const MotorControl &control,
+                                          twai_message_t &frame);
+
   /**
    * @brief 设置电机位置 (setpos)
    * @param nodeid 电机节点ID
@@ -190,7 +247,7 @@ public:
                                                  MotorStatus &status);
 
   /**
-   * @brief 接收电机状态反馈
+   * @brief 接收电机状态反馈（任意节点的下一帧MIT控制响应）
    * @param timeout_ms 超时时间(毫秒)
    * @param status 输出参数：电机状态
    * @return esp_err_t 错误码
@@ -198,7 +255,10 @@ public:
   static esp_err_t receive_status(int timeout_ms, MotorStatus &status);
 
   /**
-   * @brief 发送命令并等待响应
+   * @brief 等待响应
+   *
+   * 只能收到调用之后到达的响应；先发送再等待的场景请使用request()
+   *
    * @param nodeid 电机节点ID
    * @param command 命令
    * @param timeout_ms 超时时间(毫秒)
@@ -228,6 +288,20 @@ private:
   static bool initialized;
   static std::recursive_mutex mutex;  // 可重入互斥锁，保护静态成员访问
 
+  /**
+   * @brief 登记响应后发送命令并等待响应
+   * @param nodeid 电机节点ID
+   * @param command 命令
+   * @param data 8字节命令数据
+   * @param timeout_ms 超时时间(毫秒)
+   * @param response_data 响应数据
+   * @param response_len 响应数据长度
+   * @return esp_err_t 错误码
+   */
+  static esp_err_t request(uint8_t nodeid, Command command,
+                           const uint8_t data[8], int timeout_ms,
+                           uint8_t *response_data, uint8_t &response_len);
+
   /**
    * @brief 根据nodeid和cmdid计算CAN ID
    * @param nodeid 节点ID (0-63)
@@ -236,76 +310,6 @@ private:
    */
   static uint32_t calculate_can_id(uint8_t nodeid, uint8_t cmdid);
 
-  /**
-   * @brief 将double位置值转换为16位int
-   * @param position 位置值 (弧度)
-   * @return int16_t 转换后的16位整数
-   */
-  static uint16_t position_to_int(double position);
-
-  /**
-   * @brief 将16位int位置值转换为double
-   * @param pos_int 16位整数位置值
-   * @return double 转换后的位置值 (弧度)
-   */
-  static double int_to_position(uint16_t pos_int);
-
-  /**
-   * @brief 将double速度值转换为12位int
-   * @param velocity 速度值 (弧度/秒)
-   * @return int16_t 转换后的12位整数
-   */
-  static int16_t velocity_to_int(double velocity);
-
-  /**
-   * @brief 将12位int速度值转换为double
-   * @param vel_int 12位整数速度值
-   * @return double 转换后的速度值 (弧度/秒)
-   */
-  static double int_to_velocity(int16_t vel_int);
-
-  /**
-   * @brief 将double KP值转换为12位int
-   * @param kp KP值
-   * @return int16_t 转换后的12位整数
-   */
-  static int16_t kp_to_int(double kp);
-
-  /**
-   * @brief 将12位int KP值转换为double
-   * @param kp_int 12位整数KP值
-   * @return double 转换后的KP值
-   */
-  static double int_to_kp(int16_t kp_int);
-
-  /**
-   * @brief 将double KD值转换为12位int
-   * @param kd KD值
-   * @return int16_t 转换后的12位整数
-   */
-  static int16_t kd_to_int(double kd);
-
-  /**
-   * @brief 将12位int KD值转换为double
-   * @param kd_int 12位整数KD值
-   * @return double 转换后的KD值
-   */
-  static double int_to_kd(int16_t kd_int);
-
-  /**
-   * @brief 将double力矩值转换为12位int
-   * @param torque 力矩值 (N.m)
-   * @return int16_t 转换后的12位整数
-   */
-  static int16_t torque_to_int(double torque);
-
-  /**
-   * @brief 将12位int力矩值转换为double
-   * @param t_int 12位整数力矩值
-   * @return double 转换后的力矩值 (N.m)
-   */
-  static double int_to_torque(int16_t t_int);
-
   /**
    * @brief 打包动态控制数据
    * @param control 控制参数
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <stdint.h>
+
+// 置1时启动阶段运行mit_codec::selfTest()，与原double实现逐帧对比并打印耗时
+#ifndef MIT_CODEC_SELF_TEST
+#define MIT_CODEC_SELF_TEST 0
+#endif
+
+/**
+ * @brief MIT控制帧字段的单精度编解码
+ *
+ * 原实现每个字段按 (x + offset) * max / span 以double计算，ESP32-C3没有
+ * 浮点单元，double运算全部由软件模拟。这里将缩放系数在编译期折算为float，
+ * 编码走一次float乘加；结果距整数边界小于误差保护带时才回退到原double
+ * 公式，因此输出与原实现逐位一致（见selfTest与host/mit_codec_test.cpp），回退概率约为
+ * 位置字段6%、12位字段0.4%。
+ *
+ * 量程外的输入钳位到[0, max]（原实现会回绕为无效编码）。
+ */
+namespace mit_codec {
+
+/**
+ * @brief 字段量程
+ */
+struct Field {
+    double offset;      // 编码前的偏移（与原实现的double常量相同）
+    double span;        // 量程
+    uint32_t max;       // 最大编码值
+    float scale;        // max / span
+    float bias;         // offset * max / span
+    float guard;        // float路径的误差保护带（编码单位）
+    float decode_step;  // 解码：code * decode_step + decode_min
+    float decode_min;
+};
+
+/**
+ * @brief 编译期生成字段描述
+ * @param offset 编码偏移
+ * @param span 量程
+ * @param bits 编码位数
+ * @param decode_gain 解码结果的附加倍数（位置反馈为2）
+ */
+constexpr Field makeField(double offset, double span, int bits,
+                          double decode_gain = 1.0) {
+    return Field{offset,
+                 span,
+                 (1u << bits) - 1,
+                 (float)(((1u << bits) - 1) / span),
+                 (float)(offset * ((1u << bits) - 1) / span),
+                 // 乘加的舍入误差不超过2 ulp(max)，留2倍余量
+                 (float)(4.0 * ((1u << bits) - 1) / (1 << 23)),
+                 (float)(decode_gain * span / ((1u << bits) - 1)),
+                 (float)(-decode_gain * offset)};
+}
+
+// 各字段量程（GIM电驱MIT协议）
+constexpr Field kPosition = makeField(15.91, 31.82, 16, 2.0);
+constexpr Field kVelocity = makeField(82.73, 165.46, 12);
+constexpr Field kKp = makeField(0.0, 500.0, 12);
+constexpr Field kKd = makeField(0.0, 5.0, 12);
+constexpr Field kTorque = makeField(6.24, 12.48, 12);
+
+/**
+ * @brief 原实现的double编码公式
+ * @param f 字段
+ * @param x 物理量
+ * @return uint32_t 编码值
+ */
+inline uint32_t encodeReference(const Field &f, float x) {
+    double t = ((double)x + f.offset) * (double)f.max / f.span;
+    if (!(t > 0.0)) {
+        return 0;
+    }
+    return t >= (double)f.max ? f.max : (uint32_t)t;
+}
+
+/**
+ * @brief 编码
+ * @param f 字段
+ * @param x 物理量
+ * @return uint32_t 编码值，范围[0, max]
+ */
+inline uint32_t encode(const Field &f, float x) {
+    float t = x * f.scale + f.bias;
+    if (!(t > 0.0f)) {
+        return 0;  // 含NaN
+    }
+    if (t >= (float)f.max + 1.0f) {
+        return f.max;
+    }
+    uint32_t q = (uint32_t)t;
+    float frac = t - (float)q;
+    // q为0时真实值必在(-1, 1)内，原实现同样截断为0，无需回退
+    if ((frac < f.guard && q > 0) || frac > 1.0f - f.guard) {
+        return encodeReference(f, x);
+    }
+    return q;
+}
+
+/**
+ * @brief 解码
+ * @param f 字段
+ * @param code 编码值
+ * @return float 物理量
+ */
+inline float decode(const Field &f, uint32_t code) {
+    return (float)code * f.decode_step + f.decode_min;
+}
+
+/**
+ * @brief 打包MIT控制帧数据
+ * @param position 位置 (弧度)
+ * @param velocity 速度 (弧度/秒)
+ * @param kp 位置增益
+ * @param kd 速度增益
+ * @param torque 力矩 (N.m)
+ * @param data 输出：8字节数据
+ */
+inline void packControl(float position, float velocity, float kp, float kd,
+                        float torque, uint8_t data[8]) {
+    uint32_t pos = encode(kPosition, position);
+    uint32_t vel = encode(kVelocity, velocity);
+    uint32_t p = encode(kKp, kp);
+    uint32_t d = encode(kKd, kd);
+    uint32_t t = encode(kTorque, torque);
+
+    // 位置16位；速度、KP、KD、力矩各12位，高位在前
+    data[0] = (uint8_t)(pos >> 8);
+    data[1] = (uint8_t)(pos & 0xFF);
+    data[2] = (uint8_t)(vel >> 4);
+    data[3] = (uint8_t)(((vel & 0x0F) << 4) | ((p >> 8) & 0x0F));
+    data[4] = (uint8_t)(p & 0xFF);
+    data[5] = (uint8_t)(d >> 4);
+    data[6] = (uint8_t)(((d & 0x0F) << 4) | ((t >> 8) & 0x0F));
+    data[7] = (uint8_t)(t & 0xFF);
+}
+
+/**
+ * @brief 与原double实现逐帧对比并测量打包/解包耗时
+ */
+void selfTest();
+
+}  // namespace mit_codec
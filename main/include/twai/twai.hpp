@@ -5,9 +5,43 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <stdint.h>
-#include <mutex>
+#include <atomic>
 #include <esp_event.h>
 
+// 置0时安装全接收过滤器，用于测量硬件过滤器本应滤掉的流量
+// （CanRx统计中的unwanted即为这部分帧）
+#ifndef TWAI_HW_FILTER
+#define TWAI_HW_FILTER 1
+#endif
+
+// 接收与错误路径使用的告警
+#define TWAI_RX_ALERTS                                                  \
+    (TWAI_ALERT_RX_DATA | TWAI_ALERT_RX_QUEUE_FULL |                    \
+     TWAI_ALERT_RX_FIFO_OVERRUN | TWAI_ALERT_ABOVE_ERR_WARN |           \
+     TWAI_ALERT_ERR_PASS | TWAI_ALERT_ERR_ACTIVE | TWAI_ALERT_BUS_OFF | \
+     TWAI_ALERT_BUS_RECOVERED | TWAI_ALERT_BUS_ERROR)
+
+// 发送完成告警，由CanRx转发给CanTx，用于控制驱动发送队列深度
+#define TWAI_TX_ALERTS (TWAI_ALERT_TX_SUCCESS | TWAI_ALERT_TX_FAILED)
+
+// 随总线负载事件发布的节点数上限
+#ifndef TWAI_EVENT_NODE_SLOTS
+#define TWAI_EVENT_NODE_SLOTS 8
+#endif
+
+// 应答往返时间直方图：第i桶上限为TWAI_RTT_BUCKET_BASE_US << i，最后一桶不设上限
+#ifndef TWAI_RTT_BUCKETS
+#define TWAI_RTT_BUCKETS 8
+#endif
+#ifndef TWAI_RTT_BUCKET_BASE_US
+#define TWAI_RTT_BUCKET_BASE_US 250
+#endif
+
+// 节点持续有请求但超过此时间未应答时计一次错误（毫秒）
+#ifndef TWAI_NODE_REPLY_TIMEOUT_MS
+#define TWAI_NODE_REPLY_TIMEOUT_MS 100
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,6 +54,16 @@ typedef enum {
     TWAI_EVENT_BUS_LOAD_UPDATE = 0,
 } twai_event_id_t;
 
+// 单节点统计（节点号为标准帧ID的高6位：ID = node << 5 | cmd）
+typedef struct {
+    uint8_t node;              // 节点号
+    uint32_t txFrames;         // 发往该节点的帧数
+    uint32_t rxFrames;         // 来自该节点的帧数
+    uint32_t errors;           // 发送失败与应答超时次数
+    uint32_t lastSeen;         // 最近一次收到该节点帧的时间戳（毫秒），0为从未收到
+    uint32_t rttHistogram[TWAI_RTT_BUCKETS];  // 请求入队到收到应答的时间分布
+} twai_node_stats_t;
+
 // 总线负载更新事件数据结构
 typedef struct {
     float rxLoad;              // 接收负载率 (0.0-1.0)
@@ -31,6 +75,9 @@ typedef struct {
     uint32_t txBytesCount;     // 发送字节数
     uint32_t bitrate;          // 当前波特率
     uint32_t timestamp;        // 时间戳（毫秒）
+    uint8_t nodeCount;         // nodes中的有效项数
+    uint8_t nodesDropped;      // 超出TWAI_EVENT_NODE_SLOTS未发布的节点数
+    twai_node_stats_t nodes[TWAI_EVENT_NODE_SLOTS];  // 按节点号升序，计数为本窗口
 } twai_bus_load_update_event_data_t;
 
 #ifdef __cplusplus
@@ -64,6 +111,35 @@ inline uint32_t calculate_message_transmission_time(uint32_t bitrate,
   
   return time_us;
 }
+
+/**
+ * @brief 验收过滤器方案
+ */
+struct filter_plan_t {
+  twai_filter_config_t config;
+  uint32_t accepted_ids;  // 过滤器放行的标准帧ID数
+  bool dual;              // 是否使用双过滤器模式
+};
+
+/**
+ * @brief 由需要接收的标准帧ID集合计算验收码/屏蔽码
+ *
+ * 单过滤器取所有ID的公共位；双过滤器按某一ID位把集合分成两组各取公共位，
+ * 在单过滤器和11种分组中选放行ID数最少的方案。RTR和数据字节不参与过滤。
+ *
+ * @param ids 标准帧ID数组（11位）
+ * @param count ID数量，为0时返回全接收
+ * @return filter_plan_t 过滤器方案
+ */
+filter_plan_t plan_acceptance_filter(const uint16_t* ids, size_t count);
+
+/**
+ * @brief 判断标准帧ID能否通过过滤器
+ * @param plan 过滤器方案
+ * @param id 标准帧ID
+ * @return true 放行
+ */
+bool filter_accepts(const filter_plan_t& plan, uint16_t id);
 }
 
 class TWAI {
@@ -73,11 +149,16 @@ class TWAI {
      * @param tx_pin TX引脚 (默认IO3)
      * @param rx_pin RX引脚 (默认IO2)
      * @param bitrate 波特率 (默认500kbps)
+     * @param accept_ids 需要接收的标准帧ID，据此设置硬件验收过滤器
+     *                   （nullptr表示接收全部）
+     * @param accept_count ID数量
      * @return esp_err_t 错误码
      */
     static esp_err_t init(int tx_pin,
                           int rx_pin,
-                          uint32_t bitrate = 500 * 1000);
+                          uint32_t bitrate = 500 * 1000,
+                          const uint16_t* accept_ids = nullptr,
+                          size_t accept_count = 0);
 
     /**
      * @brief 启动TWAI驱动
@@ -112,6 +193,14 @@ class TWAI {
                           bool is_extended = false,
                           int timeout_ms = 20);
 
+    /**
+     * @brief 发送已组好的TWAI帧
+     * @param msg 帧
+     * @param timeout_ms 驱动发送队列满时的等待时间(毫秒)
+     * @return esp_err_t 错误码
+     */
+    static esp_err_t transmit(const twai_message_t& msg, int timeout_ms);
+
     /**
      * @brief 接收TWAI消息
      * @param id 输出参数：接收到的消息ID
@@ -127,6 +216,41 @@ class TWAI {
                              bool* is_extended,
                              int timeout_ms = 1000);
 
+    /**
+     * @brief 等待TWAI告警（TWAI_RX_ALERTS与TWAI_TX_ALERTS中的位）
+     * @param alerts 输出参数：告警位
+     * @param timeout_ms 超时时间(毫秒)
+     * @return esp_err_t 错误码，超时为ESP_ERR_TIMEOUT
+     */
+    static esp_err_t readAlerts(uint32_t* alerts, int timeout_ms);
+
+    /**
+     * @brief 读取驱动状态与错误计数
+     * @param info 输出参数：状态信息
+     * @return esp_err_t 错误码
+     */
+    static esp_err_t getStatus(twai_status_info_t* info);
+
+    /**
+     * @brief 总线关闭后发起恢复（等待128次11个隐性位，完成后产生
+     *        TWAI_ALERT_BUS_RECOVERED，驱动进入停止状态）
+     * @return esp_err_t 错误码
+     */
+    static esp_err_t initiateRecovery();
+
+    /**
+     * @brief 总线恢复后重新启动驱动（保留监控任务与统计）
+     * @return esp_err_t 错误码
+     */
+    static esp_err_t restart();
+
+    /**
+     * @brief 判断ID是否属于初始化时配置的接收集合
+     * @param id 标准帧ID
+     * @return true 属于（未配置集合时总为true）
+     */
+    static bool isWanted(uint32_t id);
+
     /**
      * @brief 检查TWAI是否已初始化
      * @return bool true: 已初始化, false: 未初始化
@@ -158,15 +282,36 @@ class TWAI {
     static bool started;
     static uint32_t current_bitrate;
     static TaskHandle_t bus_load_task_handle;
-    static std::mutex stats_mutex;
+    static uint32_t wanted_ids[2048 / 32];  // 接收集合位图
+    static bool wanted_all;
+
+    /**
+     * @brief 单方向计数：收发路径各字段独立原子累加，监控任务逐个取走清零
+     */
+    struct DirectionCounters {
+        std::atomic<uint32_t> messages{0};
+        std::atomic<uint32_t> bytes{0};
+        std::atomic<uint32_t> bus_time_us{0};  // 帧占用总线时间
+    };
+
+    /**
+     * @brief 单节点计数
+     */
+    struct NodeCounters {
+        std::atomic<uint32_t> tx_frames{0};
+        std::atomic<uint32_t> rx_frames{0};
+        std::atomic<uint32_t> errors{0};
+        std::atomic<uint32_t> last_seen_ms{0};
+        std::atomic<uint32_t> request_us{0};  // 最早未应答请求的入队时刻，0为无
+        std::atomic<uint32_t> rtt[TWAI_RTT_BUCKETS];
+    };
+
+    static constexpr int MAX_NODES = 64;
 
     // 总线负载监控统计变量
-    static uint32_t rx_message_count;
-    static uint32_t tx_message_count;
-    static uint32_t rx_bytes_count;
-    static uint32_t tx_bytes_count;
-    static uint64_t rx_total_transmission_time_us;
-    static uint64_t tx_total_transmission_time_us;
+    static DirectionCounters rx_counters;
+    static DirectionCounters tx_counters;
+    static NodeCounters node_counters[MAX_NODES];
 
     /**
      * @brief 总线负载监控任务
@@ -174,17 +319,23 @@ class TWAI {
      */
     static void busLoadMonitorTask(void* arg);
 
+    /**
+     * @brief 取走各节点本窗口计数并填入事件
+     * @param event 输出参数：总线负载事件
+     */
+    static void collectNodeStats(twai_bus_load_update_event_data_t& event);
+
     /**
      * @brief 更新发送统计信息
-     * @param data_len 数据长度
-     * @param is_extended 是否为扩展帧
+     * @param msg 已入队的帧
+     * @param now_us 当前时间（微秒）
      */
-    static void updateTxStats(uint8_t data_len, bool is_extended);
+    static void updateTxStats(const twai_message_t& msg, int64_t now_us);
 
     /**
      * @brief 更新接收统计信息
-     * @param data_len 数据长度
-     * @param is_extended 是否为扩展帧
+     * @param msg 收到的帧
+     * @param now_us 当前时间（微秒）
      */
-    static void updateRxStats(uint8_t data_len, bool is_extended);
+    static void updateRxStats(const twai_message_t& msg, int64_t now_us);
 };
\ No newline at end of file
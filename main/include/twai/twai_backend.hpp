@@ -0,0 +1,101 @@
+#pragma once
+
+#include <driver/twai.h>
+#include <sdkconfig.h>
+
+// CONFIG_TWAI_SIM：以虚拟总线和模拟MIT电机代替TWAI控制器
+#if defined(CONFIG_TWAI_SIM) && !defined(TWAI_SIM)
+#define TWAI_SIM 1
+#endif
+#ifndef TWAI_SIM
+#define TWAI_SIM 0
+#endif
+
+#if TWAI_SIM
+#include "twai/twai_sim.hpp"
+#endif
+
+/**
+ * @brief TWAI驱动后端
+ *
+ * 编译期选择：TWAI_SIM为0时直接调用ESP-IDF TWAI驱动，为1时转到twai_sim
+ * 虚拟总线。TWAI类只经这里访问驱动，其他模块经TWAI类访问。
+ */
+namespace twai_backend {
+
+inline esp_err_t driver_install(const twai_general_config_t* g_config,
+                                const twai_timing_config_t* t_config,
+                                const twai_filter_config_t* f_config) {
+#if TWAI_SIM
+    return twai_sim::driver_install(g_config, t_config, f_config);
+#else
+    return twai_driver_install(g_config, t_config, f_config);
+#endif
+}
+
+inline esp_err_t driver_uninstall() {
+#if TWAI_SIM
+    return twai_sim::driver_uninstall();
+#else
+    return twai_driver_uninstall();
+#endif
+}
+
+inline esp_err_t start() {
+#if TWAI_SIM
+    return twai_sim::start();
+#else
+    return twai_start();
+#endif
+}
+
+inline esp_err_t stop() {
+#if TWAI_SIM
+    return twai_sim::stop();
+#else
+    return twai_stop();
+#endif
+}
+
+inline esp_err_t transmit(const twai_message_t* message,
+                          TickType_t ticks_to_wait) {
+#if TWAI_SIM
+    return twai_sim::transmit(message, ticks_to_wait);
+#else
+    return twai_transmit(message, ticks_to_wait);
+#endif
+}
+
+inline esp_err_t receive(twai_message_t* message, TickType_t ticks_to_wait) {
+#if TWAI_SIM
+    return twai_sim::receive(message, ticks_to_wait);
+#else
+    return twai_receive(message, ticks_to_wait);
+#endif
+}
+
+inline esp_err_t read_alerts(uint32_t* alerts, TickType_t ticks_to_wait) {
+#if TWAI_SIM
+    return twai_sim::read_alerts(alerts, ticks_to_wait);
+#else
+    return twai_read_alerts(alerts, ticks_to_wait);
+#endif
+}
+
+inline esp_err_t initiate_recovery() {
+#if TWAI_SIM
+    return twai_sim::initiate_recovery();
+#else
+    return twai_initiate_recovery();
+#endif
+}
+
+inline esp_err_t get_status_info(twai_status_info_t* status_info) {
+#if TWAI_SIM
+    return twai_sim::get_status_info(status_info);
+#else
+    return twai_get_status_info(status_info);
+#endif
+}
+
+}  // namespace twai_backend
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <driver/twai.h>
+#include <esp_err.h>
+#include <stdint.h>
+
+// 模拟电机的节点掩码（第n位对应节点n），默认节点1~6
+#ifndef TWAI_SIM_NODE_MASK
+#define TWAI_SIM_NODE_MASK 0x7Eull
+#endif
+
+// 电机应答延迟（微秒），从请求帧在总线上发完算起
+#ifndef TWAI_SIM_REPLY_US
+#define TWAI_SIM_REPLY_US 150
+#endif
+
+// 电机轴转动惯量（kg·m²）与粘性阻尼（N·m·s/rad）
+#ifndef TWAI_SIM_INERTIA
+#define TWAI_SIM_INERTIA 0.002f
+#endif
+#ifndef TWAI_SIM_DAMPING
+#define TWAI_SIM_DAMPING 0.01f
+#endif
+
+// 动力学积分步长（微秒）
+#ifndef TWAI_SIM_STEP_US
+#define TWAI_SIM_STEP_US 100
+#endif
+
+// 虚拟总线任务优先级，与驱动中断处理同样先于CAN收发任务（6）
+#ifndef TWAI_SIM_TASK_PRIORITY
+#define TWAI_SIM_TASK_PRIORITY 7
+#endif
+
+// 统计打印间隔（毫秒）
+#ifndef TWAI_SIM_REPORT_MS
+#define TWAI_SIM_REPORT_MS 5000
+#endif
+
+/**
+ * @brief 虚拟CAN总线与模拟MIT电机
+ *
+ * 接口与ESP-IDF TWAI驱动一一对应（见twai_backend.hpp），开启CONFIG_TWAI_SIM后
+ * TWAI类的所有驱动调用都转到这里，MIT/CanTx/CanRx/SR6CANExecutor无需改动即可
+ * 在没有收发器和电机的情况下端到端运行。只依赖FreeRTOS与esp_timer，主机上
+ * 的端到端仿真见host/sr6can_sim.cpp。
+ *
+ * 总线：请求帧与电机应答按就绪先后串行占用虚拟总线，每帧占用帧长
+ * （calculate_message_transmission_time），因此吞吐受波特率限制；与控制器一样，
+ * 发送队列队首装入发送缓冲，发完且被ACK后才产生TX_SUCCESS并释放，无ACK时在
+ * 错误帧后自动重发。应答在请求发完TWAI_SIM_REPLY_US后就绪，发完后经验收过滤器
+ * 进入接收队列，接收队列满时计为rx_missed。
+ *
+ * 电机：每个节点一个二阶模型，J·a = kp·(p_ref - p) + kd·(v_ref - v) + t_ff
+ * - c·v，在收到帧时积分到当前时间。应答：
+ * - CMD_MIT_CONTROL：状态帧（位置/速度/力矩，与MIT::unpack_status_data对应）
+ * - CMD_GET_ERROR：异常代码（大端8字节）
+ * - CMD_GET_ENCODER_ESTIMATES（远程帧）：位置、速度各为小端float
+ * - CMD_CLEAR_ERRORS：清除异常并应答
+ * - CMD_SET_AXIS_STATE：切换轴状态，不应答
+ *
+ * 故障注入：setNodeOnline()模拟节点掉线（该节点不再应答；所有节点都掉线时
+ * 帧无ACK，发送错误计数上升至错误被动，任一节点上线后重发成功即回落），
+ * setNodeFault()模拟电机异常（力矩输出为0），injectBusOff()模拟总线关闭
+ * （需initiate_recovery恢复）。
+ */
+namespace twai_sim {
+
+/**
+ * @brief 累计统计窗口
+ */
+struct Stats {
+    uint32_t tx_frames;      // 上总线的请求帧
+    uint32_t replies;        // 电机应答帧
+    uint32_t unacked;        // 无节点应答的帧
+    uint32_t filtered;       // 被验收过滤器丢弃的应答
+    uint32_t rx_missed;      // 接收队列满丢弃的应答
+    uint32_t tx_queue_max;   // 发送队列最大深度
+    uint64_t busy_us;        // 虚拟总线占用时间
+    uint64_t rtt_sum_us;     // 请求入队到应答入接收队列
+    uint32_t rtt_max_us;
+};
+
+// 与TWAI驱动同名同义的接口
+esp_err_t driver_install(const twai_general_config_t* g_config,
+                         const twai_timing_config_t* t_config,
+                         const twai_filter_config_t* f_config);
+esp_err_t driver_uninstall();
+esp_err_t start();
+esp_err_t stop();
+esp_err_t transmit(const twai_message_t* message, TickType_t ticks_to_wait);
+esp_err_t receive(twai_message_t* message, TickType_t ticks_to_wait);
+esp_err_t read_alerts(uint32_t* alerts, TickType_t ticks_to_wait);
+esp_err_t initiate_recovery();
+esp_err_t get_status_info(twai_status_info_t* status_info);
+
+/**
+ * @brief 模拟节点上线/掉线
+ * @param node 节点ID
+ * @param online false时该节点不再应答，上线后以复位状态（空闲、原位）应答
+ */
+void setNodeOnline(uint8_t node, bool online);
+
+/**
+ * @brief 设置节点异常代码（GET_ERROR返回，CLEAR_ERRORS清除）
+ * @param node 节点ID
+ * @param fault_code 异常代码
+ */
+void setNodeFault(uint8_t node, uint64_t fault_code);
+
+/**
+ * @brief 使控制器立即进入总线关闭状态
+ */
+void injectBusOff();
+
+/**
+ * @brief 读取模拟电机当前位置（弧度）
+ * @param node 节点ID
+ * @return float 位置，节点不存在时为NaN
+ */
+float nodePosition(uint8_t node);
+
+/**
+ * @brief 取出并清零统计窗口
+ * @return Stats 统计数据
+ */
+Stats takeStats();
+
+}  // namespace twai_sim
@@ -60,6 +60,44 @@ void axis7_to_axis6(float x7, float y7, float z7, float roll7, float pitch7,
                     float twist7, float& x6, float& y6, float& z6, float& roll6,
                     float& pitch6, float& twist6);
 
+/**
+ * @brief axis7_to_axis6的闭式特化版本（twist7恒为0）
+ *
+ * twist为0时旋转矩阵退化为 Rz(pitch)·Rx(roll)，欧拉角原样返回（归一化到
+ * (-180, 180]），位置只需减去扩展臂在y轴方向旋转后的分量；EXTENSION_LENGTH
+ * 为0时编译期折叠为直接拷贝，不调用任何三角函数。
+ * 参数含义与axis7_to_axis6相同（twist6恒为0，因此省略）。
+ * host/axis7_test.cpp对比两者（含非0的EXTENSION_LENGTH）。
+ */
+inline void axis7_to_axis6_no_twist(float x7, float y7, float z7, float roll7,
+                                    float pitch7, float& x6, float& y6,
+                                    float& z6, float& roll6, float& pitch6) {
+    constexpr float extension = EXTENSION_LENGTH;
+    if (extension != 0.0f) {
+        float roll = roll7 * (float)M_PI / 180.0f;
+        float pitch = pitch7 * (float)M_PI / 180.0f;
+        float cos_roll = cosf(roll);
+        // T_6 = T_7 @ Trans(0, -L, 0)：位置减去旋转矩阵第二列乘以L
+        x6 = x7 + extension * sinf(pitch) * cos_roll;
+        y6 = y7 - extension * cosf(pitch) * cos_roll;
+        z6 = z7 - extension * sinf(roll);
+    } else {
+        x6 = x7;
+        y6 = y7;
+        z6 = z7;
+    }
+
+    // atan2还原的角度范围为(-180, 180]
+    auto wrap = [](float deg) {
+        if (deg > 180.0f || deg <= -180.0f) {
+            deg -= 360.0f * ceilf((deg - 180.0f) / 360.0f);
+        }
+        return deg;
+    };
+    roll6 = wrap(roll7);
+    pitch6 = wrap(pitch7);
+}
+
 /**
  * @brief 获取构建参数JSON字符串
  * @return 返回包含固件版本、构建时间、硬件信息和编译选项的JSON字符串
@@ -0,0 +1,169 @@
+#include "actuator/actuator_bank.hpp"
+#include "actuator/ledc_actuator.hpp"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <memory>
+#include <stdexcept>
+
+static const char* TAG = "ActuatorBank";
+
+namespace actuator {
+
+ActuatorBank::ActuatorBank() : m_lanes{} {
+    ESP_LOGI(TAG, "LEDC dither %s", LEDC_DUTY_DITHER ? "on" : "off");
+}
+
+ActuatorBank::~ActuatorBank() {
+    for (auto& lane : m_lanes) {
+        if (lane.enabled) {
+            ledc_stop(LEDC_LOW_SPEED_MODE, lane.channel, 0);
+        }
+    }
+    ESP_LOGI(TAG, "Actuator bank deinitialized");
+}
+
+void ActuatorBank::addLane(size_t lane, int gpio_num, ledc_channel_t channel,
+                           uint32_t freq_hz, float offset) {
+    if (lane >= MAX_LANES) {
+        ESP_LOGE(TAG, "Invalid lane %u", (unsigned)lane);
+        throw std::runtime_error("Invalid actuator bank lane");
+    }
+    if (gpio_num < 0) {
+        m_lanes[lane].enabled = false;
+        return;
+    }
+    if (freq_hz < 50 || freq_hz > 333) {
+        ESP_LOGE(TAG,
+                 "Lane %u: invalid frequency %luHz, must be between 50Hz and "
+                 "333Hz",
+                 (unsigned)lane, (unsigned long)freq_hz);
+        throw std::runtime_error(
+            "Invalid frequency, must be between 50Hz and 333Hz");
+    }
+
+    // 同频率的通道共用一个定时器
+    LedcTimerSlot slot = m_timers.acquire(freq_hz);
+
+    ledc_channel_config_t channel_conf = {
+        .gpio_num = gpio_num,
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .channel = channel,
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = slot.timer,
+        .duty = 0,
+        .hpoint = 0,
+        .flags = {.output_invert = 0}};
+    esp_err_t ret = ledc_channel_config(&channel_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "LEDC channel config failed: %s", esp_err_to_name(ret));
+        throw std::runtime_error("LEDC channel config failed");
+    }
+
+    // 错相：脉冲起点后移，最长脉冲（2500us）仍须在周期内结束
+    uint32_t duty_limit = (1u << slot.resolution) - 1;
+    uint32_t hpoint = (uint32_t)((uint64_t)lane * ACTUATOR_BANK_STAGGER_US *
+                                 duty_limit * freq_hz / 1000000);
+    uint32_t max_pulse =
+        (uint32_t)((uint64_t)2500 * duty_limit * freq_hz / 1000000);
+    if (hpoint + max_pulse >= duty_limit) {
+        ESP_LOGW(TAG, "Lane %u stagger does not fit in the period, disabled",
+                 (unsigned)lane);
+        hpoint = 0;
+    }
+
+    m_lanes[lane] = {.enabled = true,
+                     .channel = channel,
+                     .offset = offset,
+                     .target = 0.0f,
+                     .residual = 0,
+                     .hpoint = hpoint,
+                     .mapper = LedcDutyMapper(freq_hz, slot.resolution)};
+    ESP_LOGI(TAG,
+             "Lane %u bound to GPIO %d, channel %d, timer %d (%luHz, step %lu "
+             "ns), offset: %.3f, hpoint %lu",
+             (unsigned)lane, gpio_num, channel, slot.timer,
+             (unsigned long)freq_hz,
+             (unsigned long)m_lanes[lane].mapper.stepNs(freq_hz), offset,
+             (unsigned long)hpoint);
+}
+
+void ActuatorBank::setTargets(const float* targets, size_t count) {
+    if (count > MAX_LANES) {
+        count = MAX_LANES;
+    }
+
+    // 第一遍：写入所有通道的占空比（尚未生效）
+    for (size_t i = 0; i < count; i++) {
+        Lane& lane = m_lanes[i];
+        if (!lane.enabled) {
+            continue;
+        }
+        float target = targets[i] + lane.offset;
+        if (target < -1.0f) {
+            target = -1.0f;
+        } else if (target > 1.0f) {
+            target = 1.0f;
+        }
+        lane.target = target;
+
+        uint32_t duty = lane.mapper.toDuty(target, lane.residual);
+        ledc_set_duty_with_hpoint(LEDC_LOW_SPEED_MODE, lane.channel, duty,
+                                  lane.hpoint);
+    }
+
+    // 第二遍：集中触发更新，所有通道在下一个周期边界同时生效
+    for (size_t i = 0; i < count; i++) {
+        if (m_lanes[i].enabled) {
+            ledc_update_duty(LEDC_LOW_SPEED_MODE, m_lanes[i].channel);
+        }
+    }
+}
+
+void benchmarkActuatorBank(const int gpio_nums[ActuatorBank::MAX_LANES],
+                           uint32_t freq_hz) {
+    constexpr int kIterations = 1000;
+    float targets[ActuatorBank::MAX_LANES];
+
+    // 逐通道路径：LEDCActuator::setTarget（虚函数+逐通道加锁+逐通道更新）
+    int64_t single_us = 0;
+    {
+        std::unique_ptr<Actuator> servos[ActuatorBank::MAX_LANES];
+        for (size_t i = 0; i < ActuatorBank::MAX_LANES; i++) {
+            if (gpio_nums[i] >= 0) {
+                servos[i] = std::make_unique<LEDCActuator>(
+                    gpio_nums[i], (ledc_channel_t)i, LEDC_TIMER_0, freq_hz);
+            }
+        }
+        int64_t start = esp_timer_get_time();
+        for (int n = 0; n < kIterations; n++) {
+            for (size_t i = 0; i < ActuatorBank::MAX_LANES; i++) {
+                if (servos[i]) {
+                    servos[i]->setTarget((n % 200 - 100) / 100.0f);
+                }
+            }
+        }
+        single_us = esp_timer_get_time() - start;
+    }
+
+    // 批量路径：ActuatorBank::setTargets
+    int64_t bank_us = 0;
+    {
+        ActuatorBank bank;
+        for (size_t i = 0; i < ActuatorBank::MAX_LANES; i++) {
+            bank.addLane(i, gpio_nums[i], (ledc_channel_t)i, freq_hz);
+        }
+        int64_t start = esp_timer_get_time();
+        for (int n = 0; n < kIterations; n++) {
+            for (size_t i = 0; i < ActuatorBank::MAX_LANES; i++) {
+                targets[i] = (n % 200 - 100) / 100.0f;
+            }
+            bank.setTargets(targets, ActuatorBank::MAX_LANES);
+        }
+        bank_us = esp_timer_get_time() - start;
+    }
+
+    ESP_LOGI(TAG, "per tick (6 lanes): LEDCActuator %.2f us, ActuatorBank %.2f us",
+             (float)single_us / kIterations, (float)bank_us / kIterations);
+}
+
+}  // namespace actuator
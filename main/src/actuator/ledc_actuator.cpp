@@ -11,8 +11,10 @@ LEDCActuator::LEDCActuator(int gpio_num,
                            ledc_channel_t channel,
                            ledc_timer_t timer,
                            uint32_t freq_hz,
-                           float offset)
-    : Actuator(offset), m_gpio_num(gpio_num), m_channel(channel), m_timer(timer), m_freq_hz(freq_hz) {
+                           float offset,
+                           ledc_timer_bit_t resolution)
+    : Actuator(offset), m_gpio_num(gpio_num), m_channel(channel), m_timer(timer), m_freq_hz(freq_hz),
+      m_duty_resolution(resolution), m_duty_mapper(freq_hz, resolution) {
     if (freq_hz < 50 || freq_hz > 333) {
         ESP_LOGE(TAG, "Invalid frequency %dHz, must be between 50Hz and 333Hz",
                  freq_hz);
@@ -118,40 +120,4 @@ bool LEDCActuator::actuate(int wait) {
     return true;
 }
 
-uint32_t LEDCActuator::targetToDuty(float target) {
-    // 将-1到1的输入映射到500-2500us的高电平持续时间
-    // PWM周期 = 1/freq_hz (秒)
-    // 高电平时间范围：500us到2500us
-    // 占空比 = 高电平时间 / PWM周期
-
-    float period_us = 1000000.0f / m_freq_hz;  // PWM周期(微秒)
-    float pulse_width_us;                      // 高电平持续时间(微秒)
-
-    // 线性映射：-1 -> 500us, 0 -> 1500us, 1 -> 2500us
-    // 公式：pulse_width = 1500 + target * 1000
-    pulse_width_us = 1500.0f + target * 1000.0f;
-
-    // 限制范围在500-2500us之间
-    if (pulse_width_us < 500.0f) {
-        pulse_width_us = 500.0f;
-    } else if (pulse_width_us > 2500.0f) {
-        pulse_width_us = 2500.0f;
-    }
-
-    // 计算占空比值
-    // duty = (pulse_width_us / period_us) * (2^resolution - 1)
-    float duty_float =
-        (pulse_width_us / period_us) * ((1 << m_duty_resolution) - 1);
-
-    // 限制在有效范围内
-    uint32_t max_duty = (1 << m_duty_resolution) - 1;
-    if (duty_float < 0) {
-        duty_float = 0;
-    } else if (duty_float > max_duty) {
-        duty_float = max_duty;
-    }
-
-    return static_cast<uint32_t>(duty_float);
-}
-
 }  // namespace actuator
\ No newline at end of file
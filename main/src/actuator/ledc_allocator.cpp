@@ -0,0 +1,86 @@
+#include "actuator/ledc_allocator.hpp"
+#include <esp_log.h>
+#include <stdexcept>
+#include <string>
+#include "soc/soc.h"
+#include "soc/soc_caps.h"
+
+static const char* TAG = "LedcAllocator";
+
+namespace actuator {
+
+namespace {
+// 舵机脉宽换算至少需要的分辨率（50Hz下约20us/步）
+constexpr uint32_t MIN_RESOLUTION_BITS = 10;
+// 分频器整数部分的上限（10位整数+8位小数）
+constexpr uint32_t MAX_CLOCK_DIVIDER = 1023;
+}  // namespace
+
+uint32_t LedcTimerAllocator::bestResolution(uint32_t freq_hz) {
+    if (freq_hz == 0) {
+        return 0;
+    }
+    // LEDC_AUTO_CLK在舵机频率下选择APB时钟
+    for (uint32_t bits = SOC_LEDC_TIMER_BIT_WIDTH; bits >= MIN_RESOLUTION_BITS;
+         bits--) {
+        uint64_t counts = (uint64_t)freq_hz << bits;
+        if (counts > APB_CLK_FREQ) {
+            continue;  // 分频系数小于1，分辨率过高
+        }
+        if (APB_CLK_FREQ / counts > MAX_CLOCK_DIVIDER) {
+            return 0;  // 分辨率再降分频系数只会更大
+        }
+        return bits;
+    }
+    return 0;
+}
+
+LedcTimerSlot LedcTimerAllocator::acquire(uint32_t freq_hz) {
+    for (size_t i = 0; i < m_used; i++) {
+        if (m_slots[i].freq_hz == freq_hz) {
+            return m_slots[i];
+        }
+    }
+
+    uint32_t bits = bestResolution(freq_hz);
+    if (bits == 0) {
+        ESP_LOGE(TAG, "%luHz cannot be generated by LEDC", (unsigned long)freq_hz);
+        throw std::runtime_error("LEDC frequency out of range");
+    }
+
+    if (m_used >= MAX_TIMERS) {
+        std::string used;
+        for (size_t i = 0; i < m_used; i++) {
+            used += std::to_string(m_slots[i].freq_hz) + "Hz ";
+        }
+        ESP_LOGE(TAG,
+                 "No free LEDC timer for %luHz, all %u timers in use: %s",
+                 (unsigned long)freq_hz, (unsigned)MAX_TIMERS, used.c_str());
+        throw std::runtime_error("Too many distinct servo PWM frequencies");
+    }
+
+    LedcTimerSlot slot = {.timer = (ledc_timer_t)m_used,
+                          .resolution = (ledc_timer_bit_t)bits,
+                          .freq_hz = freq_hz};
+    ledc_timer_config_t timer_conf = {
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .duty_resolution = slot.resolution,
+        .timer_num = slot.timer,
+        .freq_hz = freq_hz,
+        .clk_cfg = LEDC_AUTO_CLK,
+        .deconfigure = false,
+    };
+    esp_err_t ret = ledc_timer_config(&timer_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "LEDC timer %d config failed: %s", slot.timer,
+                 esp_err_to_name(ret));
+        throw std::runtime_error("LEDC timer config failed");
+    }
+
+    m_slots[m_used++] = slot;
+    ESP_LOGI(TAG, "Timer %d: %luHz, %lu bit", slot.timer,
+             (unsigned long)freq_hz, (unsigned long)bits);
+    return slot;
+}
+
+}  // namespace actuator
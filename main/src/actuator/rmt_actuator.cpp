@@ -1,6 +1,8 @@
 #include "actuator/rmt_actuator.hpp"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
+#include "soc/rmt_struct.h"
 #include <esp_log.h>
 #include <mutex>
 #include <stdexcept>
@@ -13,8 +15,16 @@ static const char *TAG = "RMTActuator";
 
 namespace actuator {
 
-RMTActuator::RMTActuator(int gpio_num, float offset)
+RMTActuator::RMTActuator(int gpio_num, float offset, uint32_t freq_hz)
     : Actuator(offset), m_gpio_num(gpio_num) {
+  if (freq_hz < 50 || freq_hz > 333) {
+    ESP_LOGE(TAG, "Invalid frequency %luHz, must be between 50Hz and 333Hz",
+             (unsigned long)freq_hz);
+    throw std::runtime_error(
+        "Invalid frequency, must be between 50Hz and 333Hz");
+  }
+  m_period_us = 1000000 / freq_hz;
+
   // 初始化RMT
   if (!initRMT()) {
     ESP_LOGE(TAG, "Failed to initialize RMT actuator");
@@ -68,6 +78,7 @@ bool RMTActuator::initRMT() {
   // 配置简单编码器
   rmt_simple_encoder_config_t encoder_config = {
       .callback = rmt_encoder_cb, // 编码器回调函数
+      .arg = this,                // 回调中记录循环符号在通道RAM中的地址
       .min_chunk_size = 1         // 最小块大小，至少需要1个符号(高电平和低电平)
   };
 
@@ -86,18 +97,55 @@ bool RMTActuator::initRMT() {
   }
 
   // 配置传输参数
-  m_tx_config = {.loop_count = 0, // 不循环
+  m_tx_config = {.loop_count = RMT_ACTUATOR_LOOP ? -1 : 0, // 循环模式无限循环
                  .flags = {
                      .eot_level = 0,        // 传输结束后输出低电平
                      .queue_nonblocking = 0 // 阻塞模式，如果队列满了则等待
                  }};
 
-  // 保存通道句柄以便后续使用
-  // 由于类定义中没有保存通道句柄的成员，我们需要添加一个
-  // 但为了不修改头文件，我们可以使用静态变量或其他方法
-  // 这里我们暂时不保存，因为actuate方法中可能不需要
-
   m_initialized = true;
+
+#if RMT_ACTUATOR_LOOP
+  // 从中位开始持续输出
+  m_pulse_width = targetToPulseWidth(0.0f);
+  if (!restartLoop()) {
+    return false;
+  }
+  ESP_LOGI(TAG, "Looping %lu us period, in-place update %s",
+           (unsigned long)m_period_us, m_hw_symbol ? "enabled" : "disabled");
+#endif
+  return true;
+}
+
+bool RMTActuator::restartLoop() {
+  esp_err_t ret;
+  if (m_loop_start_us != 0) {
+    // 只在低电平段停止，避免截断当前周期的高电平（最长2500us）；处于高电平段
+    // 时推迟到下一次actuate，不在执行器任务中忙等。停止后重新开始会缩短这一个
+    // 周期，舵机只关心脉宽，不受影响
+    constexpr uint32_t kPulseGuardUs = 2500 + 20;
+    uint32_t phase = (esp_timer_get_time() - m_loop_start_us) % m_period_us;
+    if (phase < kPulseGuardUs) {
+      m_restart_pending = true;
+      return true;
+    }
+    m_restart_pending = false;
+    rmt_disable(m_tx_channel);
+    ret = rmt_enable(m_tx_channel);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to enable RMT channel: %s", esp_err_to_name(ret));
+      return false;
+    }
+  }
+
+  m_hw_symbol = nullptr;
+  ret = rmt_transmit(m_tx_channel, m_encoder, &m_pulse_width,
+                     sizeof(m_pulse_width), &m_tx_config);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to transmit RMT data: %s", esp_err_to_name(ret));
+    return false;
+  }
+  m_loop_start_us = esp_timer_get_time();
   return true;
 }
 
@@ -132,6 +180,20 @@ bool RMTActuator::actuate(int wait) {
   // 将目标值转换为脉冲宽度
   uint32_t pulse_width = targetToPulseWidth(target);
 
+#if RMT_ACTUATOR_LOOP
+  // 硬件持续循环输出，脉宽不变且没有推迟的重启时无需任何操作
+  (void)wait;
+  if (pulse_width == m_pulse_width && !m_restart_pending) {
+    return true;
+  }
+  m_pulse_width = pulse_width;
+  if (m_hw_symbol) {
+    // 单次32位写入，硬件在下一个周期读取到新的符号
+    *m_hw_symbol = makeSymbol(pulse_width, m_period_us - pulse_width);
+    return true;
+  }
+  return restartLoop();
+#else
   // 传输脉冲宽度数据
   esp_err_t ret = rmt_transmit(m_tx_channel, m_encoder, &pulse_width,
                                sizeof(pulse_width), &m_tx_config);
@@ -152,6 +214,7 @@ bool RMTActuator::actuate(int wait) {
 
   ESP_LOGD(TAG, "Set target %.2f to pulse width %u us", target, pulse_width);
   return true;
+#endif
 }
 
 uint32_t RMTActuator::targetToPulseWidth(float target) {
@@ -175,7 +238,7 @@ size_t RMTActuator::rmt_encoder_cb(const void *data, size_t data_size,
                                    rmt_symbol_word_t *symbols, bool *done,
                                    void *arg) {
   // 获取当前对象的指针
-  // RMTActuator *actuator = static_cast<RMTActuator *>(arg);
+  RMTActuator *actuator = static_cast<RMTActuator *>(arg);
 
   // 检查数据大小是否正确
   if (data_size != sizeof(uint32_t)) {
@@ -200,17 +263,24 @@ size_t RMTActuator::rmt_encoder_cb(const void *data, size_t data_size,
   // 使用 uint64_t 避免溢出：pulse_width * 10,000,000 / 1,000,000 = pulse_width
   // * 10
   uint16_t high_ticks = pulse_width;
-  uint16_t low_ticks = 0; // 低电平固定500us
-  // uint16_t high_ticks = 10000;
-  // uint16_t low_ticks = 20000;
-  // 合成uint32_t值后一次性赋值
-  // 位域布局: duration0(15bits) | level0(1bit) | duration1(15bits) |
-  // level1(1bit)
-  symbols[symbols_written].val =
-      (high_ticks & 0x7FFF) | // duration0: bits 0-14
-      (1 << 15) |             // level0: bit 15 = 1 (高电平)
-      ((low_ticks & 0x7FFF)
-       << 16); // duration1: bits 16-30, level1: bit 31 = 0 (低电平)
+#if RMT_ACTUATOR_LOOP
+  // 低电平补足整个周期，循环发送即为连续PWM
+  uint16_t low_ticks = actuator->m_period_us - pulse_width;
+#else
+  uint16_t low_ticks = 0; // 0即结束标志，单次只输出一个脉冲
+#endif
+  symbols[symbols_written].val = makeSymbol(high_ticks, low_ticks);
+
+#if RMT_ACTUATOR_LOOP
+  // 非DMA模式下符号直接写在通道RAM里，记录地址以便原位更新脉宽
+  const uintptr_t addr = reinterpret_cast<uintptr_t>(&symbols[symbols_written]);
+  const uintptr_t mem_begin = reinterpret_cast<uintptr_t>(&RMTMEM);
+  if (addr >= mem_begin && addr < mem_begin + sizeof(RMTMEM)) {
+    actuator->m_hw_symbol = reinterpret_cast<volatile uint32_t *>(addr);
+  }
+#else
+  (void)actuator;
+#endif
   // static int t = 0;
   // if (t++ % 50 == 0) {
   //   ESP_LOGI(TAG, "Encoded pulse width %u us to %hu high ticks and %hu low
@@ -0,0 +1,303 @@
+#include "actuator/rmt_servo_bank.hpp"
+#include "esp_timer.h"
+#include "soc/rmt_struct.h"
+#include <esp_log.h>
+#include <stdexcept>
+
+static const char *TAG = "RMTServoBank";
+
+namespace actuator {
+
+namespace {
+constexpr uint32_t kMinPulseUs = 500;
+constexpr uint32_t kMaxPulseUs = 2500;
+constexpr uint32_t kCenterPulseUs = 1500;
+constexpr uint32_t kPulseGuardUs = 20;
+
+inline rmt_symbol_word_t makeSymbol(uint32_t level0, uint32_t duration0,
+                                    uint32_t level1, uint32_t duration1) {
+  rmt_symbol_word_t symbol;
+  symbol.val = (duration0 & 0x7FFF) | (level0 << 15) |
+               ((duration1 & 0x7FFF) << 16) | (level1 << 31);
+  return symbol;
+}
+} // namespace
+
+RMTServoBank::RMTServoBank(const int *gpio_nums, const float *offsets,
+                           size_t count, uint32_t freq_hz, uint32_t stagger_us)
+    : m_lanes{} {
+  if (count == 0 || count > MAX_LANES) {
+    ESP_LOGE(TAG, "Invalid lane count %u, must be 1-%u", (unsigned)count,
+             (unsigned)MAX_LANES);
+    throw std::runtime_error("Invalid RMT servo bank lane count");
+  }
+  if (freq_hz < 50 || freq_hz > 333) {
+    ESP_LOGE(TAG, "Invalid frequency %luHz, must be between 50Hz and 333Hz",
+             (unsigned long)freq_hz);
+    throw std::runtime_error(
+        "Invalid frequency, must be between 50Hz and 333Hz");
+  }
+  m_period_us = 1000000 / freq_hz;
+
+  // 最后一个通道的脉冲也必须在周期内结束
+  if ((count - 1) * stagger_us + kMaxPulseUs + kPulseGuardUs > m_period_us) {
+    ESP_LOGW(TAG, "Stagger %luus does not fit in %luus period, disabled",
+             (unsigned long)stagger_us, (unsigned long)m_period_us);
+    stagger_us = 0;
+  }
+
+  try {
+    for (size_t i = 0; i < count; i++) {
+      Lane &lane = m_lanes[i];
+      lane.offset = offsets[i];
+      lane.pulse_us = kCenterPulseUs;
+      lane.delay_us = i * stagger_us;
+      encodeLane(lane);
+
+      rmt_tx_channel_config_t tx_channel_config = {
+          .gpio_num = static_cast<gpio_num_t>(gpio_nums[i]),
+          .clk_src = RMT_CLK_SRC_DEFAULT,
+          .resolution_hz = 1000 * 1000, // 1MHz，1 tick = 1us
+          .mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL,
+          .trans_queue_depth = 1,
+          .intr_priority = 0,
+          .flags = {.invert_out = 0,
+                    .with_dma = 0,
+                    .io_loop_back = 0,
+                    .io_od_mode = 0,
+                    .allow_pd = 0}};
+      esp_err_t ret = rmt_new_tx_channel(&tx_channel_config, &lane.channel);
+      if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create RMT TX channel: %s",
+                 esp_err_to_name(ret));
+        throw std::runtime_error("Failed to create RMT TX channel");
+      }
+      m_count = i + 1;
+
+      rmt_simple_encoder_config_t encoder_config = {
+          .callback = encoderCallback, .arg = &lane, .min_chunk_size = 2};
+      ret = rmt_new_simple_encoder(&encoder_config, &lane.encoder);
+      if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create RMT encoder: %s",
+                 esp_err_to_name(ret));
+        throw std::runtime_error("Failed to create RMT encoder");
+      }
+
+      ret = rmt_enable(lane.channel);
+      if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to enable RMT channel: %s",
+                 esp_err_to_name(ret));
+        throw std::runtime_error("Failed to enable RMT channel");
+      }
+    }
+
+    // 单通道无需同步
+    if (m_count > 1) {
+      rmt_channel_handle_t channels[MAX_LANES];
+      for (size_t i = 0; i < m_count; i++) {
+        channels[i] = m_lanes[i].channel;
+      }
+      rmt_sync_manager_config_t sync_config = {.tx_channel_array = channels,
+                                               .array_size = m_count};
+      esp_err_t ret = rmt_new_sync_manager(&sync_config, &m_sync);
+      if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create RMT sync manager: %s",
+                 esp_err_to_name(ret));
+        throw std::runtime_error("Failed to create RMT sync manager");
+      }
+    }
+
+    if (!start()) {
+      throw std::runtime_error("Failed to start RMT servo bank");
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+
+  for (size_t i = 0; i < m_count; i++) {
+    ESP_LOGI(TAG, "Lane %u on GPIO %d, offset: %.3f, delay %luus, in-place "
+                  "update %s",
+             (unsigned)i, gpio_nums[i], m_lanes[i].offset,
+             (unsigned long)m_lanes[i].delay_us,
+             m_lanes[i].hw_symbols ? "enabled" : "disabled");
+  }
+}
+
+RMTServoBank::~RMTServoBank() {
+  release();
+  ESP_LOGI(TAG, "RMT servo bank deinitialized");
+}
+
+void RMTServoBank::release() {
+  for (size_t i = 0; i < m_count; i++) {
+    if (m_lanes[i].channel) {
+      rmt_disable(m_lanes[i].channel);
+    }
+  }
+  if (m_sync) {
+    rmt_del_sync_manager(m_sync);
+    m_sync = nullptr;
+  }
+  for (size_t i = 0; i < m_count; i++) {
+    Lane &lane = m_lanes[i];
+    if (lane.encoder) {
+      rmt_del_encoder(lane.encoder);
+      lane.encoder = nullptr;
+    }
+    if (lane.channel) {
+      rmt_del_channel(lane.channel);
+      lane.channel = nullptr;
+    }
+  }
+  m_count = 0;
+}
+
+void RMTServoBank::encodeLane(Lane &lane) const {
+  uint32_t low_us = m_period_us - lane.delay_us - lane.pulse_us;
+  if (lane.delay_us == 0) {
+    // 高电平脉宽 + 低电平补足周期
+    lane.symbols[0] = makeSymbol(1, lane.pulse_us, 0, low_us);
+    lane.symbol_count = 1;
+  } else {
+    // 低电平延时 + 高电平脉宽，剩余低电平拆成两段（时长不能为0，0是结束标志）
+    lane.symbols[0] = makeSymbol(0, lane.delay_us, 1, lane.pulse_us);
+    lane.symbols[1] = makeSymbol(0, low_us / 2, 0, low_us - low_us / 2);
+    lane.symbol_count = 2;
+  }
+}
+
+bool RMTServoBank::start() {
+  esp_err_t ret;
+  if (m_start_us != 0) {
+    // 所有通道的高电平结束后才停止，避免截断脉冲；否则推迟到下一次setTargets
+    uint32_t busy_us = m_lanes[m_count - 1].delay_us + kMaxPulseUs +
+                       kPulseGuardUs;
+    uint32_t phase = (esp_timer_get_time() - m_start_us) % m_period_us;
+    if (phase < busy_us) {
+      m_restart_pending = true;
+      return true;
+    }
+    m_restart_pending = false;
+    for (size_t i = 0; i < m_count; i++) {
+      rmt_disable(m_lanes[i].channel);
+    }
+    for (size_t i = 0; i < m_count; i++) {
+      ret = rmt_enable(m_lanes[i].channel);
+      if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to enable RMT channel: %s",
+                 esp_err_to_name(ret));
+        return false;
+      }
+    }
+    if (m_sync) {
+      ret = rmt_sync_reset(m_sync);
+      if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to reset RMT sync manager: %s",
+                 esp_err_to_name(ret));
+        return false;
+      }
+    }
+  }
+
+  // 同步管理器在最后一个通道提交后才让所有通道同时开始
+  rmt_transmit_config_t tx_config = {
+      .loop_count = -1, .flags = {.eot_level = 0, .queue_nonblocking = 0}};
+  for (size_t i = 0; i < m_count; i++) {
+    Lane &lane = m_lanes[i];
+    lane.hw_symbols = nullptr;
+    ret = rmt_transmit(lane.channel, lane.encoder, lane.symbols,
+                       lane.symbol_count * sizeof(rmt_symbol_word_t),
+                       &tx_config);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to transmit RMT data: %s", esp_err_to_name(ret));
+      return false;
+    }
+  }
+  m_start_us = esp_timer_get_time();
+  return true;
+}
+
+void RMTServoBank::setTargets(const float *targets, size_t count) {
+  int64_t begin = esp_timer_get_time();
+  if (count > m_count) {
+    count = m_count;
+  }
+
+  bool need_restart = m_restart_pending;
+  for (size_t i = 0; i < count; i++) {
+    Lane &lane = m_lanes[i];
+    float target = targets[i] + lane.offset;
+    if (target < -1.0f) {
+      target = -1.0f;
+    } else if (target > 1.0f) {
+      target = 1.0f;
+    }
+    lane.target = target;
+
+    uint32_t pulse_us = (uint32_t)(kCenterPulseUs + target * 1000.0f);
+    if (pulse_us < kMinPulseUs) {
+      pulse_us = kMinPulseUs;
+    } else if (pulse_us > kMaxPulseUs) {
+      pulse_us = kMaxPulseUs;
+    }
+    if (pulse_us == lane.pulse_us) {
+      continue;
+    }
+    lane.pulse_us = pulse_us;
+    encodeLane(lane);
+
+    if (lane.hw_symbols) {
+      // 原位改写，硬件在下一个周期读取到新的符号
+      for (size_t s = 0; s < lane.symbol_count; s++) {
+        lane.hw_symbols[s] = lane.symbols[s].val;
+      }
+    } else {
+      need_restart = true;
+    }
+  }
+
+  if (need_restart) {
+    start();
+  }
+
+  uint32_t latency = (uint32_t)(esp_timer_get_time() - begin);
+  m_last_latency_us = latency;
+  if (latency > m_max_latency_us) {
+    m_max_latency_us = latency;
+  }
+  if (++m_ticks % 1000 == 0) {
+    ESP_LOGD(TAG, "setTargets latency: last %luus, max %luus",
+             (unsigned long)m_last_latency_us,
+             (unsigned long)m_max_latency_us);
+  }
+}
+
+size_t RMTServoBank::encoderCallback(const void *data, size_t data_size,
+                                     size_t symbols_written,
+                                     size_t symbols_free,
+                                     rmt_symbol_word_t *symbols, bool *done,
+                                     void *arg) {
+  Lane *lane = static_cast<Lane *>(arg);
+  size_t count = data_size / sizeof(rmt_symbol_word_t);
+  if (symbols_free < count) {
+    return 0;
+  }
+
+  const rmt_symbol_word_t *src = static_cast<const rmt_symbol_word_t *>(data);
+  for (size_t i = 0; i < count; i++) {
+    symbols[symbols_written + i] = src[i];
+  }
+
+  // 非DMA模式下符号直接写在通道RAM里，记录地址以便原位更新
+  const uintptr_t addr = reinterpret_cast<uintptr_t>(&symbols[symbols_written]);
+  const uintptr_t mem_begin = reinterpret_cast<uintptr_t>(&RMTMEM);
+  if (addr >= mem_begin && addr < mem_begin + sizeof(RMTMEM)) {
+    lane->hw_symbols = reinterpret_cast<volatile uint32_t *>(addr);
+  }
+
+  *done = true;
+  return count;
+}
+
+} // namespace actuator
@@ -0,0 +1,277 @@
+#include "actuator/spi_servo_bank.hpp"
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+static const char *TAG = "SPIServoBank";
+
+namespace actuator {
+
+namespace {
+constexpr uint32_t kMaxPulseUs = 2500;
+constexpr uint32_t kCenterPulseUs = 1500;
+constexpr uint32_t kTailSlots = 16; // 窗口末尾的低电平时隙，保证帧结束时数据线为低
+
+void freeDma(uint8_t *p) { heap_caps_free(p); }
+} // namespace
+
+SPIServoBank::SPIServoBank(spi_host_device_t host_id, const int *gpio_nums,
+                           const float *offsets, size_t count,
+                           uint32_t freq_hz, uint32_t clock_hz)
+    : m_host_id(host_id), m_lanes{}, m_count(count), m_clock_hz(clock_hz),
+      m_buffers{DmaBuffer(nullptr, freeDma), DmaBuffer(nullptr, freeDma)},
+      m_trans{} {
+  if (count != 1 && count != 2 && count != 4) {
+    ESP_LOGE(TAG, "Invalid lane count %u, must be 1, 2 or 4", (unsigned)count);
+    throw std::runtime_error("Invalid SPI servo bank lane count");
+  }
+  if (freq_hz < 50 || freq_hz > 333) {
+    ESP_LOGE(TAG, "Invalid frequency %luHz, must be between 50Hz and 333Hz",
+             (unsigned long)freq_hz);
+    throw std::runtime_error(
+        "Invalid frequency, must be between 50Hz and 333Hz");
+  }
+  m_bits_per_slot = count;
+
+  // 有效窗口：最长脉宽 + 末尾低电平，凑整到字节
+  uint32_t slots_per_byte = 8 / m_bits_per_slot;
+  m_slots = (uint32_t)((uint64_t)kMaxPulseUs * clock_hz / 1000000) + kTailSlots;
+  m_slots = (m_slots + slots_per_byte - 1) / slots_per_byte * slots_per_byte;
+  m_frame_bytes = m_slots / slots_per_byte;
+
+  try {
+    for (auto &buffer : m_buffers) {
+      buffer.reset(static_cast<uint8_t *>(heap_caps_malloc(
+          m_frame_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA)));
+      if (!buffer) {
+        ESP_LOGE(TAG, "Failed to allocate %u byte DMA buffer",
+                 (unsigned)m_frame_bytes);
+        throw std::runtime_error("Failed to allocate DMA buffer");
+      }
+    }
+
+    for (size_t i = 0; i < m_count; i++) {
+      m_lanes[i].offset = offsets[i];
+      m_lanes[i].pulse_slots =
+          (uint32_t)((uint64_t)kCenterPulseUs * clock_hz / 1000000);
+    }
+    render(m_buffers[0].get());
+
+    // 数据线依次为D0(MOSI)、D1(MISO)、D2(WP)、D3(HD)
+    spi_bus_config_t bus_config = {};
+    bus_config.mosi_io_num = gpio_nums[0];
+    bus_config.miso_io_num = m_count > 1 ? gpio_nums[1] : -1;
+    bus_config.quadwp_io_num = m_count > 2 ? gpio_nums[2] : -1;
+    bus_config.quadhd_io_num = m_count > 2 ? gpio_nums[3] : -1;
+    bus_config.sclk_io_num = -1;
+    bus_config.max_transfer_sz = m_frame_bytes;
+    esp_err_t ret = spi_bus_initialize(m_host_id, &bus_config, SPI_DMA_CH_AUTO);
+    if (ret == ESP_ERR_INVALID_STATE) {
+      // 总线需要按本组的数据线配置，不能与其他设备（如LED灯带）共用；
+      // 未拿到总线时不能释放它，否则会复位占用者的引脚
+      ESP_LOGE(TAG, "SPI host %d already in use (LED strip?)", (int)m_host_id);
+      throw BusBusy();
+    }
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to initialize SPI bus: %s", esp_err_to_name(ret));
+      throw std::runtime_error("Failed to initialize SPI bus");
+    }
+    m_bus_owner = true;
+
+    spi_device_interface_config_t dev_config = {};
+    dev_config.clock_source = SPI_CLK_SRC_DEFAULT;
+    dev_config.mode = 0;
+    dev_config.clock_speed_hz = static_cast<int>(m_clock_hz);
+    dev_config.spics_io_num = -1;
+    dev_config.flags = m_count > 1 ? SPI_DEVICE_HALFDUPLEX : 0;
+    dev_config.queue_size = 1;
+    ret = spi_bus_add_device(m_host_id, &dev_config, &m_device);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to add SPI device: %s", esp_err_to_name(ret));
+      throw std::runtime_error("Failed to add SPI device");
+    }
+
+    m_trans.length = m_slots * m_bits_per_slot;
+    m_trans.flags = m_count == 4   ? SPI_TRANS_MODE_QIO
+                    : m_count == 2 ? SPI_TRANS_MODE_DIO
+                                   : 0;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = frameCallback,
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "spi_servo_frame",
+        .skip_unhandled_events = true,
+    };
+    ret = esp_timer_create(&timer_args, &m_frame_timer);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to create frame timer: %s", esp_err_to_name(ret));
+      throw std::runtime_error("Failed to create frame timer");
+    }
+    ret = esp_timer_start_periodic(m_frame_timer, 1000000 / freq_hz);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to start frame timer: %s", esp_err_to_name(ret));
+      throw std::runtime_error("Failed to start frame timer");
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+
+  ESP_LOGI(TAG, "%u lanes, %lu Hz frames, %lu ns slot, %u bytes per frame",
+           (unsigned)m_count, (unsigned long)freq_hz,
+           (unsigned long)(1000000000ull / m_clock_hz),
+           (unsigned)m_frame_bytes);
+}
+
+SPIServoBank::~SPIServoBank() {
+  release();
+  ESP_LOGI(TAG, "SPI servo bank deinitialized");
+}
+
+void SPIServoBank::release() {
+  if (m_frame_timer) {
+    esp_timer_stop(m_frame_timer);
+    esp_timer_delete(m_frame_timer);
+    m_frame_timer = nullptr;
+  }
+  if (m_device) {
+    if (m_trans_pending) {
+      spi_transaction_t *done = nullptr;
+      spi_device_get_trans_result(m_device, &done, portMAX_DELAY);
+      m_trans_pending = false;
+    }
+    spi_bus_remove_device(m_device);
+    m_device = nullptr;
+  }
+  if (m_bus_owner) {
+    // 会把数据线引脚复位为GPIO，调用方须保证此时尚无他人认领这些引脚
+    spi_bus_free(m_host_id);
+    m_bus_owner = false;
+  }
+}
+
+void SPIServoBank::fillSlots(uint8_t *buffer, uint32_t begin, uint32_t end,
+                             uint8_t mask) const {
+  const uint32_t n = m_bits_per_slot;
+  const uint32_t slots_per_byte = 8 / n;
+  const uint8_t group_mask = (uint8_t)((1u << n) - 1);
+
+  // 单个时隙：字节内先发送的时隙在高位
+  auto set_slot = [&](uint32_t slot) {
+    uint32_t shift = 8 - n * (slot % slots_per_byte + 1);
+    uint8_t &byte = buffer[slot / slots_per_byte];
+    byte = (uint8_t)((byte & ~(group_mask << shift)) | (mask << shift));
+  };
+
+  while (begin < end && begin % slots_per_byte != 0) {
+    set_slot(begin++);
+  }
+
+  // 整字节部分：把掩码复制到字节内每个时隙后memset
+  uint32_t whole = (end - begin) / slots_per_byte;
+  if (whole > 0) {
+    uint8_t pattern = 0;
+    for (uint32_t k = 0; k < slots_per_byte; k++) {
+      pattern = (uint8_t)((pattern << n) | mask);
+    }
+    memset(buffer + begin / slots_per_byte, pattern, whole);
+    begin += whole * slots_per_byte;
+  }
+
+  while (begin < end) {
+    set_slot(begin++);
+  }
+}
+
+void SPIServoBank::render(uint8_t *buffer) const {
+  // 所有通道在时隙0同时拉高；按脉宽从短到长依次拉低，
+  // 整帧最多m_count+1段，每段是同一个通道掩码
+  size_t order[MAX_LANES];
+  for (size_t i = 0; i < m_count; i++) {
+    order[i] = i;
+  }
+  std::sort(order, order + m_count, [this](size_t l, size_t r) {
+    return m_lanes[l].pulse_slots < m_lanes[r].pulse_slots;
+  });
+
+  uint8_t mask = (uint8_t)((1u << m_count) - 1);
+  uint32_t slot = 0;
+  for (size_t i = 0; i < m_count; i++) {
+    uint32_t end = std::min(m_lanes[order[i]].pulse_slots, m_slots);
+    if (end > slot) {
+      fillSlots(buffer, slot, end, mask);
+      slot = end;
+    }
+    mask &= (uint8_t)~(1u << order[i]);
+  }
+  fillSlots(buffer, slot, m_slots, 0);
+}
+
+void SPIServoBank::setTargets(const float *targets, size_t count) {
+  int64_t begin = esp_timer_get_time();
+  if (count > m_count) {
+    count = m_count;
+  }
+
+  bool changed = false;
+  for (size_t i = 0; i < count; i++) {
+    Lane &lane = m_lanes[i];
+    float target = targets[i] + lane.offset;
+    if (target < -1.0f) {
+      target = -1.0f;
+    } else if (target > 1.0f) {
+      target = 1.0f;
+    }
+    lane.target = target;
+
+    float pulse_us = kCenterPulseUs + target * 1000.0f;
+    uint32_t pulse_slots = (uint32_t)(pulse_us * (m_clock_hz / 1000000.0f));
+    if (pulse_slots != lane.pulse_slots) {
+      lane.pulse_slots = pulse_slots;
+      changed = true;
+    }
+  }
+
+  if (changed) {
+    std::lock_guard<std::mutex> lock(m_buffer_mutex);
+    render(m_buffers[1 - m_front].get());
+    m_back_ready = true;
+  }
+
+  m_last_latency_us = (uint32_t)(esp_timer_get_time() - begin);
+}
+
+void SPIServoBank::frameCallback(void *arg) {
+  SPIServoBank *self = static_cast<SPIServoBank *>(arg);
+
+  // 上一帧的DMA事务必须已完成，其缓冲区才能交给渲染侧
+  if (self->m_trans_pending) {
+    spi_transaction_t *done = nullptr;
+    if (spi_device_get_trans_result(self->m_device, &done, 0) != ESP_OK) {
+      self->m_skipped_frames++;
+      return;
+    }
+    self->m_trans_pending = false;
+  }
+
+  // 渲染进行中则沿用当前帧，下一帧再交换
+  {
+    std::unique_lock<std::mutex> lock(self->m_buffer_mutex, std::try_to_lock);
+    if (lock.owns_lock() && self->m_back_ready) {
+      self->m_front = 1 - self->m_front;
+      self->m_back_ready = false;
+    }
+  }
+
+  self->m_trans.tx_buffer = self->m_buffers[self->m_front].get();
+  if (spi_device_queue_trans(self->m_device, &self->m_trans, 0) == ESP_OK) {
+    self->m_trans_pending = true;
+  } else {
+    self->m_skipped_frames++;
+  }
+}
+
+} // namespace actuator
@@ -23,6 +23,10 @@ float cpu_usage_percent = 0.0f;
 static uint32_t last_idle_ticks = 0;
 static uint32_t last_total_ticks = 0;
 
+// 执行器节拍时间累计（微秒），每个统计周期清零
+static uint32_t motion_active_us = 0;
+static uint32_t motion_idle_us = 0;
+
 esp_err_t analysis_init(void) {
   ESP_LOGI(TAG, "初始化CPU分析模块");
 
@@ -99,11 +103,22 @@ void analysis_timer_callback(TimerHandle_t xTimer) {
       size_t free_heap_size = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
       size_t total_heap_size = heap_caps_get_total_size(MALLOC_CAP_DEFAULT);
 
+      // 执行器静止时间占比
+      uint32_t active_us =
+          __atomic_exchange_n(&motion_active_us, 0, __ATOMIC_RELAXED);
+      uint32_t idle_us =
+          __atomic_exchange_n(&motion_idle_us, 0, __ATOMIC_RELAXED);
+      float motion_idle_percent =
+          (active_us + idle_us) > 0
+              ? 100.0f * (float)idle_us / (float)(active_us + idle_us)
+              : 0.0f;
+
       // 创建CPU占用事件数据
       analysis_cpu_usage_event_data_t event_data = {
           .cpu_usage_percent = cpu_usage_percent,
           .free_heap_size = free_heap_size,
-          .total_heap_size = total_heap_size};
+          .total_heap_size = total_heap_size,
+          .motion_idle_percent = motion_idle_percent};
 
       // 发送CPU占用事件
       esp_err_t ret =
@@ -124,6 +139,11 @@ void analysis_timer_callback(TimerHandle_t xTimer) {
 
 float get_cpu_usage(void) { return cpu_usage_percent; }
 
+void analysis_motion_tick(bool idle, uint32_t period_us) {
+  __atomic_fetch_add(idle ? &motion_idle_us : &motion_active_us, period_us,
+                     __ATOMIC_RELAXED);
+}
+
 void reset_cpu_stats(void) {
   idle_ticks_total = 0;
   total_ticks = 0;
@@ -166,8 +186,8 @@ void analysis_cpu_usage_event_handler(void *handler_arg,
 
     ESP_LOGI(TAG,
              "CPU占用事件 - CPU使用率: %.2f%%, 可用内存: %d bytes, 总内存: "
-             "%d bytes",
+             "%d bytes, 执行器静止: %.1f%%",
              data->cpu_usage_percent, data->free_heap_size,
-             data->total_heap_size);
+             data->total_heap_size, data->motion_idle_percent);
   }
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "executor/executor.hpp"
+#include "analysis.h"
 #include "esp_event.h"
 #include "globals.hpp"
 #include "http/websocket_server.h"
@@ -23,8 +24,13 @@ ESP_EVENT_DEFINE_BASE(MOTION_EVENT);
  */
 Executor::Executor(const SettingWrapper &setting)
     : m_setting(setting), taskHandle(nullptr), parserTaskHandle(nullptr),
-      semaphore(nullptr), timer(nullptr), taskRunning(false),
-      parserTaskRunning(false), taskExecuting(false), TAG("Executor") {
+      semaphore(nullptr), exitSemaphore(nullptr), timer(nullptr),
+      taskRunning(false),
+      parserTaskRunning(false), taskExecuting(false), TAG("Executor"),
+      m_tick_period_us(1000000 / setting->servo.A_SERVO_PWM_FREQ),
+      m_last_axis{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, m_tick_axis(nullptr),
+      m_has_last_axis(false),
+      m_idle(false), m_joint_count(0) {
   try {
     // 创建二值信号量，初始值为0
     semaphore = xSemaphoreCreateBinary();
@@ -32,6 +38,11 @@ Executor::Executor(const SettingWrapper &setting)
       ESP_LOGE(TAG, "Failed to create semaphore");
       throw std::runtime_error("Failed to create semaphore");
     }
+    exitSemaphore = xSemaphoreCreateBinary();
+    if (exitSemaphore == nullptr) {
+      ESP_LOGE(TAG, "Failed to create semaphore");
+      throw std::runtime_error("Failed to create semaphore");
+    }
 
     // 配置定时器
     const esp_timer_create_args_t timer_args = {
@@ -88,8 +99,7 @@ Executor::Executor(const SettingWrapper &setting)
     }
 
     // 启动定时器，频率为setting.servo.A_SERVO_PWM_FREQ
-    ret = esp_timer_start_periodic(timer,
-                                   1000000 / m_setting->servo.A_SERVO_PWM_FREQ);
+    ret = esp_timer_start_periodic(timer, m_tick_period_us);
     if (ret != ESP_OK) {
       ESP_LOGE(TAG, "Failed to start timer: %s", esp_err_to_name(ret));
       throw std::runtime_error("Failed to start timer");
@@ -109,10 +119,16 @@ Executor::Executor(const SettingWrapper &setting)
       esp_timer_delete(timer);
       timer = nullptr;
     }
+    esp_event_handler_unregister(EXECUTOR_EVENT, ESP_EVENT_ANY_ID,
+                                 &Executor::eventHandler);
     if (semaphore != nullptr) {
       vSemaphoreDelete(semaphore);
       semaphore = nullptr;
     }
+    if (exitSemaphore != nullptr) {
+      vSemaphoreDelete(exitSemaphore);
+      exitSemaphore = nullptr;
+    }
     // 将捕获的异常再次向上抛出
     throw;
   }
@@ -122,7 +138,36 @@ Executor::Executor(const SettingWrapper &setting)
  * @brief Executor析构函数
  */
 Executor::~Executor() {
-  // 停止解析任务
+  stop();
+
+  // 之后排队的计时事件不再交给本对象处理
+  esp_event_handler_unregister(EXECUTOR_EVENT, ESP_EVENT_ANY_ID,
+                               &Executor::eventHandler);
+
+  if (timer != nullptr) {
+    esp_timer_delete(timer);
+    timer = nullptr;
+  }
+
+  if (semaphore != nullptr) {
+    vSemaphoreDelete(semaphore);
+    semaphore = nullptr;
+  }
+
+  if (exitSemaphore != nullptr) {
+    vSemaphoreDelete(exitSemaphore);
+    exitSemaphore = nullptr;
+  }
+
+  ESP_LOGI(TAG, "Executor destroyed");
+}
+
+/**
+ * @brief 停止节拍与解析任务
+ * 执行任务被唤醒后自行退出，不在节拍中途删除（可能持有CAN发送等共享锁）
+ */
+void Executor::stop() {
+  // 停止解析任务（阻塞在接收队列上）
   if (parserTaskRunning) {
     parserTaskRunning = false;
     if (parserTaskHandle != nullptr) {
@@ -138,34 +183,25 @@ Executor::~Executor() {
     // 停止定时器
     if (timer != nullptr) {
       esp_err_t ret = esp_timer_stop(timer);
-      if (ret != ESP_OK) {
+      if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
         ESP_LOGE(TAG, "Failed to stop timer: %s", esp_err_to_name(ret));
       }
     }
 
-    // 释放信号量，以便任务能够退出
+    // 释放信号量唤醒任务，等待其完成当前节拍后退出
     if (semaphore != nullptr) {
       xSemaphoreGive(semaphore);
     }
-
-    // 等待任务结束
     if (taskHandle != nullptr) {
-      vTaskDelete(taskHandle);
+      if (xSemaphoreTake(exitSemaphore,
+                         pdMS_TO_TICKS(EXECUTOR_STOP_TIMEOUT_MS)) != pdTRUE) {
+        ESP_LOGE(TAG, "Executor task did not stop in %d ms, deleting",
+                 EXECUTOR_STOP_TIMEOUT_MS);
+        vTaskDelete(taskHandle);
+      }
       taskHandle = nullptr;
     }
   }
-
-  if (timer != nullptr) {
-    esp_timer_delete(timer);
-    timer = nullptr;
-  }
-
-  if (semaphore != nullptr) {
-    vSemaphoreDelete(semaphore);
-    semaphore = nullptr;
-  }
-
-  ESP_LOGI(TAG, "Executor destroyed");
 }
 
 /**
@@ -185,23 +221,43 @@ void Executor::taskFunc(void *arg) {
     // 等待信号量
     BaseType_t result = xSemaphoreTake(executor->semaphore, portMAX_DELAY);
     ESP_LOGD(executor->TAG, "Semaphore take result: %d", result);
+    if (!executor->taskRunning) {
+      break;
+    }
 
     if (result == pdTRUE) {
+      executor->m_tick_axis = nullptr;
+      // 静止时跳过compute/execute，并降低节拍频率
+      if (executor->isStationary()) {
+        executor->setIdle(true);
+        analysis_motion_tick(true, executor->m_tick_period_us *
+                                       EXECUTOR_IDLE_TICK_DIVIDER);
+        continue;
+      }
+      executor->setIdle(false);
+
       // 设置任务正在执行标志
       executor->taskExecuting = true;
 
-      // 发送compute开始事件并执行
-      executor->sendComputeEvent(true);
-      executor->compute();
-      executor->sendComputeEvent(false);
-
-      // 发送execute开始事件并执行
-      executor->sendExecuteEvent(true);
-      executor->execute();
-      executor->sendExecuteEvent(false);
+#if EXECUTOR_TICK_PROFILE
+      uint32_t tick_start = esp_cpu_get_cycle_count();
+      executor->tick();
+      uint32_t tick_cycles = esp_cpu_get_cycle_count() - tick_start;
+      executor->m_tick_cycles_sum.fetch_add(tick_cycles,
+                                            std::memory_order_relaxed);
+      executor->m_tick_cycles_count.fetch_add(1, std::memory_order_relaxed);
+      if (tick_cycles >
+          executor->m_tick_cycles_max.load(std::memory_order_relaxed)) {
+        executor->m_tick_cycles_max.store(tick_cycles,
+                                          std::memory_order_relaxed);
+      }
+#else
+      executor->tick();
+#endif
 
       // 清除任务正在执行标志
       executor->taskExecuting = false;
+      analysis_motion_tick(false, executor->m_tick_period_us);
     } else {
       // 超时，继续循环
       ESP_LOGD(executor->TAG, "Semaphore take timeout");
@@ -209,9 +265,25 @@ void Executor::taskFunc(void *arg) {
   }
 
   ESP_LOGI(executor->TAG, "Executor task stopped");
+  // 释放后executor可能随即析构，之后不再访问
+  xSemaphoreGive(executor->exitSemaphore);
   vTaskDelete(nullptr);
 }
 
+/**
+ * @brief 单个节拍：compute后execute，前后发送计时事件
+ * 经虚函数分派调用compute/execute，PipelineExecutor派生类以直接调用重写
+ */
+void Executor::tick() {
+  sendComputeEvent(true);
+  compute();
+  sendComputeEvent(false);
+
+  sendExecuteEvent(true);
+  execute();
+  sendExecuteEvent(false);
+}
+
 /**
  * @brief 解析器任务函数
  * 从global_rx_queue读取数据，解析后存储到tcode对象中
@@ -310,6 +382,8 @@ void Executor::parserTaskFunc(void *arg) {
             if (!tcodeStr.empty()) {
               // 使用tcode类解析TCode字符串
               self->tcode.preprocess(tcodeStr);
+              // 收到新命令立即唤醒执行任务，不等待降频后的节拍
+              self->setIdle(false);
             }
           }
         }
@@ -336,6 +410,117 @@ void Executor::parserTaskFunc(void *arg) {
   vTaskDelete(nullptr);
 }
 
+/**
+ * @brief 判断当前节拍是否静止
+ * @return true 静止，可跳过本节拍
+ */
+bool Executor::isStationary() {
+#if EXECUTOR_IDLE_SKIP
+  if (!idleSkipAllowed()) {
+    return false;
+  }
+
+  float *axis = tickAxis();
+  if (axis == nullptr) {
+    return false;
+  }
+
+  // 与上一节拍的轴向量比较
+  bool changed = !m_has_last_axis;
+  for (int i = 0; i < 6; i++) {
+    if (fabsf(axis[i] - m_last_axis[i]) > EXECUTOR_IDLE_EPSILON) {
+      changed = true;
+    }
+    m_last_axis[i] = axis[i];
+  }
+  m_has_last_axis = true;
+
+  // 限幅器仍在追赶目标时不能停止输出
+  return !changed && !tcode.isInterpolating() && m_limiter.settled();
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief 修改节拍周期
+ * 静止降频状态下按降频后的周期重启定时器
+ * @param period_us 节拍周期（微秒）
+ */
+void Executor::setTickPeriod(uint32_t period_us) {
+  std::lock_guard<std::mutex> lock(m_idle_mutex);
+  if (period_us == 0 || period_us == m_tick_period_us) {
+    return;
+  }
+  m_tick_period_us = period_us;
+
+  if (timer != nullptr) {
+    uint64_t period = m_idle && EXECUTOR_IDLE_TICK_DIVIDER > 1
+                          ? (uint64_t)period_us * EXECUTOR_IDLE_TICK_DIVIDER
+                          : period_us;
+    esp_err_t ret = esp_timer_restart(timer, period);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to restart timer: %s", esp_err_to_name(ret));
+    }
+  }
+  ESP_LOGI(TAG, "Tick period set to %lu us", (unsigned long)period_us);
+}
+
+/**
+ * @brief 配置关节限幅与遥测记录
+ * @param joints 关节数量
+ * @param limits 限幅参数
+ */
+void Executor::configureJoints(size_t joints,
+                               const JointLimiter::Limits &limits) {
+  m_joint_count = joints;
+  m_limiter.configure(joints, limits, m_tick_period_us / 1000000.0f);
+#if EXECUTOR_TELEMETRY
+  Telemetry::getInstance().begin(joints, m_tick_period_us);
+#endif
+}
+
+/**
+ * @brief 记录本节拍的关节指令与实测位置
+ * @param commanded 本节拍输出的关节目标
+ */
+void Executor::recordJoints(const float *commanded) {
+#if EXECUTOR_TELEMETRY
+  float measured[JointLimiter::MAX_JOINTS];
+  bool has_feedback = getJointFeedback(measured, m_joint_count);
+  Telemetry::getInstance().record(commanded, has_feedback ? measured : nullptr,
+                                  m_joint_count);
+#endif
+}
+
+/**
+ * @brief 切换静止/运动状态
+ * 进入静止时定时器降频；恢复运动时定时器恢复原频率，并立即释放信号量
+ * @param idle true进入静止，false恢复运动
+ */
+void Executor::setIdle(bool idle) {
+  std::lock_guard<std::mutex> lock(m_idle_mutex);
+  if (m_idle == idle) {
+    return;
+  }
+  m_idle = idle;
+
+  if (EXECUTOR_IDLE_TICK_DIVIDER > 1 && timer != nullptr) {
+    uint64_t period = idle ? (uint64_t)m_tick_period_us *
+                                 EXECUTOR_IDLE_TICK_DIVIDER
+                           : m_tick_period_us;
+    esp_err_t ret = esp_timer_restart(timer, period);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to restart timer: %s", esp_err_to_name(ret));
+    }
+  }
+
+  if (!idle && semaphore != nullptr) {
+    xSemaphoreGive(semaphore);
+  }
+  ESP_LOGD(TAG, "Executor %s", idle ? "idle" : "active");
+}
+
 /**
  * @brief 定时器回调函数
  * @param arg 回调参数
@@ -495,6 +680,13 @@ void Executor::eventHandler(void *handler_arg, esp_event_base_t event_base,
       float execute_stddev_ms = execute_stddev_us / 1000.0f;
       float execute_max_ms = stats.execute_max_duration / 1000.0f;
 
+      // 关节限幅触发占比
+      JointLimiter::Stats limit = executor->m_limiter.takeStats();
+      float limit_scale = limit.ticks > 0 ? 100.0f / limit.ticks : 0.0f;
+      float limit_velocity_percent = limit.velocity_hits * limit_scale;
+      float limit_accel_percent = limit.accel_hits * limit_scale;
+      float limit_jerk_percent = limit.jerk_hits * limit_scale;
+
       // 打印统计信息
       ESP_LOGI(executor->TAG,
                "Stats [%.1fs window] - Compute: avg=%.3f ms, "
@@ -506,6 +698,30 @@ void Executor::eventHandler(void *handler_arg, esp_event_base_t event_base,
                "stddev=%.3f ms, max=%.3f ms, freq=%.2f Hz",
                window_seconds, execute_avg_ms, execute_stddev_ms,
                execute_max_ms, execute_freq);
+#if EXECUTOR_TICK_PROFILE
+      uint32_t tick_cycles_sum =
+          executor->m_tick_cycles_sum.exchange(0, std::memory_order_relaxed);
+      uint32_t tick_cycles_count =
+          executor->m_tick_cycles_count.exchange(0, std::memory_order_relaxed);
+      uint32_t tick_cycles_max =
+          executor->m_tick_cycles_max.exchange(0, std::memory_order_relaxed);
+      ESP_LOGI(executor->TAG,
+               "Stats [%.1fs window] - Tick: avg=%lu cycles, max=%lu cycles "
+               "(%s)",
+               window_seconds,
+               (unsigned long)(tick_cycles_count > 0
+                                   ? tick_cycles_sum / tick_cycles_count
+                                   : 0),
+               (unsigned long)tick_cycles_max,
+               EXECUTOR_DEVIRTUALIZE ? "pipeline" : "virtual");
+#endif
+      if (limit.velocity_hits || limit.accel_hits || limit.jerk_hits) {
+        ESP_LOGI(executor->TAG,
+                 "Stats [%.1fs window] - Limit: vel=%.1f%%, acc=%.1f%%, "
+                 "jerk=%.1f%% of %lu ticks",
+                 window_seconds, limit_velocity_percent, limit_accel_percent,
+                 limit_jerk_percent, (unsigned long)limit.ticks);
+      }
 
       // 发送统计事件
       motion_stats_event_data_t stats_event = {
@@ -517,6 +733,9 @@ void Executor::eventHandler(void *handler_arg, esp_event_base_t event_base,
           .execute_stddev_ms = execute_stddev_ms,
           .execute_max_ms = execute_max_ms,
           .execute_freq = execute_freq,
+          .limit_velocity_percent = limit_velocity_percent,
+          .limit_accel_percent = limit_accel_percent,
+          .limit_jerk_percent = limit_jerk_percent,
           .window_seconds = window_seconds,
       };
       esp_event_post(MOTION_EVENT, MOTION_EVENT_STATS, &stats_event,
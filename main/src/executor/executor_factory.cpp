@@ -1,11 +1,21 @@
 #include "executor/executor_factory.hpp"
 #include "esp_log.h"
 #include "executor/executor.hpp"
+#if EXECUTOR_MODE_ENABLED(0)
 #include "executor/osr_executor.hpp"
+#endif
+#if EXECUTOR_MODE_ENABLED(9)
 #include "executor/o6_executor.hpp"
+#endif
+#if EXECUTOR_MODE_ENABLED(3)
 #include "executor/sr6_executor.hpp"
+#endif
+#if EXECUTOR_MODE_ENABLED(8)
 #include "executor/sr6can_executor.hpp"
+#endif
+#if EXECUTOR_MODE_ENABLED(6)
 #include "executor/trrmax_executor.hpp"
+#endif
 
 static const char *TAG = "ExecutorFactory";
 
@@ -19,25 +29,35 @@ ExecutorFactory::createExecutor(const SettingWrapper &setting) {
 
     // 根据 mode 值创建对应的 executor
     switch (mode) {
+#if EXECUTOR_MODE_ENABLED(0)
     case 0:
       ESP_LOGI(TAG, "创建 OSR Executor (Multi-Axis Motion)");
       return std::make_unique<OSRExecutor>(setting);
+#endif
 
+#if EXECUTOR_MODE_ENABLED(3)
     case 3:
       ESP_LOGI(TAG, "创建 SR6 Executor");
       return std::make_unique<SR6Executor>(setting);
+#endif
 
+#if EXECUTOR_MODE_ENABLED(6)
     case 6:
       ESP_LOGI(TAG, "创建 TrRMax Executor");
       return std::make_unique<TrRMaxExecutor>(setting);
+#endif
 
+#if EXECUTOR_MODE_ENABLED(8)
     case 8:
       ESP_LOGI(TAG, "创建 SR6CAN Executor");
       return std::make_unique<SR6CANExecutor>(setting);
+#endif
 
+#if EXECUTOR_MODE_ENABLED(9)
     case 9:
       ESP_LOGI(TAG, "创建 O6 Executor (6-Axis Parallel Robot)");
       return std::make_unique<O6Executor>(setting);
+#endif
 
     default:
       ESP_LOGE(TAG,
@@ -52,6 +72,16 @@ ExecutorFactory::createExecutor(const SettingWrapper &setting) {
   }
 }
 
+void ExecutorFactory::rebuild(std::unique_ptr<Executor> &executor,
+                              const SettingWrapper &setting) {
+  if (executor) {
+    ESP_LOGI(TAG, "停止旧 Executor");
+    executor->stop();
+    executor.reset();
+  }
+  executor = createExecutor(setting);
+}
+
 const char *ExecutorFactory::modeToString(int32_t mode) {
   switch (mode) {
   case 0:
@@ -70,5 +100,9 @@ const char *ExecutorFactory::modeToString(int32_t mode) {
 }
 
 std::vector<int32_t> ExecutorFactory::getSupportedModes() {
+#if EXECUTOR_FIXED_MODE >= 0
+  return {EXECUTOR_FIXED_MODE};
+#else
   return {0, 3, 6, 8, 9};
+#endif
 }
@@ -5,9 +5,9 @@
 const char *O6Executor::TAG = "O6Executor";
 
 O6Executor::O6Executor(const SettingWrapper &setting)
-    : Executor(setting), m_theta_values{0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
-      m_servo_a_target(0.0f), m_servo_b_target(0.0f), m_servo_c_target(0.0f),
-      m_servo_d_target(0.0f), m_servo_e_target(0.0f), m_servo_f_target(0.0f) {
+    : PipelineExecutor(setting), m_base(geometry::make_o6_base_geometry()),
+      m_theta_values{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+      m_servo_targets{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f} {
   ESP_LOGI(TAG, "O6Executor Constructor");
 
   // Initialize all 6 servo channels
@@ -16,6 +16,10 @@ O6Executor::O6Executor(const SettingWrapper &setting)
     throw std::runtime_error("Failed to initialize LEDC");
   }
 
+  // Rate-limit the six servo targets (normalized units) before output
+  configureJoints(6, {SERVO_LIMIT_VELOCITY, SERVO_LIMIT_ACCEL,
+                      SERVO_LIMIT_JERK});
+
   m_init_done = true;
   ESP_LOGI(TAG, "O6Executor initialized successfully");
 }
@@ -23,64 +27,27 @@ O6Executor::O6Executor(const SettingWrapper &setting)
 O6Executor::~O6Executor() { ESP_LOGI(TAG, "O6Executor Destructor"); }
 
 bool O6Executor::initLEDC() {
-  // Get servo frequency from settings (use A_SERVO_PWM_FREQ as reference)
-  uint32_t freq_hz = m_setting->servo.A_SERVO_PWM_FREQ;
-
-  // Initialize 6 servos with LEDC channels 0-5 and timers 0-5
-  // Use gpio -1 to disable unused servos
-
-  // Servo A - Channel 0, Timer 0
-  if (m_setting->servo.A_SERVO_PIN >= 0) {
-    m_servo_a = std::make_unique<actuator::LEDCActuator>(
-        m_setting->servo.A_SERVO_PIN, LEDC_CHANNEL_0, LEDC_TIMER_0, freq_hz,
-        0.0f);
-    ESP_LOGI(TAG, "Servo A initialized on GPIO %d",
-             m_setting->servo.A_SERVO_PIN);
-  }
-
-  // Servo B - Channel 1, Timer 1
-  if (m_setting->servo.B_SERVO_PIN >= 0) {
-    m_servo_b = std::make_unique<actuator::LEDCActuator>(
-        m_setting->servo.B_SERVO_PIN, LEDC_CHANNEL_1, LEDC_TIMER_0, freq_hz,
-        0.0f);
-    ESP_LOGI(TAG, "Servo B initialized on GPIO %d",
-             m_setting->servo.B_SERVO_PIN);
-  }
-
-  // Servo C - Channel 2, Timer 2
-  if (m_setting->servo.C_SERVO_PIN >= 0) {
-    m_servo_c = std::make_unique<actuator::LEDCActuator>(
-        m_setting->servo.C_SERVO_PIN, LEDC_CHANNEL_2, LEDC_TIMER_0, freq_hz,
-        0.0f);
-    ESP_LOGI(TAG, "Servo C initialized on GPIO %d",
-             m_setting->servo.C_SERVO_PIN);
-  }
-
-  // Servo D - Channel 3, Timer 3
-  if (m_setting->servo.D_SERVO_PIN >= 0) {
-    m_servo_d = std::make_unique<actuator::LEDCActuator>(
-        m_setting->servo.D_SERVO_PIN, LEDC_CHANNEL_3, LEDC_TIMER_0, freq_hz,
-        0.0f);
-    ESP_LOGI(TAG, "Servo D initialized on GPIO %d",
-             m_setting->servo.D_SERVO_PIN);
-  }
-
-  // Servo E - Channel 4, Timer 4
-  if (m_setting->servo.E_SERVO_PIN >= 0) {
-    m_servo_e = std::make_unique<actuator::LEDCActuator>(
-        m_setting->servo.E_SERVO_PIN, LEDC_CHANNEL_4, LEDC_TIMER_0, freq_hz,
-        0.0f);
-    ESP_LOGI(TAG, "Servo E initialized on GPIO %d",
-             m_setting->servo.E_SERVO_PIN);
-  }
-
-  // Servo F - Channel 5, Timer 5
-  if (m_setting->servo.F_SERVO_PIN >= 0) {
-    m_servo_f = std::make_unique<actuator::LEDCActuator>(
-        m_setting->servo.F_SERVO_PIN, LEDC_CHANNEL_5, LEDC_TIMER_0, freq_hz,
-        0.0f);
-    ESP_LOGI(TAG, "Servo F initialized on GPIO %d",
-             m_setting->servo.F_SERVO_PIN);
+  // All 6 servos are written as one bank on LEDC channels 0-5. Each servo
+  // runs at its own configured frequency; servos with the same frequency
+  // share an LEDC timer. Use gpio -1 to disable unused servos
+  try {
+    m_bank = std::make_unique<actuator::ActuatorBank>();
+    const int pins[6] = {
+        m_setting->servo.A_SERVO_PIN, m_setting->servo.B_SERVO_PIN,
+        m_setting->servo.C_SERVO_PIN, m_setting->servo.D_SERVO_PIN,
+        m_setting->servo.E_SERVO_PIN, m_setting->servo.F_SERVO_PIN};
+    const int freqs[6] = {
+        m_setting->servo.A_SERVO_PWM_FREQ, m_setting->servo.B_SERVO_PWM_FREQ,
+        m_setting->servo.C_SERVO_PWM_FREQ, m_setting->servo.D_SERVO_PWM_FREQ,
+        m_setting->servo.E_SERVO_PWM_FREQ, m_setting->servo.F_SERVO_PWM_FREQ};
+    for (size_t i = 0; i < 6; i++) {
+      m_bank->addLane(i, pins[i], (ledc_channel_t)(LEDC_CHANNEL_0 + i),
+                      freqs[i], 0.0f);
+    }
+  } catch (const std::exception &e) {
+    ESP_LOGE(TAG, "Failed to create actuator bank: %s", e.what());
+    m_bank.reset();
+    return false;
   }
 
   return true;
@@ -90,7 +57,7 @@ void O6Executor::compute() {
   std::lock_guard<std::mutex> lock(m_compute_mutex);
 
   // Get interpolated values from tcode
-  float *interpolated = tcode.interpolate();
+  float *interpolated = tickAxis();
   float L0 = interpolated[0]; // Z axis
   float L1 = interpolated[1]; // Y axis
   float L2 = interpolated[2]; // X axis
@@ -154,11 +121,10 @@ void O6Executor::compute() {
 
   // Use O6 kinematics solver to calculate 6 servo angles
   // Note: z offset needs adjustment: z + 19.3 - O6_OFFSET
-  auto result =
-      geometry::solve_robot_kinematics(x, y, z + 19.3, roll, pitch, yaw);
-
-  if (result) {
-    m_theta_values = *result;
+  std::array<float, 6> thetas;
+  if (geometry::solve_robot_kinematics_f(m_base, x, y, z + 19.3f, roll, pitch,
+                                         yaw, thetas)) {
+    m_theta_values = thetas;
 
     // Apply sign correction (even indices inverted)
     for (size_t i = 0; i < 6; i++) {
@@ -196,57 +162,33 @@ void O6Executor::execute() {
   // Send PWM signal for each servo
   for (int i = 0; i < 6; i++) {
     // Convert angle from radians to degrees
-    double angle_deg = m_theta_values[i] * 180.0 / M_PI;
+    float angle_deg = m_theta_values[i] * (180.0f / (float)M_PI);
 
     // Map angle to servo pulse width range (typically 500-2500us)
     // Assuming servo working range is ±90 degrees
-    double pulse_width = map_(angle_deg, -90.0, 90.0, 500.0, 2500.0);
+    float pulse_width = map_(angle_deg, -90.0f, 90.0f, 500.0f, 2500.0f);
 
     // Apply zero offset
-    pulse_width = servo_zeros[i] + (pulse_width - 1500.0);
+    pulse_width = servo_zeros[i] + (pulse_width - 1500.0f);
 
     // Constrain pulse width to valid range
-    if (pulse_width < 500.0)
-      pulse_width = 500.0;
-    if (pulse_width > 2500.0)
-      pulse_width = 2500.0;
+    if (pulse_width < 500.0f)
+      pulse_width = 500.0f;
+    if (pulse_width > 2500.0f)
+      pulse_width = 2500.0f;
 
     // Convert pulse width to target value (-1.0 to 1.0) for LEDC actuator
     // 1500us center = 0.0, 500us = -1.0, 2500us = 1.0
-    float target = (pulse_width - 1500.0) / 1000.0;
-
-    // Set target for corresponding servo
-    switch (i) {
-    case 0:
-      if (m_servo_a)
-        m_servo_a->setTarget(target);
-      m_servo_a_target = target;
-      break;
-    case 1:
-      if (m_servo_b)
-        m_servo_b->setTarget(target);
-      m_servo_b_target = target;
-      break;
-    case 2:
-      if (m_servo_c)
-        m_servo_c->setTarget(target);
-      m_servo_c_target = target;
-      break;
-    case 3:
-      if (m_servo_d)
-        m_servo_d->setTarget(target);
-      m_servo_d_target = target;
-      break;
-    case 4:
-      if (m_servo_e)
-        m_servo_e->setTarget(target);
-      m_servo_e_target = target;
-      break;
-    case 5:
-      if (m_servo_f)
-        m_servo_f->setTarget(target);
-      m_servo_f_target = target;
-      break;
-    }
+    float target = (pulse_width - 1500.0f) / 1000.0f;
+
+    m_servo_targets[i] = target;
+  }
+
+  limitJoints(m_servo_targets.data());
+
+  // Write all 6 channels in one pass so they latch on the same PWM period
+  if (m_bank) {
+    m_bank->setTargets(m_servo_targets.data(), m_servo_targets.size());
   }
+  recordJoints(m_servo_targets.data());
 }
@@ -3,9 +3,15 @@
 #include "utils.hpp"
 #include "esp_log.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
+#include "geometry/fast_math.hpp"
 #include <cmath>
 #include <cstring>
 #include <stdexcept>
+#include "twai/can_health.hpp"
+#include "twai/can_rx.hpp"
+#include "twai/can_schedule.hpp"
+#include "twai/can_tx.hpp"
 #include "twai/mit.hpp"
 #include "twai/twai.hpp"
 
@@ -15,16 +21,15 @@ bool SR6CANExecutor::mit_initialized_ = false;
 std::mutex SR6CANExecutor::init_mutex_;
 
 SR6CANExecutor::SR6CANExecutor(const SettingWrapper& setting)
-    : Executor(setting),
-      can_receive_task_handle_(nullptr),
-      init_done(false) {
+    : PipelineExecutor(setting),
+      init_done(false),
+      can_generation_(0) {
     try {
         ESP_LOGI(TAG, "SR6CANExecutor构造()，SR6CANServoNum: %d", SR6CANServoNum);
         
         // 初始化电机位置数组
         for (int i = 0; i < SR6CANServoNum; i++) {
             motor_position[i] = 0.0f;
-            motor_position_feedback[i] = 0.0f;
             
             // 初始化PID控制器，只使用I控制
             if (i == 2 || i == 3) {
@@ -81,7 +86,7 @@ SR6CANExecutor::SR6CANExecutor(const SettingWrapper& setting)
         {
             std::lock_guard<std::mutex> lock(init_mutex_);
             if (!mit_initialized_) {
-                esp_err_t ret = MIT::init();
+                esp_err_t ret = MIT::init(2, 3, 500000, SR6CANNodeMask);
                 if (ret != ESP_OK) {
                     ESP_LOGE(TAG, "MIT初始化失败: %s", esp_err_to_name(ret));
                     throw std::runtime_error("MIT初始化失败");
@@ -94,24 +99,40 @@ SR6CANExecutor::SR6CANExecutor(const SettingWrapper& setting)
         // 初始化电机
         initMotors();
 
-        // 创建CAN接收任务
-        BaseType_t xReturn = xTaskCreate(
-            canReceiveTask, "CANReceiveTask", 4096, this, 5,  // 使用优先级5
-            &can_receive_task_handle_);
-        if (xReturn != pdPASS) {
-            ESP_LOGE(TAG, "Failed to create CAN receive task: %d", xReturn);
-            throw std::runtime_error("Failed to create CAN receive task");
+        // 启动CAN批量发送任务（节拍中的控制帧经其非阻塞下发）
+        if (CanTx::start() != ESP_OK) {
+            throw std::runtime_error("CAN发送任务启动失败");
         }
 
+        // 按总线负载预算分配每节拍时隙，设置的节拍频率超出总线能力时自动降低
+        CanSchedule::Plan plan = CanSchedule::configure(
+            500000, m_setting->servo.A_SERVO_PWM_FREQ, SR6CANServoNum,
+            SR6CANNodeMask);
+        setTickPeriod(1000000 / plan.tick_hz);
+
+        // 总线关闭/错误被动恢复后重新使能电机
+        can_generation_ = CanHealth::generation();
+        CanHealth::setResumeHandler(resumeMotors, this);
+
+        // 电机关节限幅（电机轴弧度，已含减速比）
+        configureJoints(SR6CANServoNum, {MOTOR_LIMIT_VELOCITY, MOTOR_LIMIT_ACCEL,
+                                         MOTOR_LIMIT_JERK});
+
+#if SR6CAN_FEEDFORWARD
+        tracking_.configure(SR6CANServoNum, m_tick_period_us / 1000000.0f,
+                            SR6CAN_FEEDFORWARD == 2);
+#if SR6CAN_FF_INTEGRAL
+        for (int i = 0; i < SR6CANServoNum; i++) {
+            ff_integral_[i] = 0.0f;
+            ff_sample_us_[i] = 0;
+        }
+#endif
+#endif
+
         init_done = true;
         ESP_LOGI(TAG, "SR6CANExecutor初始化完成");
     } catch (const std::exception& e) {
         ESP_LOGE(TAG, "SR6CANExecutor构造失败: %s", e.what());
-        // 清理已分配的资源
-        if (can_receive_task_handle_ != nullptr) {
-            vTaskDelete(can_receive_task_handle_);
-            can_receive_task_handle_ = nullptr;
-        }
         throw;
     }
 }
@@ -119,11 +140,14 @@ SR6CANExecutor::SR6CANExecutor(const SettingWrapper& setting)
 SR6CANExecutor::~SR6CANExecutor() {
     ESP_LOGI(TAG, "SR6CANExecutor析构()，SR6CANServoNum: %d", SR6CANServoNum);
 
-    // 停止CAN接收任务
-    if (can_receive_task_handle_ != nullptr) {
-        vTaskDelete(can_receive_task_handle_);
-        can_receive_task_handle_ = nullptr;
-    }
+    // 先停止节拍，析构期间不再下发控制帧
+    stop();
+
+    // 取消本执行器注册的恢复回调（等待进行中的恢复结束），之后不再重新使能电机
+    CanHealth::clearResumeHandler(this);
+
+    // 丢弃尚未发出的控制帧，避免排在停止命令之后
+    CanTx::cancel();
 
     // 停止所有电机
     for (int i = 1; i <= SR6CANServoNum; i++) {
@@ -137,7 +161,7 @@ void SR6CANExecutor::compute() {
     
     // 从tcode中获取插值后的轴值
     // 插值结果顺序为：L0, L1, L2, R0, R1, R2
-    float* interpolated = tcode.interpolate();
+    float* interpolated = tickAxis();
     float roll, pitch, x, y, z;
 
     // 处理 thrust (L0)
@@ -180,16 +204,15 @@ void SR6CANExecutor::compute() {
     z = map_(z, 0.0f, 1.0f, -3000.0f, 3000.0f);
     z *= m_setting->servo.L2_SCALE;
 
-    auto roll_sin = sinf(roll / 100.0f / 180.0f * M_PI);
+    auto roll_sin = fast_math::sin(roll / 100.0f / 180.0f * fast_math::kPi);
     auto d = (18000.0f) / 2.0f;
     auto y__ = y;
     auto x__ = x;
     auto z__ = z;
     auto roll__ = roll;
     auto pitch__ = pitch;
-    float rub;
-    axis7_to_axis6(x__, y__ + EXTENSION_LENGTH, z__, roll__ / 100.0f,
-                   pitch__ / 100.0f, 0, x, y, z, roll, pitch, rub);
+    axis7_to_axis6_no_twist(x__, y__ + EXTENSION_LENGTH, z__, roll__ / 100.0f,
+                            pitch__ / 100.0f, x, y, z, roll, pitch);
     roll *= 100.0f;
     pitch *= 100.0f;
     float lowerLeftValue, upperLeftValue, pitchLeftValue, pitchRightValue,
@@ -221,9 +244,9 @@ void SR6CANExecutor::compute() {
 }
 
 void SR6CANExecutor::execute() {
-    static double last_motor_position[SR6CANServoNum] = {0.0};
+    static float last_motor_position[SR6CANServoNum] = {0.0f};
     std::lock_guard<std::mutex> lock(compute_mutex_);
-    std::lock_guard<std::mutex> feedback_lock(feedback_mutex_);
+    twai_message_t frames[SR6CANArrLen * 2];  // 控制帧 + 反馈请求
 
     for (int i = 0; i < SR6CANServoNum; i++) {
         motor_position[i] *= 1.33f;
@@ -233,30 +256,53 @@ void SR6CANExecutor::execute() {
         if (i > 2) {
             motor_position[i] *= -1.0f;
         }
-        // 使用PID控制器计算I控制输出（前馈）
-        // float pid_output = pid_update(&motor_pid[i], motor_position[i],
-        //                               motor_position_feedback[i]);
-        // static int j = 0;
-        // if (j++ % 100 == 0)
-        //     ESP_LOGD(TAG, "motor_pid[0].integral: %f", motor_pid[0].integral);
-
-        // ESP_LOGD(TAG, "motor_position[%d]: %f, feedback: %f, pid_output: %f",
-        //          i, motor_position[i] / M_PI * 180.0f,
-        //          motor_position_feedback[i] / M_PI * 180.0f,
-        //          pid_output);
+    }
+
+    // CAN总线恢复期间保持，不下发控制帧（插值照常推进）；
+    // 恢复后从电机实测位置起步，经限幅器按限速/限加速度追上目标，避免跳变
+    if (!CanHealth::streaming()) {
+        return;
+    }
+    uint32_t generation = CanHealth::generation();
+    if (generation != can_generation_) {
+        can_generation_ = generation;
+        resyncJoints();
+    }
+    limitJoints(motor_position);
 
+    // 轨迹目标加上offset（全程单精度，避免软件模拟double）
+    float targets[SR6CANArrLen];
+    float positions[SR6CANArrLen];
+    float velocities[SR6CANArrLen] = {};
+    float torques[SR6CANArrLen] = {};
+    for (int i = 0; i < SR6CANServoNum; i++) {
+        targets[i] =
+            motor_position[i] + motor_offset[i] * (fast_math::kPi / 180.0f);
+        positions[i] = targets[i];
+    }
+#if SR6CAN_FEEDFORWARD
+    feedForward(targets, positions, velocities, torques);
+#endif
+
+    for (int i = 0; i < SR6CANServoNum; i++) {
         MIT::MotorControl status;
-        status.position =
-            motor_position[i] +
-            motor_offset[i] / 180.0f * M_PI;  // 使用原始目标位置加上offset
-        status.velocity = 0.0f;
+        status.position = positions[i];
+        status.velocity = velocities[i];
         status.kp = motor_kp[i];  // 从数组中获取PD控制的P参数
         status.kd = motor_kd[i];  // 从数组中获取PD控制的D参数
-        // status.torque = pid_output / 1;  // PID的I输出作为前馈
-        status.torque = 0.0f;
-        MIT::dynamic_control(i + 1, status);
+        status.torque = torques[i];
+        MIT::build_dynamic_control_frame(i + 1, status, frames[i]);
         last_motor_position[i] = motor_position[i];
     }
+    // 反馈请求按负载预算占用本节拍剩余时隙，轮流发给各电机
+    size_t count = SR6CANServoNum +
+                   CanSchedule::feedbackRequests(frames + SR6CANServoNum,
+                                                 SR6CANServoNum);
+    // 整组帧一次提交，由CanTx任务发送，总线繁忙时同一ID的旧帧被合并
+    CanTx::submit(frames, count);
+    // 记录轨迹目标（含offset，不含前馈超前量），与CAN反馈的电机位置同一参考，
+    // 离线计算的跟踪误差即新反馈样本与该节拍目标之差（同TrackingFeedForward）
+    recordJoints(targets);
     static int t = 0;
     if (t++ % getExecuteFrequency() == 0) {
         for (size_t i = 0; i < SR6CANServoNum; i++) {
@@ -266,44 +312,149 @@ void SR6CANExecutor::execute() {
     }
 }
 
+bool SR6CANExecutor::getJointFeedback(float* measured, size_t count) {
+    float all[SR6CANServoNum];
+    int64_t sample_us[SR6CANServoNum];
+    readFeedback(all, sample_us);
+    for (size_t i = 0; i < count && i < SR6CANServoNum; i++) {
+        measured[i] = all[i];
+    }
+    return true;
+}
+
+void SR6CANExecutor::readFeedback(float* measured, int64_t* sample_us) {
+    for (size_t i = 0; i < SR6CANServoNum; i++) {
+        // 编码器估算帧（cmd 9）：位置、速度各为小端float
+        // 尚未收到该电机的反馈帧时记为NaN
+        CanRx::Frame frame;
+        if (CanRx::read(i + 1, MIT::CMD_GET_ENCODER_ESTIMATES, frame) &&
+            frame.len >= 4) {
+            memcpy(&measured[i], frame.data, 4);
+            sample_us[i] = frame.timestamp_us;
+        } else {
+            measured[i] = NAN;
+            sample_us[i] = 0;
+        }
+    }
+}
+
+#if SR6CAN_FEEDFORWARD
+void SR6CANExecutor::feedForward(const float* targets, float* positions,
+                                 float* velocities, float* torques) {
+    tracking_.apply(targets, positions, velocities);
+
+    float measured[SR6CANServoNum];
+    int64_t sample_us[SR6CANServoNum];
+    float aligned[SR6CANServoNum];
+    readFeedback(measured, sample_us);
+    tracking_.observe(measured, sample_us, esp_timer_get_time(), aligned);
+
+#if SR6CAN_FF_INTEGRAL
+    // 误差取电机此刻应到达的位置（已扣除滞后）与实测之差，只校正静差，
+    // 不与滞后补偿重复；每个新反馈样本按距上个样本的实际间隔积分一次
+    const float integral_max = SR6CAN_FF_TORQUE_MAX / SR6CAN_FF_KI;
+    for (int i = 0; i < SR6CANServoNum; i++) {
+        if (!tracking_.active()) {
+            ff_integral_[i] = 0.0f;
+            ff_sample_us_[i] = 0;
+        } else if (!std::isnan(aligned[i])) {
+            if (ff_sample_us_[i] != 0) {
+                float dt = (sample_us[i] - ff_sample_us_[i]) * 1e-6f;
+                dt = dt > SR6CAN_FF_MAX_DT_S ? SR6CAN_FF_MAX_DT_S : dt;
+                float integral =
+                    ff_integral_[i] + (aligned[i] - measured[i]) * dt;
+                if (integral > integral_max) {
+                    integral = integral_max;
+                } else if (integral < -integral_max) {
+                    integral = -integral_max;
+                }
+                ff_integral_[i] = integral;
+            }
+            ff_sample_us_[i] = sample_us[i];
+        }
+        torques[i] = SR6CAN_FF_KI * ff_integral_[i];
+    }
+#endif
+}
+#endif
+
+bool SR6CANExecutor::idleSkipAllowed() const {
+    return CanHealth::generation() == can_generation_;
+}
+
+void SR6CANExecutor::resyncJoints() {
+    float measured[SR6CANServoNum];
+    getJointFeedback(measured, SR6CANServoNum);
+    // 反馈含offset，限幅器工作在去掉offset的目标上；未收到反馈的电机为NaN，保持原起点
+    for (int i = 0; i < SR6CANServoNum; i++) {
+        measured[i] -= motor_offset[i] * (fast_math::kPi / 180.0f);
+    }
+    resetJoints(measured);
+#if SR6CAN_FEEDFORWARD
+    // 中断期间的历史与积分不再有效
+    tracking_.reset();
+#if SR6CAN_FF_INTEGRAL
+    for (int i = 0; i < SR6CANServoNum; i++) {
+        ff_integral_[i] = 0.0f;
+        ff_sample_us_[i] = 0;
+    }
+#endif
+#endif
+    ESP_LOGI(TAG, "CAN已恢复，从实测位置重新起步");
+}
+
+esp_err_t SR6CANExecutor::resumeMotors(void* arg) {
+    // 丢弃故障前排队的控制帧
+    CanTx::cancel();
+
+    // 所有电机并行清除异常并进入闭环；超时、未发出或清除后仍有异常的节点
+    // 均返回错误，由健康监测任务计为恢复失败并重试
+    MIT::BringUpResult result;
+    return MIT::bring_up(SR6CANNodeMask, MIT::AXIS_STATE_CLOSED_LOOP_CONTROL,
+                         true, MIT_BRING_UP_TIMEOUT_MS, result);
+}
+
 int SR6CANExecutor::getExecuteFrequency() const {
-    return m_setting->servo.A_SERVO_PWM_FREQ;
+    // 可能已按总线负载预算降低
+    return 1000000 / m_tick_period_us;
 }
 
 void SR6CANExecutor::initMotors() {
-    // 启动所有电机
-    for (int i = 1; i <= SR6CANServoNum; i++) {
-        // esp_err_t ret = MIT::start_motor(i);
-        esp_err_t ret = MIT::stop_motor(i);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "启动电机 %d 失败: %s", i, esp_err_to_name(ret));
-        }
-        vTaskDelay(pdMS_TO_TICKS(100));
+    // 所有电机并行进入空闲状态，响应经CanRx同时等待（超时节点由MIT打印）
+    MIT::BringUpResult result;
+    esp_err_t ret = MIT::bring_up(SR6CANNodeMask, MIT::AXIS_STATE_IDLE, false,
+                                  MIT_BRING_UP_TIMEOUT_MS, result);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG,
+                 "电机启动未全部成功: %s (未发出0x%llx, 超时0x%llx, 异常0x%llx)",
+                 esp_err_to_name(ret), (unsigned long long)result.unsent,
+                 (unsigned long long)result.late,
+                 (unsigned long long)result.faulted);
     }
 }
 
 float SR6CANExecutor::SetMainServo(float x, float y) {
     x /= 100.0f;
     y /= 100.0f;
-    float gamma = atan2f(x, y);
+    float gamma = fast_math::atan2(x, y);
     float csq = x * x + y * y;
-    float c = sqrtf(csq);
-    float beta = acosf((csq + 105.0f * 105.0f - 270.0f * 270.0f) / (2.0f * 105.0f * c));
-    float result = (gamma + beta - M_PI);
+    float c = fast_math::sqrt(csq);
+    float beta = fast_math::acos((csq + 105.0f * 105.0f - 270.0f * 270.0f) / (2.0f * 105.0f * c));
+    float result = (gamma + beta - fast_math::kPi);
     return result;
 }
 
 float SR6CANExecutor::SetPitchServo(float x, float y, float z, float pitch) {
     pitch *= 0.0001745f;            // 角度转换为弧度
-    x += 8300.0f * sinf(0.0f + pitch);  // 0.2618rad=15度
-    y -= 8300.0f * cosf(0.0f + pitch);
+    x += 8300.0f * fast_math::sin(0.0f + pitch);  // 0.2618rad=15度
+    y -= 8300.0f * fast_math::cos(0.0f + pitch);
     x /= 100.0f;
     y /= 100.0f;
     z /= 100.0f;
     float bsq = 280.0f * 280.0f - (63.0f + z) * (63.0f + z);
-    float gamma = atan2f(x, y);
+    float gamma = fast_math::atan2(x, y);
     float csq = x * x + y * y;
-    float c = sqrtf(csq);
+    float c = fast_math::sqrt(csq);
     float acos_arg = (csq + 105.0f * 105.0f - bsq) / (2.0f * 105.0f * c);
     // 约束acos参数到[-1, 1]范围，避免nan
     if (acos_arg > 1.0f) {
@@ -311,83 +462,7 @@ float SR6CANExecutor::SetPitchServo(float x, float y, float z, float pitch) {
     } else if (acos_arg < -1.0f) {
         acos_arg = -1.0f;
     }
-    float beta = acosf(acos_arg);
-    float result = (gamma + beta - M_PI);
+    float beta = fast_math::acos(acos_arg);
+    float result = (gamma + beta - fast_math::kPi);
     return result;
 }
-
-void SR6CANExecutor::canReceiveTask(void* param) {
-    SR6CANExecutor* self = static_cast<SR6CANExecutor*>(param);
-
-    while (!self->init_done) {
-        vTaskDelay(pdMS_TO_TICKS(1));
-    }
-
-    ESP_LOGI(self->TAG, "CAN接收任务启动");
-    
-    // 检查TWAI状态
-    if (!TWAI::is_initialized() || !TWAI::is_started()) {
-        ESP_LOGE(self->TAG, "TWAI未初始化或未启动，CAN接收任务退出");
-        vTaskDelete(nullptr);
-        return;
-    }
-    
-    // int count = 0;
-    // int64_t last_time = esp_timer_get_time() / 1000;  // 记录上一次统计时间（毫秒）
-    int timeout_count = 0;  // 超时计数器，避免频繁打印
-    int loop_count = 0;  // 循环计数器，用于调试
-    while (1) {
-        loop_count++;
-        uint32_t id;
-        uint8_t data[8];
-        uint8_t data_len;
-        bool is_extended;
-
-        // 调用twai::receive函数接收CAN消息
-        esp_err_t result =
-            TWAI::receive(&id, data, &data_len, &is_extended, 100);
-        
-        // 每1000次循环打印一次，确认任务在运行
-        if (loop_count % 1000 == 0) {
-            ESP_LOGD(self->TAG, "CAN接收任务运行中，循环次数: %d", loop_count);
-        }
-
-        if (result == ESP_OK) {
-            timeout_count = 0;  // 重置超时计数器
-            int node_id = id >> 5;
-            // ESP_LOGD(self->TAG, "node_id: %d", node_id);
-            int cmd_id = id & 0x1F;
-            switch (cmd_id) {
-                case 9:
-                    // count++;
-                    // 位置速度
-                    float pos;
-                    memcpy(&pos, data, 4);
-                    float vel;
-                    memcpy(&vel, data + 4, 4);
-                    {
-                        std::lock_guard<std::mutex> lock(self->feedback_mutex_);
-                        if (node_id >= 1 && node_id <= SR6CANServoNum) {
-                            self->motor_position_feedback[node_id - 1] = pos;
-                        }
-                    }
-                    break;
-            }
-        } else if (result == ESP_ERR_TIMEOUT) {
-            // 超时是正常的，继续循环
-            timeout_count++;
-            // 每10次超时打印一次，避免频繁打印
-            if (timeout_count % 10 == 0) {
-                ESP_LOGI(self->TAG, "CAN接收超时 (连续%d次)", timeout_count);
-            }
-            // 让出CPU，避免饿死其他任务
-            vTaskDelay(pdMS_TO_TICKS(1));
-        } else {
-            // 其他错误
-            timeout_count = 0;  // 重置超时计数器
-            ESP_LOGE(self->TAG, "CAN接收错误: %s", esp_err_to_name(result));
-            vTaskDelay(pdMS_TO_TICKS(10));  // 错误时稍作延时
-        }
-    }
-}
-
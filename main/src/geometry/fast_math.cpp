@@ -0,0 +1,171 @@
+#include "geometry/fast_math.hpp"
+
+#include <cmath>
+
+#include "esp_cpu.h"
+#include "esp_log.h"
+
+namespace fast_math {
+
+namespace {
+
+const char *TAG = "fast_math";
+
+constexpr int kSamples = 2000;
+
+volatile float g_sink = 0.0f;  // 防止基准循环被优化掉
+
+struct Result {
+    double max_err;
+    uint32_t fast_cycles;
+    uint32_t libm_cycles;
+};
+
+template <typename Fast, typename Libm, typename Input>
+Result measure(Fast fast, Libm libm, Input input) {
+    Result r = {0.0, 0, 0};
+
+    // 精度：与libm（double）对比
+    for (int i = 0; i < kSamples; i++) {
+        float a, b;
+        input(i, a, b);
+        double err = std::fabs((double)fast(a, b) - (double)libm(a, b));
+        if (err > r.max_err) {
+            r.max_err = err;
+        }
+    }
+
+    // 耗时：同一组输入分别跑一遍
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < kSamples; i++) {
+        float a, b;
+        input(i, a, b);
+        g_sink = fast(a, b);
+    }
+    r.fast_cycles = (esp_cpu_get_cycle_count() - start) / kSamples;
+
+    start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < kSamples; i++) {
+        float a, b;
+        input(i, a, b);
+        g_sink = libm(a, b);
+    }
+    r.libm_cycles = (esp_cpu_get_cycle_count() - start) / kSamples;
+    return r;
+}
+
+struct FastOps {
+    static float sin(float x) { return fast_math::sin(x); }
+    static float cos(float x) { return fast_math::cos(x); }
+    static float atan2(float y, float x) { return fast_math::atan2(y, x); }
+    static float acos(float x) { return fast_math::acos(x); }
+    static float sqrt(float x) { return fast_math::sqrt(x); }
+};
+
+struct LibmOps {
+    static float sin(float x) { return sinf(x); }
+    static float cos(float x) { return cosf(x); }
+    static float atan2(float y, float x) { return atan2f(y, x); }
+    static float acos(float x) { return acosf(x); }
+    static float sqrt(float x) { return sqrtf(x); }
+};
+
+float clampUnit(float x) { return x < -1.0f ? -1.0f : (x > 1.0f ? 1.0f : x); }
+
+/**
+ * 与SR6Executor::compute()相同的调用组合：roll的sin、4个主舵机
+ * (atan2+sqrt+acos)、2个俯仰舵机(sin+cos+atan2+sqrt+acos)，返回6个舵机角之和
+ */
+template <typename M>
+float sr6Tick(float u, float v) {
+    float x = 162.48f - 30.0f + 60.0f * u;  // mm
+    float y = -60.0f + 120.0f * v;
+    float roll_sin = M::sin(-0.4f + 0.8f * u);
+    float d = 68.5f * roll_sin;
+    auto main = [](float mx, float my) {
+        float csq = mx * mx + my * my;
+        float c = M::sqrt(csq);
+        return M::atan2(mx, my) + M::acos(clampUnit((csq - 28125.0f) / (100.0f * c))) - kPi;
+    };
+    auto pitch = [](float px, float py, float pz, float p) {
+        px += 55.0f * M::sin(0.2618f + p);
+        py -= 55.0f * M::cos(0.2618f + p);
+        float bsq = 36250.0f - (75.0f + pz) * (75.0f + pz);
+        float csq = px * px + py * py;
+        float c = M::sqrt(csq);
+        return M::atan2(px, py) +
+               M::acos(clampUnit((csq + 75.0f * 75.0f - bsq) / (150.0f * c))) - kPi;
+    };
+    float z = -30.0f + 60.0f * v;
+    float p = -0.4f + 0.8f * v;
+    return main(x, 15.0f + y + d) + main(x, 15.0f + y - d) +
+           main(x, 15.0f - y - d) + main(x, 15.0f - y + d) +
+           pitch(x, 45.0f - y - d, z - 55.0f * roll_sin, p) +
+           pitch(x, 45.0f - y + d, -(z - 55.0f * roll_sin), p);
+}
+
+void report(const char *name, const Result &r) {
+    ESP_LOGI(TAG, "%-6s max_err=%.3g  fast=%lu cycles  libm=%lu cycles", name,
+             r.max_err, (unsigned long)r.fast_cycles,
+             (unsigned long)r.libm_cycles);
+}
+
+}  // namespace
+
+void selfTest() {
+    ESP_LOGI(TAG, "fast_math self test (FAST_MATH_ENABLE=%d, %d samples)",
+             FAST_MATH_ENABLE, kSamples);
+
+    // sin/cos：俯仰角和roll角域，约±pi
+    auto angle = [](int i, float &a, float &b) {
+        a = -kPi + kTwoPi * i / kSamples;
+        b = 0.0f;
+    };
+    report("sin", measure([](float a, float) { return fast_math::sin(a); },
+                          [](float a, float) { return sinf(a); }, angle));
+    report("cos", measure([](float a, float) { return fast_math::cos(a); },
+                          [](float a, float) { return cosf(a); }, angle));
+
+    // atan2：舵机支点到接收点的向量，单位mm，约100~300
+    report("atan2",
+           measure([](float y, float x) { return fast_math::atan2(y, x); },
+                   [](float y, float x) { return atan2f(y, x); },
+                   [](int i, float &a, float &b) {
+                       a = 100.0f + 200.0f * i / kSamples;
+                       b = -150.0f + 300.0f * ((i * 7) % kSamples) / kSamples;
+                   }));
+
+    // acos：余弦定理参数，已约束到[-1, 1]
+    report("acos", measure([](float a, float) { return fast_math::acos(a); },
+                           [](float a, float) { return acosf(a); },
+                           [](int i, float &a, float &b) {
+                               a = -1.0f + 2.0f * i / kSamples;
+                               b = 0.0f;
+                           }));
+
+    // asin：TrRMax摇臂高度比，已约束到[-1, 1]
+    report("asin", measure([](float a, float) { return fast_math::asin(a); },
+                           [](float a, float) { return asinf(a); },
+                           [](int i, float &a, float &b) {
+                               a = -1.0f + 2.0f * i / kSamples;
+                               b = 0.0f;
+                           }));
+
+    // sqrt：距离平方，约1e4~1e5 mm²
+    report("sqrt", measure([](float a, float) { return fast_math::sqrt(a); },
+                           [](float a, float) { return sqrtf(a); },
+                           [](int i, float &a, float &b) {
+                               a = 10000.0f + 90000.0f * i / kSamples;
+                               b = 0.0f;
+                           }));
+
+    // 单节拍运动学：6个舵机角，误差为6个角之和的误差
+    report("tick", measure([](float a, float b) { return sr6Tick<FastOps>(a, b); },
+                           [](float a, float b) { return sr6Tick<LibmOps>(a, b); },
+                           [](int i, float &a, float &b) {
+                               a = (float)i / kSamples;
+                               b = (float)((i * 7) % kSamples) / kSamples;
+                           }));
+}
+
+}  // namespace fast_math
@@ -0,0 +1,71 @@
+#include "geometry/lut2d.hpp"
+#include <cmath>
+#include <new>
+
+namespace geometry {
+
+bool Lut2D::build(const std::function<float(float, float)> &f, float x0,
+                  float x1, float y0, float y1, int nx, int ny) {
+  if (nx < 2 || ny < 2 || !(x1 > x0) || !(y1 > y0)) {
+    return false;
+  }
+
+  std::unique_ptr<int16_t[]> data(new (std::nothrow) int16_t[nx * ny]);
+  if (!data) {
+    return false;
+  }
+
+  float dx = (x1 - x0) / (nx - 1);
+  float dy = (y1 - y0) / (ny - 1);
+  for (int iy = 0; iy < ny; iy++) {
+    for (int ix = 0; ix < nx; ix++) {
+      float v = f(x0 + ix * dx, y0 + iy * dy) * LUT2D_SCALE;
+      // 非法值（NaN）按0处理，限幅到int16范围
+      if (!(v == v)) {
+        v = 0.0f;
+      }
+      if (v > 32767.0f) {
+        v = 32767.0f;
+      } else if (v < -32768.0f) {
+        v = -32768.0f;
+      }
+      data[iy * nx + ix] = static_cast<int16_t>(lroundf(v));
+    }
+  }
+
+  m_data = std::move(data);
+  m_x0 = x0;
+  m_x1 = x1;
+  m_y0 = y0;
+  m_y1 = y1;
+  m_nx = nx;
+  m_ny = ny;
+  m_inv_dx = 1.0f / dx;
+  m_inv_dy = 1.0f / dy;
+  return true;
+}
+
+float Lut2D::maxError(const std::function<float(float, float)> &f) const {
+  if (!m_data) {
+    return 0.0f;
+  }
+  float dx = (m_x1 - m_x0) / (m_nx - 1);
+  float dy = (m_y1 - m_y0) / (m_ny - 1);
+  float max_err = 0.0f;
+  for (int iy = 0; iy < m_ny - 1; iy++) {
+    for (int ix = 0; ix < m_nx - 1; ix++) {
+      float x = m_x0 + (ix + 0.5f) * dx;
+      float y = m_y0 + (iy + 0.5f) * dy;
+      float v;
+      if (lookup(x, y, v)) {
+        float err = std::fabs(v - f(x, y));
+        if (err > max_err) {
+          max_err = err;
+        }
+      }
+    }
+  }
+  return max_err;
+}
+
+} // namespace geometry
@@ -0,0 +1,142 @@
+#include "geometry/o6_solver.hpp"
+#include "geometry/fast_math.hpp"
+#include <cmath>
+
+namespace geometry {
+
+namespace {
+
+constexpr float kDegToRad = 3.14159265358979f / 180.0f;
+constexpr float kEpsilon = 1e-6f;
+
+inline Point3F sub(const Point3F &l, const Point3F &r) {
+  return {l[0] - r[0], l[1] - r[1], l[2] - r[2]};
+}
+
+inline float dot3(const Point3F &l, const Point3F &r) {
+  return l[0] * r[0] + l[1] * r[1] + l[2] * r[2];
+}
+
+inline float norm3(const Point3F &v) { return fast_math::sqrt(dot3(v, v)); }
+
+// Rotate (x, y, 0) around z by theta
+inline Point3F rotate_z(const Point3F &p, float theta) {
+  float c = std::cos(theta);
+  float s = std::sin(theta);
+  return {c * p[0] - s * p[1], s * p[0] + c * p[1], p[2]};
+}
+
+/**
+ * One side of the five-bar: rocker angle for the motor at `motor`
+ * @return false if the law-of-cosines argument is out of range (no solution)
+ */
+inline bool five_bar_side(const Point3F &motor, const Point3F &mid,
+                          float half_ab, float arm, float link,
+                          const Point3F &p, float &theta) {
+  float c = norm3(sub(p, motor));
+  float d = norm3(sub(p, mid));
+  if (c < kEpsilon) {
+    return false;
+  }
+  float arg1 = (arm * arm + c * c - link * link) / (2.0f * arm * c);
+  float arg2 = (half_ab * half_ab + c * c - d * d) / (2.0f * half_ab * c);
+  if (arg1 < -1.0f || arg1 > 1.0f || arg2 < -1.0f || arg2 > 1.0f) {
+    return false;
+  }
+  theta = fast_math::kPi - fast_math::acos(arg1) - fast_math::acos(arg2);
+  return true;
+}
+
+} // namespace
+
+O6BaseGeometry make_o6_base_geometry(float r, float arm, float link,
+                                     Point3F a, Point3F b) {
+  O6BaseGeometry base = {};
+  base.arm = arm;
+  base.link = link;
+  for (int i = 0; i < 3; i++) {
+    // Same as Ta0/Ta1/Ta2 in solve_robot_kinematics
+    float yaw = i * 2.0f * fast_math::kPi / 3.0f - fast_math::kPi / 6.0f;
+    base.a[i] = rotate_z(a, yaw);
+    base.b[i] = rotate_z(b, yaw);
+    for (int j = 0; j < 3; j++) {
+      base.mid[i][j] = (base.a[i][j] + base.b[i][j]) * 0.5f;
+    }
+    Point3F ab = sub(base.b[i], base.a[i]);
+    float len = std::sqrt(dot3(ab, ab));
+    base.k[i] = {ab[0] / len, ab[1] / len, ab[2] / len};
+    base.half_ab[i] = len * 0.5f;
+
+    float t = i * 2.0f * fast_math::kPi / 3.0f;
+    base.platform[i] = {r * std::cos(t), r * std::sin(t), 0.0f};
+  }
+  return base;
+}
+
+bool solve_robot_kinematics_f(const O6BaseGeometry &base, float x, float y,
+                              float z, float roll_deg, float pitch_deg,
+                              float yaw_deg, std::array<float, 6> &thetas) {
+  float roll = roll_deg * kDegToRad;
+  float pitch = pitch_deg * kDegToRad;
+  float yaw = yaw_deg * kDegToRad;
+  float cr = fast_math::cos(roll), sr = fast_math::sin(roll);
+  float cp = fast_math::cos(pitch), sp = fast_math::sin(pitch);
+  float cy = fast_math::cos(yaw), sy = fast_math::sin(yaw);
+
+  // Rotation matrix, ZYX order (see transform_3d::pose_to_homogeneous_matrix)
+  const float R[3][3] = {
+      {cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr},
+      {sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr},
+      {-sp, cp * sr, cp * cr}};
+
+  if (O6_OFFSET != 0) {
+    float x0 = R[0][0] * x + R[0][1] * y + R[0][2] * z;
+    float y0 = R[1][0] * x + R[1][1] * y + R[1][2] * z;
+    float z0 = R[2][0] * x + R[2][1] * y + R[2][2] * z + O6_OFFSET;
+    x = x0;
+    y = y0;
+    z = z0;
+  }
+
+  std::array<float, 6> result;
+  for (int i = 0; i < 3; i++) {
+    const Point3F &q = base.platform[i];
+    Point3F p = {R[0][0] * q[0] + R[0][1] * q[1] + x,
+                 R[1][0] * q[0] + R[1][1] * q[1] + y,
+                 R[2][0] * q[0] + R[2][1] * q[1] + z};
+
+    // Foot of the perpendicular from p onto line ab
+    const Point3F &k = base.k[i];
+    float t = dot3(sub(p, base.a[i]), k);
+    Point3F foot = {base.a[i][0] + t * k[0], base.a[i][1] + t * k[1],
+                    base.a[i][2] + t * k[2]};
+    Point3F m = sub(p, foot);
+    float m_len = norm3(m);
+    if (m_len < kEpsilon) {
+      return false;
+    }
+
+    // Rotate p around ab by the angle between m and +z. m is perpendicular
+    // to k, so Rodrigues reduces to m*cos + (k x m)*sin, and with
+    // angle = acos(m_z / |m|) the trig terms come straight from m.
+    float cos_a = m[2] / m_len;
+    float sin_a = fast_math::sqrt(1.0f - cos_a * cos_a);
+    Point3F kxm = {k[1] * m[2] - k[2] * m[1], k[2] * m[0] - k[0] * m[2],
+                   k[0] * m[1] - k[1] * m[0]};
+    Point3F p1 = {foot[0] + m[0] * cos_a + kxm[0] * sin_a,
+                  foot[1] + m[1] * cos_a + kxm[1] * sin_a,
+                  foot[2] + m[2] * cos_a + kxm[2] * sin_a};
+
+    if (!five_bar_side(base.a[i], base.mid[i], base.half_ab[i], base.arm,
+                       base.link, p1, result[i * 2]) ||
+        !five_bar_side(base.b[i], base.mid[i], base.half_ab[i], base.arm,
+                       base.link, p1, result[i * 2 + 1])) {
+      return false;
+    }
+  }
+
+  thetas = result;
+  return true;
+}
+
+} // namespace geometry
@@ -39,9 +39,10 @@ static void cpu_usage_event_to_json(char *buffer, size_t buffer_size,
            "{\"type\":\"cpu_usage\","
            "\"cpu_percent\":%.2f,"
            "\"free_heap\":%u,"
-           "\"total_heap\":%u}",
+           "\"total_heap\":%u,"
+           "\"motion_idle_percent\":%.1f}",
            data->cpu_usage_percent, (unsigned int)data->free_heap_size,
-           (unsigned int)data->total_heap_size);
+           (unsigned int)data->total_heap_size, data->motion_idle_percent);
 }
 
 /**
@@ -53,12 +54,15 @@ static void motion_stats_event_to_json(char *buffer, size_t buffer_size,
            "{\"type\":\"motion_stats\","
            "\"window\":%.1f,"
            "\"compute\":{\"avg_ms\":%.3f,\"stddev_ms\":%.3f,\"max_ms\":%.3f,\"freq\":%.2f},"
-           "\"execute\":{\"avg_ms\":%.3f,\"stddev_ms\":%.3f,\"max_ms\":%.3f,\"freq\":%.2f}}",
+           "\"execute\":{\"avg_ms\":%.3f,\"stddev_ms\":%.3f,\"max_ms\":%.3f,\"freq\":%.2f},"
+           "\"limit\":{\"vel\":%.1f,\"acc\":%.1f,\"jerk\":%.1f}}",
            data->window_seconds,
            data->compute_avg_ms, data->compute_stddev_ms,
            data->compute_max_ms, data->compute_freq,
            data->execute_avg_ms, data->execute_stddev_ms,
-           data->execute_max_ms, data->execute_freq);
+           data->execute_max_ms, data->execute_freq,
+           data->limit_velocity_percent, data->limit_accel_percent,
+           data->limit_jerk_percent);
 }
 
 /**
@@ -0,0 +1,141 @@
+#include "joint_limiter.hpp"
+#include "geometry/fast_math.hpp"
+#include <cmath>
+
+namespace {
+// 位置与速度的收敛阈值
+constexpr float kSettleEpsilon = 1e-5f;
+}  // namespace
+
+void JointLimiter::configure(size_t joints, const Limits &limits, float dt_s) {
+  m_count = joints > MAX_JOINTS ? MAX_JOINTS : joints;
+  m_limits = limits;
+  m_dt = dt_s;
+  m_inv_dt = dt_s > 0.0f ? 1.0f / dt_s : 0.0f;
+  m_initialized = false;
+  m_settled = true;
+}
+
+void JointLimiter::reset(const float *positions) {
+  for (size_t i = 0; i < m_count; i++) {
+    float pos = std::isnan(positions[i]) ? m_joints[i].pos : positions[i];
+    m_joints[i] = {pos, 0.0f, 0.0f};
+  }
+  m_initialized = true;
+  // 下一节拍需追赶目标，不允许静止跳过
+  m_settled = false;
+}
+
+void JointLimiter::apply(float *targets) {
+  if (m_count == 0 || m_dt <= 0.0f) {
+    return;
+  }
+
+  if (!m_initialized) {
+    for (size_t i = 0; i < m_count; i++) {
+      m_joints[i] = {targets[i], 0.0f, 0.0f};
+    }
+    m_initialized = true;
+    m_settled = true;
+    return;
+  }
+
+  const float v_max = m_limits.velocity;
+  const float a_max = m_limits.accel;
+  const float j_max = m_limits.jerk;
+  bool velocity_hit = false;
+  bool accel_hit = false;
+  bool jerk_hit = false;
+  bool settled = true;
+
+  for (size_t i = 0; i < m_count; i++) {
+    Joint &j = m_joints[i];
+    float e = targets[i] - j.pos;
+    float abs_e = std::fabs(e);
+
+    // 期望速度：不超过最大速度、能刹停、且本节拍不越过目标
+    // 限加加速度时减速度需要爬升时间，刹停距离为
+    // v^2 / (2a) + v * a / (2j)，解出v作为刹停速度
+    float v_abs = abs_e * m_inv_dt;
+    if (a_max > 0.0f) {
+      float v_brake;
+      if (j_max > 0.0f) {
+        float k = a_max * a_max / (2.0f * j_max);
+        v_brake = fast_math::sqrt(2.0f * a_max * abs_e + k * k) - k;
+      } else {
+        v_brake = fast_math::sqrt(2.0f * a_max * abs_e);
+      }
+      if (v_brake < v_abs) {
+        v_abs = v_brake;
+      }
+    }
+    if (v_max > 0.0f && v_abs > v_max) {
+      v_abs = v_max;
+      velocity_hit = true;
+    }
+    float v_des = e < 0.0f ? -v_abs : v_abs;
+
+    // 期望加速度，按加速度限制
+    float a = (v_des - j.vel) * m_inv_dt;
+    if (a_max > 0.0f) {
+      if (a > a_max) {
+        a = a_max;
+        accel_hit = true;
+      } else if (a < -a_max) {
+        a = -a_max;
+        accel_hit = true;
+      }
+    }
+
+    // 加速度变化率限制
+    if (j_max > 0.0f) {
+      float da_max = j_max * m_dt;
+      if (a - j.acc > da_max) {
+        a = j.acc + da_max;
+        jerk_hit = true;
+      } else if (j.acc - a > da_max) {
+        a = j.acc - da_max;
+        jerk_hit = true;
+      }
+    }
+
+    j.acc = a;
+    j.vel += a * m_dt;
+    j.pos += j.vel * m_dt;
+
+    // 离散误差导致越过目标时停在目标上
+    if ((targets[i] - j.pos) * e < 0.0f) {
+      j = {targets[i], 0.0f, 0.0f};
+    }
+
+    // 到达目标且速度为零时吸附，避免残余抖动
+    if (std::fabs(targets[i] - j.pos) < kSettleEpsilon &&
+        std::fabs(j.vel) * m_dt < kSettleEpsilon) {
+      j = {targets[i], 0.0f, 0.0f};
+    } else {
+      settled = false;
+    }
+    targets[i] = j.pos;
+  }
+
+  m_settled = settled;
+  m_ticks.fetch_add(1, std::memory_order_relaxed);
+  if (velocity_hit) {
+    m_velocity_hits.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (accel_hit) {
+    m_accel_hits.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (jerk_hit) {
+    m_jerk_hits.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+JointLimiter::Stats JointLimiter::takeStats() {
+  Stats stats;
+  stats.ticks = m_ticks.exchange(0, std::memory_order_relaxed);
+  stats.velocity_hits = m_velocity_hits.exchange(0, std::memory_order_relaxed);
+  stats.accel_hits = m_accel_hits.exchange(0, std::memory_order_relaxed);
+  stats.jerk_hits = m_jerk_hits.exchange(0, std::memory_order_relaxed);
+  return stats;
+}
@@ -1,4 +1,5 @@
 #include "analysis.h"
+#include "actuator/actuator_bank.hpp"
 #include "ble/ble.h"
 #include "ble/def.hpp" //不要注释掉！！！
 #include "decoy.hpp"
@@ -10,16 +11,19 @@
 #include "esp_vfs.h"
 #include "executor/executor_factory.hpp"
 #include "freertos/task.h"
+#include "geometry/fast_math.hpp"
 #include "globals.hpp"
 #include "handyplug/handy_handler.hpp"
 #include "http/def.hpp"
 #include "led.hpp"
 #include "mdns.hpp"
+#include "motion_stress.hpp"
 #include "sdkconfig.h"
 #include "select_thread.hpp"
 #include "setting.hpp"
 #include "spiffs.h"
 #include "stdio.h"
+#include "twai/mit_codec.hpp"
 #include "uart/uart.h"
 #include "uart/uart2.h"
 #include "uart/usb_monitor.hpp"
@@ -164,10 +168,37 @@ extern "C" void app_main(void) {
   // 使用VFS API列出根目录内容(别删)
   // list_root_directory();
 
+#if FAST_MATH_SELF_TEST
+  // 运动学快速数学库精度/耗时自检
+  fast_math::selfTest();
+#endif
+
+#if MIT_CODEC_SELF_TEST
+  // MIT控制帧float打包与原double实现逐帧对比
+  mit_codec::selfTest();
+#endif
+
   SettingWrapper setting;
   setting.loadFromFile();
+
+#if ACTUATOR_BANK_BENCHMARK
+  // 逐通道写入与ActuatorBank批量写入耗时对比（需在执行器占用LEDC之前运行）
+  {
+    const int pins[actuator::ActuatorBank::MAX_LANES] = {
+        setting->servo.A_SERVO_PIN, setting->servo.B_SERVO_PIN,
+        setting->servo.C_SERVO_PIN, setting->servo.D_SERVO_PIN,
+        setting->servo.E_SERVO_PIN, setting->servo.F_SERVO_PIN};
+    actuator::benchmarkActuatorBank(pins, setting->servo.A_SERVO_PWM_FREQ);
+  }
+#endif
+
   g_executor = ExecutorFactory::createExecutor(setting);
 
+#if MOTION_STRESS_TEST
+  // SPIFFS/Wi-Fi负载下的节拍最大耗时对比（CONFIG_MOTION_IRAM开/关各构建一次）
+  motion_stress_start();
+#endif
+
   // 所有模块初始化完成
   // 启动USB监控定时器（但USB监控要等到g_system_initialized=true后才控制LED）
   if (CONFIG_ENABLE_LED) {
@@ -0,0 +1,134 @@
+#include "motion_stress.hpp"
+#include <dirent.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+
+static const char *TAG = "MotionStress";
+
+namespace {
+
+constexpr UBaseType_t kStressPriority = 3;  // 低于执行器任务（5）
+constexpr size_t kChunkSize = 4096;
+constexpr size_t kPacketSize = 1024;
+constexpr uint32_t kPacketBurst = 8;  // 每次让出CPU前连续发送的报文数
+constexpr int64_t kReportPeriodUs = MOTION_STRESS_REPORT_SECONDS * 1000000LL;
+
+/**
+ * @brief 循环读取SPIFFS中的所有文件
+ */
+void spiffsTask(void *arg) {
+  static char buffer[kChunkSize];
+  uint64_t bytes = 0;
+  int64_t last_report = esp_timer_get_time();
+
+  while (true) {
+    DIR *dir = opendir("/spiffs");
+    if (dir == nullptr) {
+      ESP_LOGE(TAG, "Failed to open /spiffs, SPIFFS load stopped");
+      vTaskDelete(nullptr);
+      return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+      std::string path = std::string("/spiffs/") + entry->d_name;
+      FILE *f = fopen(path.c_str(), "rb");
+      if (f == nullptr) {
+        continue;
+      }
+      size_t n;
+      while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        bytes += n;
+      }
+      fclose(f);
+      // 每个文件后让出CPU，避免饿死空闲任务触发任务看门狗
+      vTaskDelay(1);
+    }
+    closedir(dir);
+
+    int64_t now = esp_timer_get_time();
+    if (now - last_report >= kReportPeriodUs) {
+      ESP_LOGI(TAG, "SPIFFS read: %.1f KB/s",
+               bytes / 1024.0f / ((now - last_report) / 1000000.0f));
+      bytes = 0;
+      last_report = now;
+    }
+    vTaskDelay(1);  // 目录为空时同样让出CPU
+  }
+}
+
+/**
+ * @brief 连续发送UDP广播报文
+ */
+void wifiTask(void *arg) {
+  int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock < 0) {
+    ESP_LOGE(TAG, "Failed to create socket, Wi-Fi load stopped");
+    vTaskDelete(nullptr);
+    return;
+  }
+  int broadcast = 1;
+  setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast));
+
+  struct sockaddr_in dest = {};
+  dest.sin_family = AF_INET;
+  dest.sin_port = htons(MOTION_STRESS_UDP_PORT);
+  dest.sin_addr.s_addr = htonl(INADDR_BROADCAST);
+
+  static uint8_t packet[kPacketSize];
+  memset(packet, 0x55, sizeof(packet));
+  uint32_t sent = 0;
+  uint32_t failed = 0;
+  int64_t last_report = esp_timer_get_time();
+
+  while (true) {
+    for (uint32_t i = 0; i < kPacketBurst; i++) {
+      if (sendto(sock, packet, sizeof(packet), 0, (struct sockaddr *)&dest,
+                 sizeof(dest)) == (int)sizeof(packet)) {
+        sent++;
+      } else {
+        failed++;
+        vTaskDelay(pdMS_TO_TICKS(10));  // 未联网或缓冲已满
+        break;
+      }
+    }
+
+    int64_t now = esp_timer_get_time();
+    if (now - last_report >= kReportPeriodUs) {
+      float seconds = (now - last_report) / 1000000.0f;
+      ESP_LOGI(TAG, "Wi-Fi UDP: %.0f packets/s (%.1f KB/s), %lu failed",
+               sent / seconds, sent * kPacketSize / 1024.0f / seconds,
+               (unsigned long)failed);
+      sent = 0;
+      failed = 0;
+      last_report = now;
+    }
+    vTaskDelay(1);
+  }
+}
+
+}  // namespace
+
+esp_err_t motion_stress_start(void) {
+  ESP_LOGW(TAG, "Motion stress test enabled: SPIFFS reads + UDP broadcast "
+                "to port %d",
+           MOTION_STRESS_UDP_PORT);
+
+  if (xTaskCreate(spiffsTask, "stress_spiffs", 4096, nullptr, kStressPriority,
+                  nullptr) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create SPIFFS stress task");
+    return ESP_FAIL;
+  }
+  if (xTaskCreate(wifiTask, "stress_wifi", 4096, nullptr, kStressPriority,
+                  nullptr) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create Wi-Fi stress task");
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
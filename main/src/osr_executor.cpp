@@ -7,7 +7,7 @@
 const char* OSRExecutor::TAG = "OSRExecutor";
 
 OSRExecutor::OSRExecutor(const SettingWrapper& setting)
-    : Executor(setting),
+    : PipelineExecutor(setting),
       m_servo_a_duty(0),
       m_servo_b_duty(0),
       m_servo_c_duty(0),
@@ -17,51 +17,30 @@ OSRExecutor::OSRExecutor(const SettingWrapper& setting)
         //TODO 暂时
         // m_setting.printServoSetting();
 
-        // 初始化LEDC定时器
-        if (!initLEDC()) {
-            ESP_LOGE(TAG, "Failed to initialize LEDC");
-            throw std::runtime_error("Failed to initialize LEDC");
+        // 创建LEDC舵机组（A-D按各自频率分配定时器，批量写入）
+        m_bank = std::make_unique<actuator::ActuatorBank>();
+        const int pins[4] = {
+            m_setting->servo.A_SERVO_PIN, m_setting->servo.B_SERVO_PIN,
+            m_setting->servo.C_SERVO_PIN, m_setting->servo.D_SERVO_PIN};
+        const int zeros[4] = {
+            m_setting->servo.A_SERVO_ZERO, m_setting->servo.B_SERVO_ZERO,
+            m_setting->servo.C_SERVO_ZERO, m_setting->servo.D_SERVO_ZERO};
+        const int freqs[4] = {
+            m_setting->servo.A_SERVO_PWM_FREQ, m_setting->servo.B_SERVO_PWM_FREQ,
+            m_setting->servo.C_SERVO_PWM_FREQ, m_setting->servo.D_SERVO_PWM_FREQ};
+        for (size_t i = 0; i < 4; i++) {
+            float offset = ((float)zeros[i] - 1500.0f) / 1000.0f;
+            m_bank->addLane(i, pins[i], (ledc_channel_t)(LEDC_CHANNEL_0 + i),
+                            freqs[i], offset);
+            if (pins[i] != -1) {
+                ESP_LOGI(TAG, "Servo %c initialized on GPIO %d, offset: %.3f",
+                         'A' + (int)i, pins[i], offset);
+            }
         }
 
-        // 创建舵机A执行器
-        if (m_setting->servo.A_SERVO_PIN != -1) {
-            float offset_a = ((float)m_setting->servo.A_SERVO_ZERO - 1500.0f) / 1000.0f;
-            m_servo_a = std::make_unique<actuator::LEDCActuator>(
-                m_setting->servo.A_SERVO_PIN, LEDC_CHANNEL_0, LEDC_TIMER_0,
-                m_setting->servo.A_SERVO_PWM_FREQ, offset_a);
-            ESP_LOGI(TAG, "Servo A initialized on GPIO %d, offset: %.3f",
-                     m_setting->servo.A_SERVO_PIN, offset_a);
-        }
-
-        // 创建舵机B执行器
-        if (m_setting->servo.B_SERVO_PIN != -1) {
-            float offset_b = ((float)m_setting->servo.B_SERVO_ZERO - 1500.0f) / 1000.0f;
-            m_servo_b = std::make_unique<actuator::LEDCActuator>(
-                m_setting->servo.B_SERVO_PIN, LEDC_CHANNEL_1, LEDC_TIMER_0,
-                m_setting->servo.B_SERVO_PWM_FREQ, offset_b);
-            ESP_LOGI(TAG, "Servo B initialized on GPIO %d, offset: %.3f",
-                     m_setting->servo.B_SERVO_PIN, offset_b);
-        }
-
-        // 创建舵机C执行器
-        if (m_setting->servo.C_SERVO_PIN != -1) {
-            float offset_c = ((float)m_setting->servo.C_SERVO_ZERO - 1500.0f) / 1000.0f;
-            m_servo_c = std::make_unique<actuator::LEDCActuator>(
-                m_setting->servo.C_SERVO_PIN, LEDC_CHANNEL_2, LEDC_TIMER_0,
-                m_setting->servo.C_SERVO_PWM_FREQ, offset_c);
-            ESP_LOGI(TAG, "Servo C initialized on GPIO %d, offset: %.3f",
-                     m_setting->servo.C_SERVO_PIN, offset_c);
-        }
-
-        // 创建舵机D执行器
-        if (m_setting->servo.D_SERVO_PIN != -1) {
-            float offset_d = ((float)m_setting->servo.D_SERVO_ZERO - 1500.0f) / 1000.0f;
-            m_servo_d = std::make_unique<actuator::LEDCActuator>(
-                m_setting->servo.D_SERVO_PIN, LEDC_CHANNEL_3, LEDC_TIMER_0,
-                m_setting->servo.D_SERVO_PWM_FREQ, offset_d);
-            ESP_LOGI(TAG, "Servo D initialized on GPIO %d, offset: %.3f",
-                     m_setting->servo.D_SERVO_PIN, offset_d);
-        }
+        // 舵机关节限幅（归一化目标值）
+        configureJoints(4, {SERVO_LIMIT_VELOCITY, SERVO_LIMIT_ACCEL,
+                            SERVO_LIMIT_JERK});
 
         // 回中 - 初始计算一次
         compute();
@@ -70,50 +49,23 @@ OSRExecutor::OSRExecutor(const SettingWrapper& setting)
     } catch (...) {
         ESP_LOGE(TAG, "Failed to construct OSRExecutor");
         // 清理已分配的资源
-        m_servo_a.reset();
-        m_servo_b.reset();
-        m_servo_c.reset();
-        m_servo_d.reset();
+        m_bank.reset();
         throw;
     }
 }
 
 OSRExecutor::~OSRExecutor() {
     ESP_LOGI(TAG, "~OSRExecutor() deconstructing...");
-    m_servo_a.reset();
-    m_servo_b.reset();
-    m_servo_c.reset();
-    m_servo_d.reset();
+    m_bank.reset();
     ESP_LOGI(TAG, "OSRExecutor destroyed");
 }
 
-bool OSRExecutor::initLEDC() {
-    esp_err_t ret;
-
-    // 配置LEDC定时器0
-    ledc_timer_config_t timer_conf = {
-        .speed_mode = LEDC_LOW_SPEED_MODE,
-        .duty_resolution = LEDC_TIMER_14_BIT,
-        .timer_num = LEDC_TIMER_0,
-        .freq_hz = static_cast<uint32_t>(m_setting->servo.A_SERVO_PWM_FREQ),
-        .clk_cfg = LEDC_AUTO_CLK,
-        .deconfigure = false,
-    };
-    ret = ledc_timer_config(&timer_conf);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "LEDC timer0 config failed: %s", esp_err_to_name(ret));
-        return false;
-    }
-
-    return true;
-}
-
 void OSRExecutor::compute() {
     std::lock_guard<std::mutex> lock(m_compute_mutex);
 
     // 从tcode中获取插值后的轴值
     // 插值结果顺序为：L0, L1, L2, R0, R1, R2
-    float* interpolated = tcode.interpolate();
+    float* interpolated = tickAxis();
     float stroke_input = interpolated[0];  // L0
     float roll_input = interpolated[4];    // R1
     float pitch_input = interpolated[5];   // R2
@@ -180,18 +132,13 @@ void OSRExecutor::compute() {
 void OSRExecutor::execute() {
     std::lock_guard<std::mutex> lock(m_compute_mutex);
 
-    // 将占空比应用到各个舵机
-    if (m_servo_a) {
-        m_servo_a->setTarget(m_servo_a_duty);
-    }
-    if (m_servo_b) {
-        m_servo_b->setTarget(m_servo_b_duty);
-    }
-    if (m_servo_c) {
-        m_servo_c->setTarget(m_servo_c_duty);
-    }
-    if (m_servo_d) {
-        m_servo_d->setTarget(m_servo_d_duty);
+    float targets[4] = {m_servo_a_duty, m_servo_b_duty, m_servo_c_duty, m_servo_d_duty};
+    limitJoints(targets);
+
+    // 将占空比批量写入各个舵机
+    if (m_bank) {
+        m_bank->setTargets(targets, 4);
     }
+    recordJoints(targets);
 }
 
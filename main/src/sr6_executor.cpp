@@ -1,109 +1,92 @@
 #include "executor/sr6_executor.hpp"
-#include "actuator/rmt_actuator.hpp"
+#include "actuator/rmt_servo_bank.hpp"
 #include "actuator/spi_actuator.hpp"
 #include "def.h"
 #include "driver/ledc.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "geometry/fast_math.hpp"
+#include "sdkconfig.h"
 #include "setting.hpp"
 #include "utils.hpp"
 #include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
+#if SR6_SPI_SERVO_BANK && defined(CONFIG_ENABLE_LED) && CONFIG_ENABLE_LED
+#error "SR6_SPI_SERVO_BANK needs SPI2_HOST, which the LED strip owns; disable CONFIG_ENABLE_LED"
+#endif
+
 const char *SR6Executor::TAG = "SR6Executor";
 
 SR6Executor::SR6Executor(const SettingWrapper &setting)
-    : Executor(setting), m_servo_a_duty(0), m_servo_b_duty(0),
+    : PipelineExecutor(setting), m_servo_a_duty(0), m_servo_b_duty(0),
       m_servo_c_duty(0), m_servo_d_duty(0), m_servo_e_duty(0),
       m_servo_f_duty(0), m_servo_g_duty(0) {
   try {
     ESP_LOGI(TAG, "SR6Executor() constructing...");
 
-    // 初始化LEDC定时器
-    if (!initLEDC()) {
-      ESP_LOGE(TAG, "Failed to initialize LEDC");
-      throw std::runtime_error("Failed to initialize LEDC");
-    }
-
-    // 创建舵机A执行器
-    if (m_setting->servo.A_SERVO_PIN != -1) {
-      float offset_a =
-          ((float)m_setting->servo.A_SERVO_ZERO - 1500.0f) / 1000.0f;
-      m_servo_a = std::make_unique<actuator::LEDCActuator>(
-          m_setting->servo.A_SERVO_PIN, LEDC_CHANNEL_0, LEDC_TIMER_0,
-          m_setting->servo.A_SERVO_PWM_FREQ, offset_a);
-      ESP_LOGI(TAG, "Servo A initialized on GPIO %d, offset: %.3f",
-               m_setting->servo.A_SERVO_PIN, offset_a);
-    }
-
-    // 创建舵机B执行器
-    if (m_setting->servo.B_SERVO_PIN != -1) {
-      float offset_b =
-          ((float)m_setting->servo.B_SERVO_ZERO - 1500.0f) / 1000.0f;
-      m_servo_b = std::make_unique<actuator::LEDCActuator>(
-          m_setting->servo.B_SERVO_PIN, LEDC_CHANNEL_1, LEDC_TIMER_0,
-          m_setting->servo.A_SERVO_PWM_FREQ, offset_b);
-      ESP_LOGI(TAG, "Servo B initialized on GPIO %d, offset: %.3f",
-               m_setting->servo.B_SERVO_PIN, offset_b);
+    // 创建LEDC舵机组（A-F按各自频率分配定时器，批量写入）
+    m_bank = std::make_unique<actuator::ActuatorBank>();
+    const int pins[6] = {
+        m_setting->servo.A_SERVO_PIN, m_setting->servo.B_SERVO_PIN,
+        m_setting->servo.C_SERVO_PIN, m_setting->servo.D_SERVO_PIN,
+        m_setting->servo.E_SERVO_PIN, m_setting->servo.F_SERVO_PIN};
+    const int zeros[6] = {
+        m_setting->servo.A_SERVO_ZERO, m_setting->servo.B_SERVO_ZERO,
+        m_setting->servo.C_SERVO_ZERO, m_setting->servo.D_SERVO_ZERO,
+        m_setting->servo.E_SERVO_ZERO, m_setting->servo.F_SERVO_ZERO};
+    const int freqs[6] = {
+        m_setting->servo.A_SERVO_PWM_FREQ, m_setting->servo.B_SERVO_PWM_FREQ,
+        m_setting->servo.C_SERVO_PWM_FREQ, m_setting->servo.D_SERVO_PWM_FREQ,
+        m_setting->servo.E_SERVO_PWM_FREQ, m_setting->servo.F_SERVO_PWM_FREQ};
+    size_t first_ledc = 0;
+#if SR6_SPI_SERVO_BANK
+    // 主舵机A-D使用SPI位流，E/F留在LEDC
+    float spi_offsets[4];
+    for (size_t i = 0; i < 4; i++) {
+      spi_offsets[i] = ((float)zeros[i] - 1500.0f) / 1000.0f;
     }
-
-    // 创建舵机C执行器
-    if (m_setting->servo.C_SERVO_PIN != -1) {
-      float offset_c =
-          ((float)m_setting->servo.C_SERVO_ZERO - 1500.0f) / 1000.0f;
-      m_servo_c = std::make_unique<actuator::LEDCActuator>(
-          m_setting->servo.C_SERVO_PIN, LEDC_CHANNEL_2, LEDC_TIMER_0,
-          m_setting->servo.A_SERVO_PWM_FREQ, offset_c);
-      ESP_LOGI(TAG, "Servo C initialized on GPIO %d, offset: %.3f",
-               m_setting->servo.C_SERVO_PIN, offset_c);
-    }
-
-    // 创建舵机D执行器
-    if (m_setting->servo.D_SERVO_PIN != -1) {
-      float offset_d =
-          ((float)m_setting->servo.D_SERVO_ZERO - 1500.0f) / 1000.0f;
-      m_servo_d = std::make_unique<actuator::LEDCActuator>(
-          m_setting->servo.D_SERVO_PIN, LEDC_CHANNEL_3, LEDC_TIMER_0,
-          m_setting->servo.A_SERVO_PWM_FREQ, offset_d);
-      ESP_LOGI(TAG, "Servo D initialized on GPIO %d, offset: %.3f",
-               m_setting->servo.D_SERVO_PIN, offset_d);
-    }
-
-    // 创建舵机E执行器
-    if (m_setting->servo.E_SERVO_PIN != -1) {
-      float offset_e =
-          ((float)m_setting->servo.E_SERVO_ZERO - 1500.0f) / 1000.0f;
-      m_servo_e = std::make_unique<actuator::LEDCActuator>(
-          m_setting->servo.E_SERVO_PIN, LEDC_CHANNEL_4, LEDC_TIMER_0,
-          m_setting->servo.A_SERVO_PWM_FREQ, offset_e);
-      ESP_LOGI(TAG, "Servo E initialized on GPIO %d, offset: %.3f",
-               m_setting->servo.E_SERVO_PIN, offset_e);
+    try {
+      m_spi_bank = std::make_unique<actuator::SPIServoBank>(
+          SPI2_HOST, pins, spi_offsets, 4, freqs[0]);
+      first_ledc = 4;
+      ESP_LOGI(TAG, "Servos A-D (SPI) initialized at %d Hz", freqs[0]);
+    } catch (const actuator::SPIServoBank::BusBusy &) {
+      // 总线仍被占用时A-D的引脚可能还属于占用者，不能回退到LEDC认领它们
+      ESP_LOGE(TAG, "SPI2 is owned by another driver, refusing to drive "
+                    "servos A-D");
+      throw;
+    } catch (const std::exception &e) {
+      ESP_LOGW(TAG, "SPI servo bank unavailable (%s), servos A-D use LEDC",
+               e.what());
     }
-
-    // 创建舵机F执行器
-    if (m_setting->servo.F_SERVO_PIN != -1) {
-      float offset_f =
-          ((float)m_setting->servo.F_SERVO_ZERO - 1500.0f) / 1000.0f;
-      m_servo_f = std::make_unique<actuator::LEDCActuator>(
-          m_setting->servo.F_SERVO_PIN, LEDC_CHANNEL_5, LEDC_TIMER_0,
-          m_setting->servo.A_SERVO_PWM_FREQ, offset_f);
-      // m_servo_f = std::make_unique<actuator::RMTActuator>(
-      //     m_setting->servo.F_SERVO_PIN, offset_f);
-      ESP_LOGI(TAG, "Servo F initialized on GPIO %d, offset: %.3f",
-               m_setting->servo.F_SERVO_PIN, offset_f);
+#endif
+    for (size_t i = first_ledc; i < 6; i++) {
+      float offset = ((float)zeros[i] - 1500.0f) / 1000.0f;
+      m_bank->addLane(i, pins[i], (ledc_channel_t)(LEDC_CHANNEL_0 + i),
+                      freqs[i], offset);
     }
 
-    // 创建舵机G执行器（使用SPI）
+    // 创建舵机G执行器（使用RMT）
     if (m_setting->servo.G_SERVO_PIN != -1) {
-      float offset_g =
+      const int pin_g = m_setting->servo.G_SERVO_PIN;
+      const float offset_g =
           ((float)m_setting->servo.G_SERVO_ZERO - 1500.0f) / 1000.0f;
-      m_servo_g = std::make_unique<actuator::RMTActuator>(
-          m_setting->servo.G_SERVO_PIN, offset_g);
-      ESP_LOGI(TAG, "Servo G (SPI) initialized on GPIO %d, offset: %.3f",
+      m_servo_g = std::make_unique<actuator::RMTServoBank>(
+          &pin_g, &offset_g, 1, m_setting->servo.G_SERVO_PWM_FREQ);
+      ESP_LOGI(TAG, "Servo G (RMT) initialized on GPIO %d, offset: %.3f",
                m_setting->servo.G_SERVO_PIN, offset_g);
     }
 
+#if SR6_KINEMATICS_LUT
+    buildKinematicsLUT();
+#endif
+
+    // A-F与G共7个关节
+    configureJoints(7, {SERVO_LIMIT_VELOCITY, SERVO_LIMIT_ACCEL,
+                        SERVO_LIMIT_JERK});
+
     // 回中 - 初始计算一次
     compute();
 
@@ -111,56 +94,31 @@ SR6Executor::SR6Executor(const SettingWrapper &setting)
   } catch (...) {
     ESP_LOGE(TAG, "Failed to construct SR6Executor");
     // 清理已分配的资源
-    m_servo_a.reset();
-    m_servo_b.reset();
-    m_servo_c.reset();
-    m_servo_d.reset();
-    m_servo_e.reset();
-    m_servo_f.reset();
+    m_bank.reset();
     m_servo_g.reset();
+#if SR6_SPI_SERVO_BANK
+    m_spi_bank.reset();
+#endif
     throw;
   }
 }
 
 SR6Executor::~SR6Executor() {
   ESP_LOGI(TAG, "~SR6Executor() deconstructing...");
-  m_servo_a.reset();
-  m_servo_b.reset();
-  m_servo_c.reset();
-  m_servo_d.reset();
-  m_servo_e.reset();
-  m_servo_f.reset();
+  m_bank.reset();
   m_servo_g.reset();
+#if SR6_SPI_SERVO_BANK
+  m_spi_bank.reset();
+#endif
   ESP_LOGI(TAG, "SR6Executor destroyed");
 }
 
-bool SR6Executor::initLEDC() {
-  esp_err_t ret;
-
-  // 配置LEDC定时器0
-  ledc_timer_config_t timer_conf = {
-      .speed_mode = LEDC_LOW_SPEED_MODE,
-      .duty_resolution = LEDC_TIMER_14_BIT,
-      .timer_num = LEDC_TIMER_0,
-      .freq_hz = static_cast<uint32_t>(m_setting->servo.A_SERVO_PWM_FREQ),
-      .clk_cfg = LEDC_AUTO_CLK,
-      .deconfigure = false,
-  };
-  ret = ledc_timer_config(&timer_conf);
-  if (ret != ESP_OK) {
-    ESP_LOGE(TAG, "LEDC timer0 config failed: %s", esp_err_to_name(ret));
-    return false;
-  }
-
-  return true;
-}
-
 void SR6Executor::compute() {
   std::lock_guard<std::mutex> lock(m_compute_mutex);
 
   // 从tcode中获取插值后的轴值
   // 插值结果顺序为：L0, L1, L2, R0, R1, R2
-  float* interpolated = tcode.interpolate();
+  float* interpolated = tickAxis();
   float y_input = interpolated[0];      // L0
   float x_input = interpolated[1];      // L1
   float z_input = interpolated[2];      // L2
@@ -223,7 +181,7 @@ void SR6Executor::compute() {
   z *= m_setting->servo.L2_SCALE;
 
   // 计算roll的sin值
-  float roll_sin = sinf(roll / 100.0f / 180.0f * M_PI);
+  float roll_sin = fast_math::sin(roll / 100.0f / 180.0f * M_PI);
 
   // 计算距离d
   float d = 13700.0f / 2.0f;
@@ -282,63 +240,154 @@ void SR6Executor::execute() {
 //              m_servo_e_duty, m_servo_f_duty, m_servo_g_duty);
 //   }
 
-  // 将占空比应用到各个舵机
-  if (m_servo_a) {
-    m_servo_a->setTarget(m_servo_a_duty);
-  }
-  if (m_servo_b) {
-    m_servo_b->setTarget(m_servo_b_duty);
-  }
-  if (m_servo_c) {
-    m_servo_c->setTarget(m_servo_c_duty);
-  }
-  if (m_servo_d) {
-    m_servo_d->setTarget(m_servo_d_duty);
-  }
-  if (m_servo_e) {
-    m_servo_e->setTarget(m_servo_e_duty);
+  float targets[7] = {m_servo_a_duty, m_servo_b_duty, m_servo_c_duty,
+                      m_servo_d_duty, m_servo_e_duty, m_servo_f_duty,
+                      m_servo_g_duty};
+  limitJoints(targets);
+
+  // 将占空比应用到各个舵机，A-F批量写入（A-D由SPI输出时LEDC组中未启用）
+#if SR6_SPI_SERVO_BANK
+  if (m_spi_bank) {
+    m_spi_bank->setTargets(targets, 4);
   }
-  if (m_servo_f) {
-    m_servo_f->setTarget(m_servo_f_duty);
+#endif
+  if (m_bank) {
+    m_bank->setTargets(targets, 6);
   }
   if (m_servo_g) {
-    m_servo_g->setTarget(m_servo_g_duty);
+    m_servo_g->setTargets(&targets[6], 1);
   }
+  recordJoints(targets);
 }
 
 float SR6Executor::setMainServo(float x, float y) {
+#if SR6_KINEMATICS_LUT
+  float value;
+  if (m_main_lut.lookup(x, y, value)) {
+    return value;
+  }
+#endif
+  return mainServoAnalytic(x, y);
+}
+
+float SR6Executor::setPitchServo(float x, float y, float z, float pitch) {
+#if SR6_KINEMATICS_LUT
+  return pitchServoAnalytic(x, y, z, pitch, &m_pitch_gamma_lut);
+#else
+  return pitchServoAnalytic(x, y, z, pitch, nullptr);
+#endif
+}
+
+float SR6Executor::mainServoAnalytic(float x, float y) {
   x /= 100.0f;
   y /= 100.0f; // Convert to mm
   float gamma =
-      atan2f(x, y); // Angle of line from servo pivot to receiver pivot
+      fast_math::atan2(x, y); // Angle of line from servo pivot to receiver pivot
   float csq =
       x * x +
       y * y; // Square of distance between servo pivot and receiver pivot
-  float c = sqrtf(csq); // Distance between servo pivot and receiver pivot
-  float beta = acosf(std::max(
+  float c = fast_math::sqrt(csq); // Distance between servo pivot and receiver pivot
+  float beta = fast_math::acos(std::max(
       -1.0f,
       std::min(1.0f, (csq - 28125.0f) /
                          (100.0f * c)))); // Angle between c-line and servo arm
   return gamma + beta - M_PI;             // Servo signal output, from neutral
 }
 
-float SR6Executor::setPitchServo(float x, float y, float z, float pitch) {
+float SR6Executor::pitchServoAnalytic(float x, float y, float z, float pitch,
+                                      const geometry::Lut2D *lut) {
   pitch *= 0.0001745f; // Convert to radians
-  x += 5500.0f * sinf(0.2618f + pitch);
-  y -= 5500.0f * cosf(0.2618f + pitch);
+  x += 5500.0f * fast_math::sin(0.2618f + pitch);
+  y -= 5500.0f * fast_math::cos(0.2618f + pitch);
   x /= 100.0f;
   y /= 100.0f;
   z /= 100.0f;                                      // Convert to mm
   float bsq = 36250.0f - (75.0f + z) * (75.0f + z); // Equivalent arm length
-  float gamma =
-      atan2f(x, y); // Angle of line from servo pivot to receiver pivot
+  float gamma;
+  if (lut == nullptr || !lut->lookup(x, y, gamma)) {
+    gamma =
+        fast_math::atan2(x, y); // Angle of line from servo pivot to receiver pivot
+  }
   float csq =
       x * x +
       y * y; // Square of distance between servo pivot and receiver pivot
-  float c = sqrtf(csq); // Distance between servo pivot and receiver pivot
-  float beta = acosf(std::max(
+  float c = fast_math::sqrt(csq); // Distance between servo pivot and receiver pivot
+  float beta = fast_math::acos(std::max(
       -1.0f, std::min(1.0f, (csq + 75.0f * 75.0f - bsq) /
                                 (2.0f * 75.0f *
                                  c)))); // Angle between c-line and servo arm
   return gamma + beta - M_PI;           // Servo signal output, from neutral
 }
+
+void SR6Executor::buildKinematicsLUT() {
+  std::lock_guard<std::mutex> lock(m_compute_mutex);
+  const auto &servo = m_setting->servo;
+
+  // 轴映射后的最大幅值（与compute中的映射一致，REVERSE不改变范围）
+  auto axisMax = [](float left, float right, float half, float scale) {
+    float a = std::fabs(map_(left, 0.0f, 1.0f, -half, half));
+    float b = std::fabs(map_(right, 0.0f, 1.0f, -half, half));
+    return std::max(a, b) * std::fabs(scale);
+  };
+  float x_max = axisMax(servo.L1_LEFT, servo.L1_RIGHT, 3000.0f, servo.L1_SCALE);
+  float y_max = axisMax(servo.L0_LEFT, servo.L0_RIGHT, 6000.0f, servo.L0_SCALE);
+  float roll_max =
+      axisMax(servo.R1_LEFT, servo.R1_RIGHT, 2500.0f, servo.R1_SCALE);
+
+  float roll_deg = std::min(90.0f, roll_max / 100.0f);
+  float roll_offset = 13700.0f / 2.0f * sinf(roll_deg / 180.0f * M_PI);
+  float y_span = y_max + roll_offset;
+
+  // 主舵机：setMainServo(16248 - x, 1500 ± y ± d*sin(roll))
+  float mx0 = 16248.0f - x_max, mx1 = 16248.0f + x_max;
+  float my0 = 1500.0f - y_span, my1 = 1500.0f + y_span;
+  // 俯仰舵机gamma：x/y按俯仰臂长5500平移（sin/cos均取±1）后除以100，
+  // 与俯仰角无关的保守范围
+  float px0 = (mx0 - 5500.0f) / 100.0f, px1 = (mx1 + 5500.0f) / 100.0f;
+  float py0 = (4500.0f - y_span - 5500.0f) / 100.0f;
+  float py1 = (4500.0f + y_span + 5500.0f) / 100.0f;
+
+  const int n = SR6_LUT_RESOLUTION;
+  auto gammaFunc = [](float x, float y) { return fast_math::atan2(x, y); };
+  int64_t start = esp_timer_get_time();
+  if (!m_main_lut.build(mainServoAnalytic, mx0, mx1, my0, my1, n, n) ||
+      !m_pitch_gamma_lut.build(gammaFunc, px0, px1, py0, py1, n, n)) {
+    ESP_LOGE(TAG, "Failed to build kinematics LUT, using analytic path");
+    m_main_lut = geometry::Lut2D();
+    m_pitch_gamma_lut = geometry::Lut2D();
+    return;
+  }
+  int64_t build_us = esp_timer_get_time() - start;
+
+  // 查表与解析路径的耗时对比（同一组采样点）
+  constexpr int kSamples = 256;
+  volatile float sink = 0.0f;
+  start = esp_timer_get_time();
+  for (int i = 0; i < kSamples; i++) {
+    float value;
+    m_main_lut.lookup(mx0 + (mx1 - mx0) * i / kSamples,
+                      my0 + (my1 - my0) * ((i * 7) % kSamples) / kSamples,
+                      value);
+    sink = value;
+  }
+  int64_t lut_us = esp_timer_get_time() - start;
+  start = esp_timer_get_time();
+  for (int i = 0; i < kSamples; i++) {
+    sink = mainServoAnalytic(mx0 + (mx1 - mx0) * i / kSamples,
+                             my0 + (my1 - my0) * ((i * 7) % kSamples) /
+                                       kSamples);
+  }
+  int64_t analytic_us = esp_timer_get_time() - start;
+  (void)sink;
+
+  ESP_LOGI(TAG,
+           "Kinematics LUT %dx%d built in %lld ms, memory %u bytes, max error "
+           "main=%.5f rad gamma=%.5f rad",
+           n, n, build_us / 1000,
+           (unsigned)(m_main_lut.memoryBytes() +
+                      m_pitch_gamma_lut.memoryBytes()),
+           m_main_lut.maxError(mainServoAnalytic),
+           m_pitch_gamma_lut.maxError(gammaFunc));
+  ESP_LOGI(TAG, "setMainServo per call: lut=%.2f us, analytic=%.2f us",
+           (float)lut_us / kSamples, (float)analytic_us / kSamples);
+}
@@ -0,0 +1,108 @@
+#include "telemetry.hpp"
+#include <cmath>
+#include <cstring>
+#include <new>
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "Telemetry";
+
+Telemetry &Telemetry::getInstance() {
+  static Telemetry instance;
+  return instance;
+}
+
+void Telemetry::begin(size_t joints, uint32_t tick_period_us) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t record_words = 1 + 2 * joints;
+  if (joints != m_joints || !m_ring) {
+    m_ring.reset();
+    m_ring.reset(new (std::nothrow)
+                     uint32_t[record_words * TELEMETRY_RING_TICKS]);
+    if (!m_ring) {
+      ESP_LOGE(TAG, "Failed to allocate %u bytes, telemetry disabled",
+               (unsigned)(record_words * TELEMETRY_RING_TICKS * 4));
+      m_joints = 0;
+      m_record_words = 0;
+      return;
+    }
+  }
+  m_joints = joints;
+  m_record_words = record_words;
+  m_tick_period_us = tick_period_us;
+  m_head = 0;
+  m_count = 0;
+  m_dropped.store(0, std::memory_order_relaxed);
+  ESP_LOGI(TAG, "Recording %u joints, %u ticks (%u bytes)", (unsigned)joints,
+           (unsigned)TELEMETRY_RING_TICKS,
+           (unsigned)(record_words * TELEMETRY_RING_TICKS * 4));
+}
+
+void Telemetry::record(const float *commanded, const float *measured,
+                       size_t joints) {
+  std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (!m_ring || joints != m_joints) {
+    return;
+  }
+
+  uint32_t *rec = &m_ring[m_head * m_record_words];
+  rec[0] = (uint32_t)esp_timer_get_time();
+  memcpy(rec + 1, commanded, m_joints * sizeof(float));
+  if (measured != nullptr) {
+    memcpy(rec + 1 + m_joints, measured, m_joints * sizeof(float));
+  } else {
+    const float nan = NAN;
+    for (size_t i = 0; i < m_joints; i++) {
+      memcpy(rec + 1 + m_joints + i, &nan, sizeof(float));
+    }
+  }
+
+  m_head = (m_head + 1) % TELEMETRY_RING_TICKS;
+  if (m_count < TELEMETRY_RING_TICKS) {
+    m_count++;
+  }
+}
+
+esp_err_t Telemetry::stream(Writer writer, void *arg) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_ring) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  telemetry_header_t header = {
+      .magic = TELEMETRY_MAGIC,
+      .version = TELEMETRY_VERSION,
+      .joints = (uint16_t)m_joints,
+      .records = (uint32_t)m_count,
+      .tick_period_us = m_tick_period_us,
+      .dropped = m_dropped.load(std::memory_order_relaxed),
+  };
+  esp_err_t ret = writer(arg, (const char *)&header, sizeof(header));
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  // 环形缓冲展开为时间顺序：最旧的记录在m_head（缓冲已满时）或0
+  size_t record_bytes = m_record_words * sizeof(uint32_t);
+  size_t oldest = m_count < TELEMETRY_RING_TICKS ? 0 : m_head;
+  size_t first = TELEMETRY_RING_TICKS - oldest;
+  if (first > m_count) {
+    first = m_count;
+  }
+  if (first > 0) {
+    ret = writer(arg, (const char *)&m_ring[oldest * m_record_words],
+                 first * record_bytes);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+  }
+  if (m_count > first) {
+    ret = writer(arg, (const char *)&m_ring[0],
+                 (m_count - first) * record_bytes);
+  }
+  return ret;
+}
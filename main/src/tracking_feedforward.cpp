@@ -0,0 +1,195 @@
+#include "tracking_feedforward.hpp"
+#include "esp_log.h"
+#include "geometry/fast_math.hpp"
+#include <cmath>
+
+static const char *TAG = "Tracking";
+
+void TrackingFeedForward::configure(size_t joints, float dt_s, bool ab_test) {
+  m_count = joints > MAX_JOINTS ? MAX_JOINTS : joints;
+  m_dt = dt_s;
+  m_inv_dt = dt_s > 0.0f ? 1.0f / dt_s : 0.0f;
+  m_ab_test = ab_test;
+  m_active = true;
+  m_gain = 0.0f;
+  m_window_start_us = 0;
+  m_rms_on = -1.0f;
+  m_rms_off = -1.0f;
+  for (size_t i = 0; i < m_count; i++) {
+    m_joints[i] = {};
+  }
+  reset();
+}
+
+void TrackingFeedForward::reset() {
+  m_tick = 0;
+  for (size_t i = 0; i < m_count; i++) {
+    Joint &j = m_joints[i];
+    j.last_target = NAN;
+    j.last_sample_us = 0;
+    j.lag_samples = 0;
+    for (float &c : j.cost) {
+      c = 0.0f;
+    }
+  }
+}
+
+void TrackingFeedForward::apply(const float *targets, float *positions,
+                                float *velocities) {
+  // 开关切换时按比例过渡，到达后保持在0或1（过渡节拍不计入RMS）
+  float step = TRACKING_RAMP_S > 0.0f ? m_dt / TRACKING_RAMP_S : 1.0f;
+  float goal = m_active ? 1.0f : 0.0f;
+  if (m_gain < goal) {
+    m_gain = m_gain + step < goal ? m_gain + step : goal;
+  } else if (m_gain > goal) {
+    m_gain = m_gain - step > goal ? m_gain - step : goal;
+  }
+
+  size_t slot = m_tick % HISTORY;
+  for (size_t i = 0; i < m_count; i++) {
+    Joint &j = m_joints[i];
+    float t = targets[i];
+    float v = std::isnan(j.last_target) ? 0.0f : (t - j.last_target) * m_inv_dt;
+    j.last_target = t;
+
+    float lead = j.lag_valid ? v * j.lag_ticks * m_dt : 0.0f;
+    positions[i] = t + m_gain * lead;
+    velocities[i] = m_gain * v;
+
+    j.target[slot] = t;
+    j.sent[slot] = positions[i];
+    j.velocity[slot] = v;
+  }
+  m_tick++;
+}
+
+void TrackingFeedForward::observe(const float *measured,
+                                  const int64_t *sample_us, int64_t now_us,
+                                  float *aligned) {
+  for (size_t i = 0; i < m_count; i++) {
+    Joint &j = m_joints[i];
+    aligned[i] = NAN;
+    if (std::isnan(measured[i]) || sample_us[i] == j.last_sample_us) {
+      continue;
+    }
+    j.last_sample_us = sample_us[i];
+
+    // 跟踪误差：新样本与本节拍（最近一次apply，m_tick - 1）的轨迹目标之差，
+    // 与遥测离线统计相同；开关过渡中的节拍既不属于开也不属于关，不计入RMS
+    size_t now_slot = (m_tick - 1) % HISTORY;
+    if (m_gain == 0.0f || m_gain == 1.0f) {
+      float e = measured[i] - j.target[now_slot];
+      j.sq_sum += e * e;
+      j.samples++;
+    }
+
+    // 反馈接收时刻对应的节拍，供滞后估计与积分对齐
+    int64_t age_us = now_us - sample_us[i];
+    uint32_t age = age_us > 0 ? (uint32_t)(age_us * m_inv_dt * 1e-6f + 0.5f) : 0;
+    if (age + TRACKING_LAG_MAX_TICKS + 1 > m_tick ||
+        age + TRACKING_LAG_MAX_TICKS >= HISTORY) {
+      continue;  // 历史不足或样本过旧
+    }
+    uint32_t k = m_tick - 1 - age;
+
+    if (j.lag_valid) {
+      uint32_t d = (uint32_t)(j.lag_ticks + 0.5f);
+      aligned[i] = j.sent[(k - d) % HISTORY];
+    }
+
+    if (std::fabs(j.velocity[k % HISTORY]) >= TRACKING_MIN_VELOCITY) {
+      for (uint32_t d = 0; d <= TRACKING_LAG_MAX_TICKS; d++) {
+        float ed = measured[i] - j.sent[(k - d) % HISTORY];
+        j.cost[d] += ed * ed;
+      }
+      if (++j.lag_samples >= TRACKING_LAG_SAMPLES) {
+        estimateLag(j);
+      }
+    }
+  }
+
+  if (m_window_start_us == 0) {
+    m_window_start_us = now_us;
+  } else if (now_us - m_window_start_us >= TRACKING_REPORT_MS * 1000ll) {
+    report(now_us);
+  }
+}
+
+void TrackingFeedForward::estimateLag(Joint &j) {
+  uint32_t best = 0;
+  for (uint32_t d = 1; d <= TRACKING_LAG_MAX_TICKS; d++) {
+    if (j.cost[d] < j.cost[best]) {
+      best = d;
+    }
+  }
+
+  // 抛物线插值到亚节拍
+  float lag = (float)best;
+  if (best > 0 && best < TRACKING_LAG_MAX_TICKS) {
+    float a = j.cost[best - 1];
+    float b = j.cost[best];
+    float c = j.cost[best + 1];
+    float denom = a - 2.0f * b + c;
+    if (denom > 0.0f) {
+      lag += 0.5f * (a - c) / denom;
+    }
+  }
+
+  j.lag_ticks = j.lag_valid ? j.lag_ticks + 0.25f * (lag - j.lag_ticks) : lag;
+  j.lag_valid = true;
+  j.lag_samples = 0;
+  for (float &c : j.cost) {
+    c = 0.0f;
+  }
+}
+
+void TrackingFeedForward::report(int64_t now_us) {
+  float window_s = (now_us - m_window_start_us) / 1000000.0f;
+  m_window_start_us = now_us;
+
+  float sq_sum = 0.0f;
+  uint32_t samples = 0;
+  float worst_rms = 0.0f;
+  size_t worst = 0;
+  float lag_max_ms = 0.0f;
+  for (size_t i = 0; i < m_count; i++) {
+    Joint &j = m_joints[i];
+    if (j.samples > 0) {
+      float rms = fast_math::sqrt(j.sq_sum / j.samples);
+      if (rms > worst_rms) {
+        worst_rms = rms;
+        worst = i;
+      }
+    }
+    sq_sum += j.sq_sum;
+    samples += j.samples;
+    j.sq_sum = 0.0f;
+    j.samples = 0;
+    if (j.lag_valid && j.lag_ticks * m_dt * 1000.0f > lag_max_ms) {
+      lag_max_ms = j.lag_ticks * m_dt * 1000.0f;
+    }
+  }
+  if (samples == 0) {
+    return;
+  }
+
+  float rms = fast_math::sqrt(sq_sum / samples);
+  if (m_active) {
+    m_rms_on = rms;
+  } else {
+    m_rms_off = rms;
+  }
+  ESP_LOGI(TAG,
+           "Tracking [%.1fs window] - ff=%s, rms=%.4f (worst joint %u: %.4f), "
+           "lag max=%.1f ms, samples=%lu",
+           window_s, m_active ? "on" : "off", rms, (unsigned)worst, worst_rms,
+           lag_max_ms, (unsigned long)samples);
+
+  if (m_ab_test) {
+    if (m_rms_on >= 0.0f && m_rms_off > 0.0f) {
+      ESP_LOGI(TAG, "Tracking rms ff off %.4f -> on %.4f (%+.0f%%)", m_rms_off,
+               m_rms_on, (m_rms_on / m_rms_off - 1.0f) * 100.0f);
+    }
+    m_active = !m_active;
+  }
+}
@@ -3,54 +3,44 @@
 #include "esp_log.h"
 #include "driver/ledc.h"
 #include "esp_timer.h"
+#include "geometry/fast_math.hpp"
 #include <stdexcept>
 #include <algorithm>
 
 const char* TrRMaxExecutor::TAG = "TrRMaxExecutor";
 
 TrRMaxExecutor::TrRMaxExecutor(const SettingWrapper& setting)
-    : Executor(setting),
+    : PipelineExecutor(setting),
       m_servo_a_duty(0),
       m_servo_b_duty(0),
       m_servo_c_duty(0) {
     try {
         ESP_LOGI(TAG, "TrRMaxExecutor() constructing...");
 
-        // 初始化LEDC定时器
-        if (!initLEDC()) {
-            ESP_LOGE(TAG, "Failed to initialize LEDC");
-            throw std::runtime_error("Failed to initialize LEDC");
+        // 创建LEDC舵机组（A-C按各自频率分配定时器，批量写入）
+        m_bank = std::make_unique<actuator::ActuatorBank>();
+        const int pins[3] = {
+            m_setting->servo.A_SERVO_PIN, m_setting->servo.B_SERVO_PIN,
+            m_setting->servo.C_SERVO_PIN};
+        const int zeros[3] = {
+            m_setting->servo.A_SERVO_ZERO, m_setting->servo.B_SERVO_ZERO,
+            m_setting->servo.C_SERVO_ZERO};
+        const int freqs[3] = {
+            m_setting->servo.A_SERVO_PWM_FREQ, m_setting->servo.B_SERVO_PWM_FREQ,
+            m_setting->servo.C_SERVO_PWM_FREQ};
+        for (size_t i = 0; i < 3; i++) {
+            float offset = ((float)zeros[i] - 1500.0f) / 1000.0f;
+            m_bank->addLane(i, pins[i], (ledc_channel_t)(LEDC_CHANNEL_0 + i),
+                            freqs[i], offset);
+            if (pins[i] != -1) {
+                ESP_LOGI(TAG, "Servo %c initialized on GPIO %d, offset: %.3f",
+                         'A' + (int)i, pins[i], offset);
+            }
         }
 
-        // 创建舵机A执行器
-        if (m_setting->servo.A_SERVO_PIN != -1) {
-            float offset_a = ((float)m_setting->servo.A_SERVO_ZERO - 1500.0f) / 1000.0f;
-            m_servo_a = std::make_unique<actuator::LEDCActuator>(
-                m_setting->servo.A_SERVO_PIN, LEDC_CHANNEL_0, LEDC_TIMER_0,
-                m_setting->servo.A_SERVO_PWM_FREQ, offset_a);
-            ESP_LOGI(TAG, "Servo A initialized on GPIO %d, offset: %.3f",
-                     m_setting->servo.A_SERVO_PIN, offset_a);
-        }
-
-        // 创建舵机B执行器
-        if (m_setting->servo.B_SERVO_PIN != -1) {
-            float offset_b = ((float)m_setting->servo.B_SERVO_ZERO - 1500.0f) / 1000.0f;
-            m_servo_b = std::make_unique<actuator::LEDCActuator>(
-                m_setting->servo.B_SERVO_PIN, LEDC_CHANNEL_1, LEDC_TIMER_0,
-                m_setting->servo.B_SERVO_PWM_FREQ, offset_b);
-            ESP_LOGI(TAG, "Servo B initialized on GPIO %d, offset: %.3f",
-                     m_setting->servo.B_SERVO_PIN, offset_b);
-        }
-
-        // 创建舵机C执行器
-        if (m_setting->servo.C_SERVO_PIN != -1) {
-            float offset_c = ((float)m_setting->servo.C_SERVO_ZERO - 1500.0f) / 1000.0f;
-            m_servo_c = std::make_unique<actuator::LEDCActuator>(
-                m_setting->servo.C_SERVO_PIN, LEDC_CHANNEL_2, LEDC_TIMER_0,
-                m_setting->servo.C_SERVO_PWM_FREQ, offset_c);
-            ESP_LOGI(TAG, "Servo C initialized on GPIO %d, offset: %.3f",
-                     m_setting->servo.C_SERVO_PIN, offset_c);
-        }
+        // 舵机关节限幅（归一化目标值）
+        configureJoints(3, {SERVO_LIMIT_VELOCITY, SERVO_LIMIT_ACCEL,
+                            SERVO_LIMIT_JERK});
 
         // 回中 - 初始计算一次
         compute();
@@ -59,42 +49,17 @@ TrRMaxExecutor::TrRMaxExecutor(const SettingWrapper& setting)
     } catch (...) {
         ESP_LOGE(TAG, "Failed to construct TrRMaxExecutor");
         // 清理已分配的资源
-        m_servo_a.reset();
-        m_servo_b.reset();
-        m_servo_c.reset();
+        m_bank.reset();
         throw;
     }
 }
 
 TrRMaxExecutor::~TrRMaxExecutor() {
     ESP_LOGI(TAG, "~TrRMaxExecutor() deconstructing...");
-    m_servo_a.reset();
-    m_servo_b.reset();
-    m_servo_c.reset();
+    m_bank.reset();
     ESP_LOGI(TAG, "TrRMaxExecutor destroyed");
 }
 
-bool TrRMaxExecutor::initLEDC() {
-    esp_err_t ret;
-
-    // 配置LEDC定时器0
-    ledc_timer_config_t timer_conf = {
-        .speed_mode = LEDC_LOW_SPEED_MODE,
-        .duty_resolution = LEDC_TIMER_14_BIT,
-        .timer_num = LEDC_TIMER_0,
-        .freq_hz = static_cast<uint32_t>(m_setting->servo.A_SERVO_PWM_FREQ),
-        .clk_cfg = LEDC_AUTO_CLK,
-        .deconfigure = false,
-    };
-    ret = ledc_timer_config(&timer_conf);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "LEDC timer0 config failed: %s", esp_err_to_name(ret));
-        return false;
-    }
-
-    return true;
-}
-
 void TrRMaxExecutor::compute() {
     std::lock_guard<std::mutex> lock(m_compute_mutex);
 
@@ -102,7 +67,7 @@ void TrRMaxExecutor::compute() {
 
     // 从tcode中获取插值后的轴值
     // 插值结果顺序为：L0, L1, L2, R0, R1, R2
-    float* interpolated = tcode.interpolate();
+    float* interpolated = tickAxis();
     float stroke_input = interpolated[0];  // L0
     float roll_input = interpolated[4];    // R1
     float pitch_input = interpolated[5];  // R2
@@ -140,11 +105,14 @@ void TrRMaxExecutor::compute() {
     float pitch_rad = pitch * M_PI / 180.0f;
 
     // 计算三个挂点的z高度偏移
-    float h1 = -R * sinf(roll_rad);
-    float h2 = (R / 2.0f) * sinf(roll_rad) +
-               (sqrtf(3.0f) / 2.0f * R) * cosf(roll_rad) * sinf(pitch_rad);
-    float h3 = (R / 2.0f) * sinf(roll_rad) -
-               (sqrtf(3.0f) / 2.0f * R) * cosf(roll_rad) * sinf(pitch_rad);
+    float sin_roll = fast_math::sin(roll_rad);
+    float cos_roll = fast_math::cos(roll_rad);
+    float sin_pitch = fast_math::sin(pitch_rad);
+    float h1 = -R * sin_roll;
+    float h2 = (R / 2.0f) * sin_roll +
+               (sqrtf(3.0f) / 2.0f * R) * cos_roll * sin_pitch;
+    float h3 = (R / 2.0f) * sin_roll -
+               (sqrtf(3.0f) / 2.0f * R) * cos_roll * sin_pitch;
 
     // 计算每个舵机的总z高度 = stroke高度 + roll/pitch反解的z高度
     float z_a = stroke + h2;
@@ -153,9 +121,9 @@ void TrRMaxExecutor::compute() {
 
     // 使用z=80*sin(theta)公式将z高度转换为舵机角度
     // theta = arcsin(z/80)，结果为弧度
-    float theta_a_rad = asinf(std::max(-1.0f, std::min(1.0f, z_a / 80.0f)));
-    float theta_b_rad = asinf(std::max(-1.0f, std::min(1.0f, z_b / 80.0f)));
-    float theta_c_rad = asinf(std::max(-1.0f, std::min(1.0f, z_c / 80.0f)));
+    float theta_a_rad = fast_math::asin(std::max(-1.0f, std::min(1.0f, z_a / 80.0f)));
+    float theta_b_rad = fast_math::asin(std::max(-1.0f, std::min(1.0f, z_b / 80.0f)));
+    float theta_c_rad = fast_math::asin(std::max(-1.0f, std::min(1.0f, z_c / 80.0f)));
 
     // 将弧度转换为角度（0-180度范围）
     float theta_a_deg = theta_a_rad * 180.0f / M_PI;
@@ -195,15 +163,13 @@ void TrRMaxExecutor::compute() {
 void TrRMaxExecutor::execute() {
     std::lock_guard<std::mutex> lock(m_compute_mutex);
 
-    // 将占空比应用到各个舵机
-    if (m_servo_a) {
-        m_servo_a->setTarget(m_servo_a_duty);
-    }
-    if (m_servo_b) {
-        m_servo_b->setTarget(m_servo_b_duty);
-    }
-    if (m_servo_c) {
-        m_servo_c->setTarget(m_servo_c_duty);
+    float targets[3] = {m_servo_a_duty, m_servo_b_duty, m_servo_c_duty};
+    limitJoints(targets);
+
+    // 将占空比批量写入各个舵机
+    if (m_bank) {
+        m_bank->setTargets(targets, 3);
     }
+    recordJoints(targets);
 }
 
@@ -0,0 +1,201 @@
+#include "twai/can_health.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "twai/twai.hpp"
+
+// 静态成员变量定义
+std::atomic<CanHealth::State> CanHealth::current{CanHealth::State::ACTIVE};
+std::atomic<uint32_t> CanHealth::resume_generation{0};
+TaskHandle_t CanHealth::task_handle = nullptr;
+std::mutex CanHealth::mutex;
+std::mutex CanHealth::handler_mutex;
+CanHealth::ResumeHandler CanHealth::resume_handler = nullptr;
+void *CanHealth::resume_arg = nullptr;
+CanHealth::Stats CanHealth::stats = {};
+int64_t CanHealth::fault_time_us = 0;
+int64_t CanHealth::bus_time_us = 0;
+
+static const char *TAG = "CanHealth";
+
+esp_err_t CanHealth::start() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (task_handle != nullptr) {
+    return ESP_OK;
+  }
+
+  if (!TWAI::is_initialized() || !TWAI::is_started()) {
+    ESP_LOGE(TAG, "TWAI not initialized or not started");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (xTaskCreate(healthTask, "can_health", 3072, nullptr,
+                  CAN_HEALTH_TASK_PRIORITY, &task_handle) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create CAN health task");
+    return ESP_FAIL;
+  }
+
+  ESP_LOGI(TAG, "CAN health monitor started");
+  return ESP_OK;
+}
+
+void CanHealth::notifyAlerts(uint32_t alerts) {
+  if (task_handle != nullptr) {
+    xTaskNotify(task_handle, alerts, eSetBits);
+  }
+}
+
+void CanHealth::setResumeHandler(ResumeHandler handler, void *arg) {
+  std::lock_guard<std::mutex> lock(handler_mutex);
+  resume_handler = handler;
+  resume_arg = arg;
+}
+
+void CanHealth::clearResumeHandler(void *arg) {
+  std::lock_guard<std::mutex> lock(handler_mutex);
+  if (resume_arg == arg) {
+    resume_handler = nullptr;
+    resume_arg = nullptr;
+  }
+}
+
+CanHealth::Stats CanHealth::getStats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return stats;
+}
+
+const char *CanHealth::stateName(State s) {
+  switch (s) {
+    case State::ACTIVE:
+      return "active";
+    case State::ERROR_PASSIVE:
+      return "error passive";
+    case State::BUS_OFF:
+      return "bus off";
+    case State::RESUMING:
+      return "resuming";
+  }
+  return "unknown";
+}
+
+void CanHealth::enterFault(State next) {
+  State prev = state();
+  int64_t now = esp_timer_get_time();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    // 错误被动升级为总线关闭时沿用最初的故障时间
+    if (prev == State::ACTIVE) {
+      fault_time_us = now;
+    }
+    if (next == State::BUS_OFF) {
+      stats.bus_off++;
+    } else {
+      stats.error_passive++;
+    }
+  }
+  current.store(next, std::memory_order_release);
+
+  twai_status_info_t info = {};
+  TWAI::getStatus(&info);
+  ESP_LOGW(TAG, "CAN %s -> %s (tec=%lu, rec=%lu)", stateName(prev),
+           stateName(next), (unsigned long)info.tx_error_counter,
+           (unsigned long)info.rx_error_counter);
+}
+
+void CanHealth::resume() {
+  current.store(State::RESUMING, std::memory_order_release);
+
+  // 回调会阻塞到电机应答或超时，期间不持有统计锁，getStats()等不受影响；
+  // handler_mutex保证注销回调时等待本次调用结束
+  esp_err_t ret = ESP_OK;
+  {
+    std::lock_guard<std::mutex> handler_lock(handler_mutex);
+    if (resume_handler != nullptr) {
+      ret = resume_handler(resume_arg);
+    }
+  }
+  int64_t now = esp_timer_get_time();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (ret != ESP_OK) {
+    stats.resume_failures++;
+    ESP_LOGW(TAG, "Motor re-enable failed: %s, retrying in %d ms",
+             esp_err_to_name(ret), CAN_HEALTH_POLL_MS);
+    return;
+  }
+
+  uint32_t total_ms = (uint32_t)((now - fault_time_us) / 1000);
+  stats.recoveries++;
+  stats.last_recovery_ms = total_ms;
+  if (total_ms > stats.max_recovery_ms) {
+    stats.max_recovery_ms = total_ms;
+  }
+
+  // 先更新代数再放行，执行器看到streaming()时必然已看到新代数
+  resume_generation.fetch_add(1, std::memory_order_release);
+  current.store(State::ACTIVE, std::memory_order_release);
+
+  ESP_LOGI(TAG,
+           "CAN recovered in %lu ms (bus %lu ms, motors %lu ms), "
+           "recoveries=%lu, max=%lu ms",
+           (unsigned long)total_ms,
+           (unsigned long)((bus_time_us - fault_time_us) / 1000),
+           (unsigned long)((now - bus_time_us) / 1000),
+           (unsigned long)stats.recoveries,
+           (unsigned long)stats.max_recovery_ms);
+}
+
+void CanHealth::healthTask(void *arg) {
+  ESP_LOGI(TAG, "CAN health task started");
+
+  while (true) {
+    // 告警只用于及时唤醒，状态以驱动为准
+    uint32_t alerts = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &alerts,
+                    pdMS_TO_TICKS(CAN_HEALTH_POLL_MS));
+
+    twai_status_info_t info;
+    if (TWAI::getStatus(&info) != ESP_OK) {
+      continue;
+    }
+
+    State s = state();
+    switch (info.state) {
+      case TWAI_STATE_BUS_OFF:
+        if (s != State::BUS_OFF) {
+          enterFault(State::BUS_OFF);
+        }
+        // 恢复期间驱动处于RECOVERING，不会重复发起
+        TWAI::initiateRecovery();
+        break;
+
+      case TWAI_STATE_RECOVERING:
+        // 等待128次11个隐性位
+        break;
+
+      case TWAI_STATE_STOPPED:
+        // 恢复完成后驱动停止，需要重新启动；其他原因的停止不处理
+        if (s == State::BUS_OFF && TWAI::restart() == ESP_OK) {
+          bus_time_us = esp_timer_get_time();
+          resume();
+        }
+        break;
+
+      case TWAI_STATE_RUNNING: {
+        bool passive =
+            info.tx_error_counter >= 128 || info.rx_error_counter >= 128;
+        if (s == State::ACTIVE && passive) {
+          enterFault(State::ERROR_PASSIVE);
+        } else if ((s == State::ERROR_PASSIVE && !passive) ||
+                   s == State::BUS_OFF) {
+          // 错误被动期间电机可能已掉电复位，同样重新使能
+          bus_time_us = esp_timer_get_time();
+          resume();
+        } else if (s == State::RESUMING) {
+          resume();
+        }
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,262 @@
+#include "twai/can_rx.hpp"
+#include <cstring>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "twai/can_health.hpp"
+#include "twai/can_tx.hpp"
+#include "twai/twai.hpp"
+
+// 静态成员变量定义
+CanRx::NodeSlot CanRx::nodes[CAN_RX_MAX_NODES] = {};
+CanRx::Waiter CanRx::waiters[CAN_RX_MAX_WAITERS] = {};
+EventGroupHandle_t CanRx::waiter_events = nullptr;
+TaskHandle_t CanRx::task_handle = nullptr;
+std::mutex CanRx::mutex;
+CanRx::Stats CanRx::stats = {};
+
+static const char *TAG = "CanRx";
+
+esp_err_t CanRx::start() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (task_handle != nullptr) {
+    return ESP_OK;
+  }
+
+  if (!TWAI::is_initialized() || !TWAI::is_started()) {
+    ESP_LOGE(TAG, "TWAI not initialized or not started");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (waiter_events == nullptr) {
+    waiter_events = xEventGroupCreate();
+    if (waiter_events == nullptr) {
+      ESP_LOGE(TAG, "Failed to create waiter event group");
+      return ESP_ERR_NO_MEM;
+    }
+  }
+
+  if (xTaskCreate(rxTask, "can_rx", 3072, nullptr, CAN_RX_TASK_PRIORITY,
+                  &task_handle) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create CAN RX task");
+    return ESP_FAIL;
+  }
+
+  ESP_LOGI(TAG, "CAN RX dispatcher started (%d nodes, %d waiters)",
+           CAN_RX_MAX_NODES, CAN_RX_MAX_WAITERS);
+  return ESP_OK;
+}
+
+bool CanRx::read(uint8_t node, uint8_t cmd, Frame &frame) {
+  if (node >= CAN_RX_MAX_NODES || cmd >= 32) {
+    return false;
+  }
+
+  const NodeSlot &slot = nodes[node];
+  while (true) {
+    uint32_t begin = slot.seq.load(std::memory_order_acquire);
+    if (begin & 1) {
+      // 读者抢占了正在写入的接收任务，让出CPU等其写完
+      vTaskDelay(1);
+      continue;
+    }
+    bool valid = (slot.valid_mask & (1u << cmd)) != 0;
+    frame = slot.frames[cmd];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) == begin) {
+      return valid;
+    }
+  }
+}
+
+int CanRx::expect(uint8_t node, uint8_t cmd) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (waiter_events == nullptr) {
+    return -1;
+  }
+
+  for (int i = 0; i < CAN_RX_MAX_WAITERS; i++) {
+    if (!waiters[i].used) {
+      waiters[i].used = true;
+      waiters[i].done = false;
+      waiters[i].node = node;
+      waiters[i].cmd = cmd;
+      // 清除上一个使用者超时后才到达的完成位
+      xEventGroupClearBits(waiter_events, 1u << i);
+      return i;
+    }
+  }
+
+  ESP_LOGW(TAG, "No free waiter for node %d cmd 0x%02X", node, cmd);
+  return -1;
+}
+
+esp_err_t CanRx::wait(int ticket, int timeout_ms, Frame &frame) {
+  if (ticket < 0 || ticket >= CAN_RX_MAX_WAITERS) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xEventGroupWaitBits(waiter_events, 1u << ticket, pdTRUE, pdTRUE,
+                      pdMS_TO_TICKS(timeout_ms));
+
+  std::lock_guard<std::mutex> lock(mutex);
+  Waiter &waiter = waiters[ticket];
+  esp_err_t ret = ESP_ERR_TIMEOUT;
+  if (waiter.done) {
+    frame = waiter.frame;
+    stats.completed++;
+    ret = ESP_OK;
+  } else {
+    stats.timeouts++;
+  }
+  waiter.used = false;
+  return ret;
+}
+
+void CanRx::release(int ticket) {
+  if (ticket < 0 || ticket >= CAN_RX_MAX_WAITERS) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  waiters[ticket].used = false;
+}
+
+CanRx::Stats CanRx::takeStats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  Stats result = stats;
+  stats = {};
+  return result;
+}
+
+void CanRx::dispatch(const Frame &frame) {
+  bool stored = false;
+  if (frame.node < CAN_RX_MAX_NODES) {
+    // seqlock写入：单写者，序号先变奇数，写完再变偶数
+    NodeSlot &slot = nodes[frame.node];
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.frames[frame.cmd] = frame;
+    slot.valid_mask |= 1u << frame.cmd;
+    slot.seq.store(seq + 2, std::memory_order_release);
+    stored = true;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  stats.received++;
+
+  EventBits_t bits = 0;
+  for (int i = 0; i < CAN_RX_MAX_WAITERS; i++) {
+    Waiter &waiter = waiters[i];
+    if (waiter.used && !waiter.done && waiter.cmd == frame.cmd &&
+        (waiter.node == ANY_NODE || waiter.node == frame.node)) {
+      waiter.frame = frame;
+      waiter.done = true;
+      bits |= 1u << i;
+    }
+  }
+  if (bits != 0) {
+    xEventGroupSetBits(waiter_events, bits);
+  } else if (!stored) {
+    stats.unmatched++;
+  }
+}
+
+void CanRx::drain() {
+  while (true) {
+    uint32_t id;
+    bool is_extended;
+    Frame frame;
+    if (TWAI::receive(&id, frame.data, &frame.len, &is_extended, 0) !=
+        ESP_OK) {
+      return;
+    }
+    if (!TWAI::isWanted(id)) {
+      std::lock_guard<std::mutex> lock(mutex);
+      stats.unwanted++;
+    }
+    frame.node = (uint8_t)((id >> 5) & 0x3F);
+    frame.cmd = (uint8_t)(id & 0x1F);
+    frame.timestamp_us = esp_timer_get_time();
+    dispatch(frame);
+  }
+}
+
+void CanRx::handleErrorAlerts(uint32_t alerts) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (alerts & (TWAI_ALERT_RX_QUEUE_FULL | TWAI_ALERT_RX_FIFO_OVERRUN)) {
+    stats.rx_queue_full++;
+  }
+  if (alerts & TWAI_ALERT_BUS_ERROR) {
+    stats.bus_errors++;
+  }
+  if (alerts & TWAI_ALERT_ERR_PASS) {
+    stats.error_passive++;
+  }
+  if (alerts & TWAI_ALERT_BUS_OFF) {
+    stats.bus_off++;
+  }
+}
+
+void CanRx::rxTask(void *arg) {
+  ESP_LOGI(TAG, "CAN RX task started");
+
+  int64_t last_report = esp_timer_get_time();
+  uint32_t last_lost = 0;
+
+  while (true) {
+    // 阻塞等待告警，直到有帧、出错或到统计打印时间
+    uint32_t alerts = 0;
+    esp_err_t ret = TWAI::readAlerts(&alerts, CAN_RX_REPORT_MS);
+    if (ret == ESP_OK) {
+      // 接收队列满时同样先取空队列
+      if (alerts & (TWAI_ALERT_RX_DATA | TWAI_ALERT_RX_QUEUE_FULL)) {
+        drain();
+      }
+      if (alerts & TWAI_TX_ALERTS) {
+        CanTx::notifyTxDone();
+      }
+      uint32_t errors = alerts & ~(TWAI_ALERT_RX_DATA | TWAI_TX_ALERTS);
+      if (errors) {
+        handleErrorAlerts(errors);
+        // 状态转换与恢复由健康监测任务处理
+        CanHealth::notifyAlerts(errors);
+      }
+    } else if (ret != ESP_ERR_TIMEOUT) {
+      // 驱动停止等情况，稍后重试
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    int64_t now = esp_timer_get_time();
+    if (now - last_report >= (int64_t)CAN_RX_REPORT_MS * 1000) {
+      // 驱动接收队列满与硬件FIFO溢出均计为丢帧
+      twai_status_info_t info;
+      if (TWAI::getStatus(&info) == ESP_OK) {
+        uint32_t lost = info.rx_missed_count + info.rx_overrun_count;
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.dropped += lost - last_lost;
+        last_lost = lost;
+      }
+
+      float window_seconds = (now - last_report) / 1000000.0f;
+      Stats s = takeStats();
+      if (s.received > 0 || s.dropped > 0 || s.bus_errors > 0) {
+        ESP_LOGI(TAG,
+                 "Stats [%.1fs window] - accepted=%.1f/s, unwanted=%.1f/s, "
+                 "completed=%lu, timeouts=%lu, unmatched=%lu, dropped=%lu",
+                 window_seconds, s.received / window_seconds,
+                 s.unwanted / window_seconds, (unsigned long)s.completed,
+                 (unsigned long)s.timeouts, (unsigned long)s.unmatched,
+                 (unsigned long)s.dropped);
+        ESP_LOGI(TAG,
+                 "Stats [%.1fs window] - rx queue full=%lu, bus errors=%lu, "
+                 "error passive=%lu, bus off=%lu",
+                 window_seconds, (unsigned long)s.rx_queue_full,
+                 (unsigned long)s.bus_errors, (unsigned long)s.error_passive,
+                 (unsigned long)s.bus_off);
+      }
+      last_report = now;
+    }
+  }
+}
@@ -0,0 +1,173 @@
+#include "twai/can_schedule.hpp"
+#include "esp_log.h"
+#include "twai/mit.hpp"
+#include "twai/twai.hpp"
+
+// 静态成员变量定义
+std::mutex CanSchedule::mutex;
+CanSchedule::Plan CanSchedule::current = {};
+uint8_t CanSchedule::nodes[CanSchedule::MAX_NODES] = {};
+size_t CanSchedule::node_count = 0;
+size_t CanSchedule::next_node = 0;
+float CanSchedule::credit = 0.0f;
+std::atomic<float> CanSchedule::feedback_hz{0.0f};
+std::atomic<float> CanSchedule::measured_load{0.0f};
+bool CanSchedule::handler_registered = false;
+uint32_t CanSchedule::window_start_ms = 0;
+float CanSchedule::window_load_sum = 0.0f;
+uint32_t CanSchedule::window_samples = 0;
+
+static const char *TAG = "CanSchedule";
+
+CanSchedule::Plan CanSchedule::configure(uint32_t bitrate,
+                                         uint32_t requested_hz,
+                                         size_t control_frames,
+                                         uint64_t node_mask) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  node_count = 0;
+  for (int node = 0; node < 64; node++) {
+    if (node_mask & (1ull << node)) {
+      nodes[node_count++] = (uint8_t)node;
+    }
+  }
+  next_node = 0;
+  credit = 0.0f;
+
+  uint32_t data_us =
+      twai_util::calculate_message_transmission_time(bitrate, 8, false);
+  uint32_t rtr_us =
+      twai_util::calculate_message_transmission_time(bitrate, 0, false);
+
+  Plan p;
+  p.control_us = control_frames * (1 + CAN_CONTROL_REPLIES) * data_us;
+  p.poll_us = rtr_us + data_us;
+
+  // 先为每个节点预留最低轮询频率，剩余预算决定节拍频率上限
+  float budget_us = CAN_LOAD_BUDGET * 1000000.0f;
+  float min_feedback_hz = (float)(node_count * CAN_FEEDBACK_MIN_HZ);
+  float control_budget_us = budget_us - min_feedback_hz * p.poll_us;
+  uint32_t max_hz = requested_hz;
+  if (p.control_us > 0) {
+    max_hz = control_budget_us > 0.0f
+                 ? (uint32_t)(control_budget_us / p.control_us)
+                 : 0;
+  }
+  p.tick_hz = requested_hz > max_hz ? max_hz : requested_hz;
+  if (p.tick_hz == 0) {
+    p.tick_hz = 1;
+    ESP_LOGE(TAG, "Control traffic alone exceeds the %.0f%% load budget",
+             CAN_LOAD_BUDGET * 100.0f);
+  }
+
+  // 剩余预算全部分给反馈轮询，每节拍最多轮询所有节点一次
+  float rest_us = budget_us - (float)p.tick_hz * p.control_us;
+  float max_feedback_hz = (float)(node_count * p.tick_hz);
+  p.feedback_hz = rest_us > 0.0f ? rest_us / p.poll_us : 0.0f;
+  if (p.feedback_hz > max_feedback_hz) {
+    p.feedback_hz = max_feedback_hz;
+  }
+  p.planned_load =
+      ((float)p.tick_hz * p.control_us + p.feedback_hz * p.poll_us) /
+      1000000.0f;
+
+  current = p;
+  feedback_hz.store(p.feedback_hz, std::memory_order_relaxed);
+  window_start_ms = 0;
+  window_load_sum = 0.0f;
+  window_samples = 0;
+
+  if (p.tick_hz < requested_hz) {
+    ESP_LOGW(TAG, "Tick rate %lu Hz exceeds the bus budget, using %lu Hz",
+             (unsigned long)requested_hz, (unsigned long)p.tick_hz);
+  }
+  ESP_LOGI(TAG,
+           "Plan: %lu Hz, control %lu us/tick, feedback %.0f Hz over %u "
+           "nodes (%lu us/poll), planned load %.1f%% of %.0f%% budget",
+           (unsigned long)p.tick_hz, (unsigned long)p.control_us,
+           p.feedback_hz, (unsigned)node_count, (unsigned long)p.poll_us,
+           p.planned_load * 100.0f, CAN_LOAD_BUDGET * 100.0f);
+
+  if (!handler_registered &&
+      TWAI::registerBusLoadHandler(busLoadHandler, nullptr) == ESP_OK) {
+    handler_registered = true;
+  }
+  return p;
+}
+
+size_t CanSchedule::feedbackRequests(twai_message_t *frames, size_t max) {
+  uint32_t tick_hz = current.tick_hz;
+  if (node_count == 0 || tick_hz == 0) {
+    return 0;
+  }
+
+  // 按小数累加：每节拍请求数 = 轮询频率 / 节拍频率
+  credit += feedback_hz.load(std::memory_order_relaxed) / tick_hz;
+  size_t count = 0;
+  while (credit >= 1.0f && count < max && count < node_count) {
+    uint8_t node = nodes[next_node];
+    next_node = (next_node + 1) % node_count;
+
+    twai_message_t &msg = frames[count++];
+    msg = {};
+    msg.identifier = (node << 5) | MIT::CMD_GET_ENCODER_ESTIMATES;
+    msg.flags = TWAI_MSG_FLAG_RTR;
+    msg.data_length_code = 0;
+    credit -= 1.0f;
+  }
+  // 输出数组不够时不累积欠账，避免之后突发
+  if (credit > 1.0f) {
+    credit = 1.0f;
+  }
+  return count;
+}
+
+CanSchedule::Plan CanSchedule::plan() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return current;
+}
+
+void CanSchedule::busLoadHandler(void *arg, esp_event_base_t base, int32_t id,
+                                 void *data) {
+  const twai_bus_load_update_event_data_t *event =
+      static_cast<const twai_bus_load_update_event_data_t *>(data);
+  float load = event->totalLoad;
+  measured_load.store(load, std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (current.poll_us == 0) {
+    return;
+  }
+
+  // 按实测与预算的差额（折算为轮询次数）调整一半，限制在[最低频率, 计划值]
+  float rate = feedback_hz.load(std::memory_order_relaxed) +
+               0.5f * (CAN_LOAD_BUDGET - load) * 1000000.0f / current.poll_us;
+  float min_rate = (float)(node_count * CAN_FEEDBACK_MIN_HZ);
+  if (min_rate > current.feedback_hz) {
+    min_rate = current.feedback_hz;
+  }
+  if (rate < min_rate) {
+    rate = min_rate;
+  } else if (rate > current.feedback_hz) {
+    rate = current.feedback_hz;
+  }
+  feedback_hz.store(rate, std::memory_order_relaxed);
+
+  // 打印窗口内的平均实测负载
+  if (window_samples == 0) {
+    window_start_ms = event->timestamp;
+  }
+  window_load_sum += load;
+  window_samples++;
+  uint32_t elapsed_ms = event->timestamp - window_start_ms;
+  if (elapsed_ms >= CAN_SCHEDULE_REPORT_MS) {
+    ESP_LOGI(TAG,
+             "Load [%.1fs window] - planned=%.1f%%, measured=%.1f%%, "
+             "budget=%.0f%%, feedback=%.0f/%.0f Hz",
+             elapsed_ms / 1000.0f, current.planned_load * 100.0f,
+             window_load_sum / window_samples * 100.0f,
+             CAN_LOAD_BUDGET * 100.0f, rate, current.feedback_hz);
+    window_load_sum = 0.0f;
+    window_samples = 0;
+  }
+}
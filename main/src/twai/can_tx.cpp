@@ -0,0 +1,230 @@
+#include "twai/can_tx.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "twai/twai.hpp"
+
+// 静态成员变量定义
+CanTx::Slot CanTx::slots[CAN_TX_SLOTS] = {};
+size_t CanTx::slot_count = 0;
+bool CanTx::in_flight = false;
+TaskHandle_t CanTx::task_handle = nullptr;
+std::mutex CanTx::mutex;
+int64_t CanTx::driver_submit_times[CAN_TX_DRIVER_DEPTH] = {};
+size_t CanTx::driver_head = 0;
+size_t CanTx::driver_count = 0;
+CanTx::Stats CanTx::stats = {};
+uint64_t CanTx::latency_sum_us = 0;
+
+static const char *TAG = "CanTx";
+
+esp_err_t CanTx::start() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (task_handle != nullptr) {
+    return ESP_OK;
+  }
+
+  if (!TWAI::is_initialized() || !TWAI::is_started()) {
+    ESP_LOGE(TAG, "TWAI not initialized or not started");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (xTaskCreate(txTask, "can_tx", 3072, nullptr, CAN_TX_TASK_PRIORITY,
+                  &task_handle) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create CAN TX task");
+    return ESP_FAIL;
+  }
+
+  ESP_LOGI(TAG, "CAN TX scheduler started (%d slots, driver depth %d)",
+           CAN_TX_SLOTS, CAN_TX_DRIVER_DEPTH);
+  return ESP_OK;
+}
+
+esp_err_t CanTx::submit(const twai_message_t *frames, size_t count) {
+  if (task_handle == nullptr) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  esp_err_t ret = ESP_OK;
+  int64_t now = esp_timer_get_time();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (size_t i = 0; i < count; i++) {
+      // 按CAN ID查找槽位，首次出现的ID按提交顺序分配新槽位
+      Slot *slot = nullptr;
+      for (size_t j = 0; j < slot_count; j++) {
+        if (slots[j].msg.identifier == frames[i].identifier) {
+          slot = &slots[j];
+          break;
+        }
+      }
+      if (slot == nullptr) {
+        if (slot_count >= CAN_TX_SLOTS) {
+          stats.failed++;
+          ret = ESP_ERR_NO_MEM;
+          continue;
+        }
+        slot = &slots[slot_count++];
+        slot->pending = false;
+      }
+
+      if (slot->pending) {
+        stats.coalesced++;
+      }
+      slot->msg = frames[i];
+      slot->submit_time = now;
+      slot->pending = true;
+      stats.submitted++;
+    }
+
+    uint32_t pending = 0;
+    for (size_t j = 0; j < slot_count; j++) {
+      pending += slots[j].pending ? 1 : 0;
+    }
+    if (pending > stats.pending_max) {
+      stats.pending_max = pending;
+    }
+  }
+
+  xTaskNotifyGive(task_handle);
+  return ret;
+}
+
+void CanTx::notifyTxDone() {
+  if (task_handle != nullptr) {
+    xTaskNotifyGive(task_handle);
+  }
+}
+
+void CanTx::cancel(int timeout_ms) {
+  int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t i = 0; i < slot_count; i++) {
+        slots[i].pending = false;
+      }
+      if (!in_flight) {
+        return;
+      }
+    }
+    if (esp_timer_get_time() >= deadline) {
+      ESP_LOGW(TAG, "Timed out waiting for in-flight frame");
+      return;
+    }
+    vTaskDelay(1);
+  }
+}
+
+CanTx::Stats CanTx::takeStats() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  Stats result = stats;
+  result.latency_avg_us =
+      stats.completed > 0 ? (uint32_t)(latency_sum_us / stats.completed) : 0;
+
+  stats = {};
+  latency_sum_us = 0;
+  return result;
+}
+
+void CanTx::retire(uint32_t queued, int64_t now) {
+  std::lock_guard<std::mutex> lock(mutex);
+  while (driver_count > queued) {
+    uint32_t latency = (uint32_t)(now - driver_submit_times[driver_head]);
+    driver_head = (driver_head + 1) % CAN_TX_DRIVER_DEPTH;
+    driver_count--;
+    stats.completed++;
+    latency_sum_us += latency;
+    if (latency > stats.latency_max_us) {
+      stats.latency_max_us = latency;
+    }
+  }
+}
+
+void CanTx::txTask(void *arg) {
+  ESP_LOGI(TAG, "CAN TX task started");
+
+  int64_t last_report = esp_timer_get_time();
+  size_t next = 0;  // 轮询起点，保持提交顺序且避免某个槽位独占发送
+  bool gated = false;  // 驱动队列已满，等待发送完成
+
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(gated ? CAN_TX_TIMEOUT_MS
+                                                 : CAN_TX_REPORT_MS));
+    gated = false;
+
+    while (true) {
+      // 驱动队列达到深度上限时停止搬运，剩余帧留在槽位中继续合并
+      twai_status_info_t info;
+      uint32_t queued =
+          TWAI::getStatus(&info) == ESP_OK ? info.msgs_to_tx : 0;
+      retire(queued, esp_timer_get_time());
+      if (queued >= CAN_TX_DRIVER_DEPTH) {
+        gated = true;
+        break;
+      }
+
+      twai_message_t msg;
+      int64_t submit_time;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t found = slot_count;
+        for (size_t k = 0; k < slot_count; k++) {
+          size_t i = (next + k) % slot_count;
+          if (slots[i].pending) {
+            found = i;
+            break;
+          }
+        }
+        if (found == slot_count) {
+          break;
+        }
+        msg = slots[found].msg;
+        submit_time = slots[found].submit_time;
+        slots[found].pending = false;
+        in_flight = true;
+        next = found + 1;
+      }
+
+      esp_err_t ret = TWAI::transmit(msg, CAN_TX_TIMEOUT_MS);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      in_flight = false;
+      if (ret == ESP_OK) {
+        stats.sent++;
+        // 本模块的帧不超过队列深度，FIFO不会溢出
+        driver_submit_times[(driver_head + driver_count) % CAN_TX_DRIVER_DEPTH] =
+            submit_time;
+        driver_count++;
+        if (queued + 1 > stats.driver_queue_max) {
+          stats.driver_queue_max = queued + 1;
+        }
+      } else {
+        stats.failed++;
+      }
+    }
+
+    int64_t now = esp_timer_get_time();
+    if (now - last_report >= (int64_t)CAN_TX_REPORT_MS * 1000) {
+      float window_seconds = (now - last_report) / 1000000.0f;
+      Stats s = takeStats();
+      if (s.submitted > 0) {
+        ESP_LOGI(TAG,
+                 "Stats [%.1fs window] - submitted=%lu, sent=%lu, "
+                 "completed=%lu, coalesced=%lu, failed=%lu, pending max=%lu, "
+                 "driver queue max=%lu, latency to completion avg=%lu us, "
+                 "max=%lu us",
+                 window_seconds, (unsigned long)s.submitted,
+                 (unsigned long)s.sent, (unsigned long)s.completed,
+                 (unsigned long)s.coalesced,
+                 (unsigned long)s.failed, (unsigned long)s.pending_max,
+                 (unsigned long)s.driver_queue_max,
+                 (unsigned long)s.latency_avg_us,
+                 (unsigned long)s.latency_max_us);
+      }
+      last_report = now;
+    }
+  }
+}
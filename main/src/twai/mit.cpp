@@ -1,6 +1,11 @@
 #include "twai/mit.hpp"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "twai/can_health.hpp"
+#include "twai/can_rx.hpp"
+#include "twai/mit_codec.hpp"
 #include "twai/twai.hpp"
+#include <cstring>
 #include <mutex>
 
 // 静态成员变量定义
@@ -9,7 +14,8 @@ std::recursive_mutex MIT::mutex;
 
 static const char* TAG = "MIT";
 
-esp_err_t MIT::init(int tx_pin, int rx_pin, uint32_t bitrate) {
+esp_err_t MIT::init(int tx_pin, int rx_pin, uint32_t bitrate,
+                    uint64_t node_mask) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
 
     if (initialized) {
@@ -17,8 +23,25 @@ esp_err_t MIT::init(int tx_pin, int rx_pin, uint32_t bitrate) {
         return ESP_OK;
     }
 
+    // 电机只会回复这几类命令，其余ID交给硬件过滤器丢弃
+    static const uint8_t response_cmds[] = {CMD_GET_ERROR, CMD_MIT_CONTROL,
+                                            CMD_GET_ENCODER_ESTIMATES,
+                                            CMD_CLEAR_ERRORS};
+    uint16_t accept_ids[64 * sizeof(response_cmds)];
+    size_t accept_count = 0;
+    for (int node = 0; node < 64; node++) {
+        if (!(node_mask & (1ull << node))) {
+            continue;
+        }
+        for (uint8_t cmd : response_cmds) {
+            accept_ids[accept_count++] = (uint16_t)((node << 5) | cmd);
+        }
+    }
+
     // 初始化TWAI
-    esp_err_t ret = TWAI::init(tx_pin, rx_pin, bitrate);
+    esp_err_t ret = TWAI::init(tx_pin, rx_pin, bitrate,
+                               accept_count > 0 ? accept_ids : nullptr,
+                               accept_count);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize TWAI: %s", esp_err_to_name(ret));
         return ret;
@@ -31,6 +54,22 @@ esp_err_t MIT::init(int tx_pin, int rx_pin, uint32_t bitrate) {
         return ret;
     }
 
+    // 启动接收分发任务，请求响应与电机反馈统一经其接收
+    ret = CanRx::start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start CAN RX dispatcher: %s",
+                 esp_err_to_name(ret));
+        return ret;
+    }
+
+    // 启动总线健康监测，总线关闭/错误被动后自动恢复
+    ret = CanHealth::start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start CAN health monitor: %s",
+                 esp_err_to_name(ret));
+        return ret;
+    }
+
     initialized = true;
     ESP_LOGI(TAG, "MIT initialized successfully with bitrate=%d", bitrate);
     return ESP_OK;
@@ -47,24 +86,14 @@ esp_err_t MIT::get_fault(uint8_t nodeid, uint64_t& fault_code) {
     // 查询异常使用 CMD_GET_ERROR 命令
     uint8_t data[8] = {};
     data[0] = 0;  // Error_Type: 0=获取电机异常
-    uint32_t can_id = calculate_can_id(nodeid, CMD_GET_ERROR);
 
-    // 发送命令
-    esp_err_t ret = TWAI::send(can_id, data, 8);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to send get error command: %s",
-                 esp_err_to_name(ret));
-        return ret;
-    }
-
-    // 接收响应
+    // 发送命令并接收响应
     uint8_t response_data[8];
     uint8_t response_len;
-    ret =
-        wait_response(nodeid, CMD_GET_ERROR, 1000, response_data, response_len);
+    esp_err_t ret = request(nodeid, CMD_GET_ERROR, data, 1000, response_data,
+                            response_len);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to receive error response: %s",
-                 esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to get error: %s", esp_err_to_name(ret));
         return ret;
     }
 
@@ -92,22 +121,14 @@ esp_err_t MIT::clear_fault(uint8_t nodeid) {
 
     // 清除异常使用 CMD_CLEAR_ERRORS 命令
     uint8_t data[8] = {0};
-    uint32_t can_id = calculate_can_id(nodeid, CMD_CLEAR_ERRORS);
-    esp_err_t ret = TWAI::send(can_id, data, 8);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to send clear errors command: %s",
-                 esp_err_to_name(ret));
-        return ret;
-    }
 
-    // 等待响应
+    // 发送命令并等待响应
     uint8_t response_data[8];
     uint8_t response_len;
-    ret = wait_response(nodeid, CMD_CLEAR_ERRORS, 1000, response_data,
-                        response_len);
+    esp_err_t ret = request(nodeid, CMD_CLEAR_ERRORS, data, 1000,
+                            response_data, response_len);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to receive clear errors response: %s",
-                 esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to clear errors: %s", esp_err_to_name(ret));
         return ret;
     }
 
@@ -170,6 +191,153 @@ esp_err_t MIT::set_state(uint8_t nodeid, AxisState state) {
     return ESP_OK;
 }
 
+esp_err_t MIT::bring_up(uint64_t node_mask, AxisState state,
+                         bool clear_faults, int timeout_ms,
+                         BringUpResult& result) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    result = {};
+
+    if (!initialized) {
+        ESP_LOGE(TAG, "MIT not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t start = esp_timer_get_time();
+    int node_count = 0;
+    int node = 0;
+    while (true) {
+        // 等待位有限，节点多于CAN_RX_MAX_WAITERS时分批
+        uint8_t batch[CAN_RX_MAX_WAITERS];
+        int count = 0;
+        for (; node < 64 && count < CAN_RX_MAX_WAITERS; node++) {
+            if (node_mask & (1ull << node)) {
+                batch[count++] = (uint8_t)node;
+            }
+        }
+        if (count == 0) {
+            break;
+        }
+        node_count += count;
+
+        // 先全部发出，不等待
+        int tickets[CAN_RX_MAX_WAITERS];
+        int64_t sent_at[CAN_RX_MAX_WAITERS];
+        for (int i = 0; i < count; i++) {
+            uint8_t id = batch[i];
+            tickets[i] = CanRx::expect(id, CMD_GET_ERROR);
+            if (tickets[i] < 0) {
+                // 无法确认状态切换，不发出命令，由调用方重试
+                ESP_LOGE(TAG, "No CanRx waiter for node %d, bring-up skipped",
+                         id);
+                continue;
+            }
+
+            uint8_t data[8] = {0};
+            esp_err_t ret = ESP_OK;
+            if (clear_faults) {
+                ret = TWAI::send(calculate_can_id(id, CMD_CLEAR_ERRORS), data,
+                                 8);
+            }
+            if (ret == ESP_OK) {
+                data[0] = (uint8_t)state;
+                ret = TWAI::send(calculate_can_id(id, CMD_SET_AXIS_STATE),
+                                 data, 8);
+            }
+            if (ret == ESP_OK) {
+                data[0] = 0;  // Error_Type: 0=获取电机异常
+                ret = TWAI::send(calculate_can_id(id, CMD_GET_ERROR), data, 8);
+            }
+            sent_at[i] = esp_timer_get_time();
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send bring-up to node %d: %s", id,
+                         esp_err_to_name(ret));
+                CanRx::release(tickets[i]);
+                tickets[i] = -1;
+            }
+        }
+
+        // 再统一收取，每个节点只等到自己的截止时间
+        for (int i = 0; i < count; i++) {
+            uint8_t id = batch[i];
+            uint64_t bit = 1ull << id;
+            if (tickets[i] < 0) {
+                result.unsent |= bit;
+                continue;
+            }
+
+            int64_t remaining_us =
+                sent_at[i] + (int64_t)timeout_ms * 1000 - esp_timer_get_time();
+            int remaining_ms =
+                remaining_us > 0 ? (int)((remaining_us + 999) / 1000) : 0;
+            CanRx::Frame frame;
+            if (CanRx::wait(tickets[i], remaining_ms, frame) != ESP_OK) {
+                result.late |= bit;
+                continue;
+            }
+
+            result.responded |= bit;
+            int64_t rtt = frame.timestamp_us - sent_at[i];
+            if (rtt > (int64_t)result.slowest_us) {
+                result.slowest_us = (uint32_t)rtt;
+                result.slowest_node = id;
+            }
+            if (frame.len == 8) {
+                uint64_t fault_code;
+                swap_endian(frame.data, 8);
+                memcpy(&fault_code, frame.data, 8);
+                if (fault_code != 0) {
+                    result.faulted |= bit;
+                    ESP_LOGW(TAG, "Node %d fault: %s", id,
+                             get_fault_description(fault_code).c_str());
+                }
+            }
+        }
+    }
+
+    result.elapsed_ms = (uint32_t)((esp_timer_get_time() - start) / 1000);
+
+    uint64_t failed = result.unsent | result.late | result.faulted;
+    if (failed != 0) {
+        char failed_nodes[64 * 4 + 1] = "";
+        size_t pos = 0;
+        for (int i = 0; i < 64; i++) {
+            uint64_t bit = 1ull << i;
+            if (failed & bit) {
+                // u=未发出，t=超时，f=异常
+                char kind = (result.unsent & bit)  ? 'u'
+                            : (result.late & bit) ? 't'
+                                                  : 'f';
+                pos += snprintf(failed_nodes + pos, sizeof(failed_nodes) - pos,
+                                " %d%c", i, kind);
+            }
+        }
+        ESP_LOGW(TAG,
+                 "Bring-up of %d nodes to state %d: %lu ms, failed nodes "
+                 "(u=unsent, t=timeout, f=fault):%s",
+                 node_count, state, (unsigned long)result.elapsed_ms,
+                 failed_nodes);
+        if (result.unsent != 0) {
+            return ESP_FAIL;
+        }
+        return result.late != 0 ? ESP_ERR_TIMEOUT : ESP_ERR_INVALID_STATE;
+    }
+    ESP_LOGI(TAG,
+             "Bring-up of %d nodes to state %d: %lu ms, slowest node %d "
+             "(%lu us)",
+             node_count, state, (unsigned long)result.elapsed_ms,
+             result.slowest_node, (unsigned long)result.slowest_us);
+    return ESP_OK;
+}
+
+void MIT::build_dynamic_control_frame(uint8_t nodeid,
+                                      const MotorControl& control,
+                                      twai_message_t& frame) {
+    frame = {};
+    frame.identifier = calculate_can_id(nodeid, CMD_DYNAMIC_CONTROL);
+    frame.data_length_code = 8;
+    pack_dynamic_control_data(control, frame.data);
+}
+
 // esp_err_t MIT::set_zero_point(uint8_t nodeid) {
 //     // 兼容性函数，调用新的set_state函数
 //     return set_state(nodeid, AXIS_STATE_ENCODER_OFFSET_CALIBRATION);
@@ -223,32 +391,25 @@ esp_err_t MIT::dynamic_control(uint8_t nodeid, const MotorControl& control) {
 }
 
 esp_err_t MIT::receive_status(int timeout_ms, MotorStatus& status) {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-
     if (!initialized) {
         ESP_LOGE(TAG, "MIT not initialized");
         return ESP_ERR_INVALID_STATE;
     }
 
-    // 接收TWAI消息
-    uint32_t id;
-    uint8_t data[8];
-    uint8_t data_len;
-    bool is_extended;
-
-    esp_err_t ret =
-        TWAI::receive(&id, data, &data_len, &is_extended, timeout_ms);
+    // 等待任意节点的下一帧MIT控制响应
+    int ticket = CanRx::expect(CanRx::ANY_NODE, CMD_DYNAMIC_CONTROL);
+    if (ticket < 0) {
+        return ESP_ERR_NO_MEM;
+    }
+    CanRx::Frame frame;
+    esp_err_t ret = CanRx::wait(ticket, timeout_ms, frame);
     if (ret != ESP_OK) {
-        if (ret != ESP_ERR_TIMEOUT) {
-            ESP_LOGE(TAG, "Failed to receive status: %s", esp_err_to_name(ret));
-        }
         return ret;
     }
 
     // 解包状态数据
-    unpack_status_data(data, data_len, status);
-    // 从CAN ID中提取node_id部分
-    status.can_id = (uint8_t)(id >> 5);
+    unpack_status_data(frame.data, frame.len, status);
+    status.can_id = frame.node;
 
     ESP_LOGD(TAG,
              "Motor status received: ID=%d, pos=%.3f, vel=%.3f, torque=%.3f, "
@@ -264,35 +425,52 @@ esp_err_t MIT::wait_response(uint8_t nodeid,
                              int timeout_ms,
                              uint8_t* response_data,
                              uint8_t& response_len) {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-
     if (!initialized) {
         ESP_LOGE(TAG, "MIT not initialized");
         return ESP_ERR_INVALID_STATE;
     }
 
-    // 接收响应
-    uint32_t id;
-    bool is_extended;
+    int ticket = CanRx::expect(nodeid, command);
+    if (ticket < 0) {
+        return ESP_ERR_NO_MEM;
+    }
+    CanRx::Frame frame;
+    esp_err_t ret = CanRx::wait(ticket, timeout_ms, frame);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    memcpy(response_data, frame.data, frame.len);
+    response_len = frame.len;
+    return ESP_OK;
+}
+
+esp_err_t MIT::request(uint8_t nodeid,
+                       Command command,
+                       const uint8_t data[8],
+                       int timeout_ms,
+                       uint8_t* response_data,
+                       uint8_t& response_len) {
+    // 先登记再发送，响应早于wait()到达也不会丢失
+    int ticket = CanRx::expect(nodeid, command);
+    if (ticket < 0) {
+        return ESP_ERR_NO_MEM;
+    }
 
-    esp_err_t ret = TWAI::receive(&id, response_data, &response_len,
-                                  &is_extended, timeout_ms);
+    esp_err_t ret = TWAI::send(calculate_can_id(nodeid, command), data, 8);
     if (ret != ESP_OK) {
-        if (ret != ESP_ERR_TIMEOUT) {
-            ESP_LOGE(TAG, "Failed to receive command response: %s",
-                     esp_err_to_name(ret));
-        }
+        CanRx::release(ticket);
         return ret;
     }
 
-    // 检查响应ID是否匹配 - 从CAN ID中提取node_id部分进行比较
-    uint8_t response_nodeid = (uint8_t)(id >> 5);
-    if (response_nodeid != nodeid) {
-        ESP_LOGW(TAG, "Response Node ID mismatch: expected %d, got %d", nodeid,
-                 response_nodeid);
-        return ESP_ERR_INVALID_RESPONSE;
+    CanRx::Frame frame;
+    ret = CanRx::wait(ticket, timeout_ms, frame);
+    if (ret != ESP_OK) {
+        return ret;
     }
 
+    memcpy(response_data, frame.data, frame.len);
+    response_len = frame.len;
     return ESP_OK;
 }
 
@@ -357,86 +535,10 @@ std::string MIT::get_fault_description(uint64_t fault_code) {
     return description;
 }
 
-uint16_t MIT::position_to_int(double position) {
-    // pos_int = (pos_double + 12.5) * 65535 / 25
-    return (uint16_t)((position + 15.91) * 65535.0 / 31.82);
-}
-
-double MIT::int_to_position(uint16_t pos_int) {
-    // pos_double = pos_int * 31.82 / 65535 - 15.91
-    return 2 * ((double)pos_int * 31.82 / 65535.0 - 15.91);
-}
-
-int16_t MIT::velocity_to_int(double velocity) {
-    // vel_int = (vel_double + 65) * 4095 / 130
-    return (int16_t)((velocity + 82.73) * 4095.0 / 165.46);
-}
-
-double MIT::int_to_velocity(int16_t vel_int) {
-    // vel_double = vel_int * 165.46 / 4095 - 82.73
-    return (double)((uint16_t)vel_int) * 165.46 / 4095.0 - 82.73;
-}
-
-int16_t MIT::kp_to_int(double kp) {
-    // kp_int = kp_double * 4095 / 500
-    return (int16_t)(kp * 4095.0 / 500.0);
-}
-
-double MIT::int_to_kp(int16_t kp_int) {
-    // kp_double = kp_int * 500 / 4095
-    return (double)kp_int * 500.0 / 4095.0;
-}
-
-int16_t MIT::kd_to_int(double kd) {
-    // kd_int = kd_double * 4095 / 5
-    return (int16_t)(kd * 4095.0 / 5.0);
-}
-
-double MIT::int_to_kd(int16_t kd_int) {
-    // kd_double = kd_int * 5 / 4095
-    return (double)kd_int * 5.0 / 4095.0;
-}
-
-int16_t MIT::torque_to_int(double torque) {
-    // t_int = (t_double + 225 * 转矩常数 * 减速比) * 4095 / (450 * 转矩常数 *
-    // 减速比)
-    // double factor = torque_constant * reduction_ratio;
-    return (int16_t)((torque + 6.24) * 4095.0 / (12.48));
-}
-
-double MIT::int_to_torque(int16_t t_int) {
-    // t_double = t_int * (450 * 转矩常数 * 减速比) / 4095 - 225 * 转矩常数 *
-    // 减速比
-    // double factor = torque_constant * reduction_ratio;
-    return (double)t_int * (12.48) / 4095.0 - 6.24;
-}
-
 void MIT::pack_dynamic_control_data(const MotorControl& control,
                                     uint8_t data[8]) {
-    // 位置：16位，BYTE0为高8位，BYTE1为低8位
-    uint16_t pos_int = position_to_int(control.position);
-    data[0] = (uint8_t)(pos_int >> 8);
-    data[1] = (uint8_t)(pos_int & 0xFF);
-
-    // 速度：12位，BYTE2为高8位，BYTE3[7-4]为低4位
-    int16_t vel_int = velocity_to_int(control.velocity);
-    data[2] = (uint8_t)(vel_int >> 4);
-    data[3] = (uint8_t)((vel_int & 0x0F) << 4);
-
-    // KP值：12位，BYTE3[3-0]为高4位，BYTE4为低8位
-    int16_t kp_int = kp_to_int(control.kp);
-    data[3] |= (uint8_t)((kp_int >> 8) & 0x0F);
-    data[4] = (uint8_t)(kp_int & 0xFF);
-
-    // KD值：12位，BYTE5为高8位，BYTE6[7-4]为低4位
-    int16_t kd_int = kd_to_int(control.kd);
-    data[5] = (uint8_t)(kd_int >> 4);
-    data[6] = (uint8_t)((kd_int & 0x0F) << 4);
-
-    // 力矩：12位，BYTE6[3-0]为高4位，BYTE7为低8位
-    int16_t torque_int = torque_to_int(control.torque);
-    data[6] |= (uint8_t)((torque_int >> 8) & 0x0F);
-    data[7] = (uint8_t)(torque_int & 0xFF);
+    mit_codec::packControl(control.position, control.velocity, control.kp,
+                           control.kd, control.torque, data);
 }
 
 void MIT::unpack_status_data(const uint8_t* data,
@@ -453,16 +555,19 @@ void MIT::unpack_status_data(const uint8_t* data,
     // 位置：16位，BYTE1为高8位，BYTE2为低8位
     uint16_t pos_int = (uint16_t)((data[1] << 8) | data[2]);
     printf("pos_int:%hu\n", pos_int);
-    status.position = int_to_position(pos_int);
+    status.position =
+        mit_codec::decode(mit_codec::kPosition, (uint16_t)pos_int);
 
     // 速度：12位，BYTE3为高8位，BYTE4[7-4]为低4位
     int16_t vel_int = (int16_t)((data[3] << 4) | (data[4] >> 4));
     printf("vel_int:%hu\n", vel_int);
-    status.velocity = int_to_velocity(vel_int);
+    status.velocity =
+        mit_codec::decode(mit_codec::kVelocity, (uint16_t)vel_int);
 
     // 力矩：12位，BYTE4[3-0]为高4位，BYTE5为低8位
     int16_t torque_int = (int16_t)(((data[4] & 0x0F) << 8) | data[5]);
-    status.torque = int_to_torque(torque_int);
+    status.torque =
+        mit_codec::decode(mit_codec::kTorque, (uint16_t)torque_int);
 
     // 异常代码：如果是获取异常命令的响应，需要特殊处理
     // 这里暂时设为0，具体解析需要根据命令类型
@@ -486,17 +591,20 @@ void MIT::unpack_dynamic_control_response(const uint8_t* data,
     // 位置：16位，BYTE1为高8位，BYTE2为低8位
     int16_t pos_int = (int16_t)((data[1] << 8) | data[2]);
     // printf("pos_int: %d\n", pos_int);
-    status.position = int_to_position(pos_int);
+    status.position =
+        mit_codec::decode(mit_codec::kPosition, (uint16_t)pos_int);
 
     // 速度：12位，BYTE3为高8位，BYTE4[7-4]为低4位
     int16_t vel_int = (int16_t)((data[3] << 4) | (data[4] >> 4));
     // printf("vel_int: %d\n", vel_int);
-    status.velocity = int_to_velocity(vel_int);
+    status.velocity =
+        mit_codec::decode(mit_codec::kVelocity, (uint16_t)vel_int);
 
     // 力矩：12位，BYTE4[3-0]为高4位，BYTE5为低8位
     int16_t torque_int = (int16_t)(((data[4] & 0x0F) << 8) | data[5]);
     // printf("torque_int: %d\n", torque_int);
-    status.torque = int_to_torque(torque_int);
+    status.torque =
+        mit_codec::decode(mit_codec::kTorque, (uint16_t)torque_int);
 
     // 异常代码：动态控制响应中不包含异常代码，设为0
     status.fault_code = 0;
@@ -516,24 +624,13 @@ esp_err_t MIT::dynamic_control_with_response(uint8_t nodeid,
     uint8_t data[8];
     pack_dynamic_control_data(control, data);
 
-    // 计算CAN ID: (node_id << 5) | cmd_id
-    uint32_t can_id = calculate_can_id(nodeid, CMD_DYNAMIC_CONTROL);
-
-    // 发送命令
-    esp_err_t ret = TWAI::send(can_id, data, 8);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to send dynamic control command: %s",
-                 esp_err_to_name(ret));
-        return ret;
-    }
-
-    // 等待响应
+    // 发送命令并等待响应
     uint8_t response_data[8];
     uint8_t response_len;
-    ret = wait_response(nodeid, CMD_DYNAMIC_CONTROL, 1000, response_data,
-                        response_len);
+    esp_err_t ret = request(nodeid, CMD_DYNAMIC_CONTROL, data, 1000,
+                            response_data, response_len);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to receive dynamic control response: %s",
+        ESP_LOGE(TAG, "Dynamic control with response failed: %s",
                  esp_err_to_name(ret));
         return ret;
     }
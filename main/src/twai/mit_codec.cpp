@@ -0,0 +1,153 @@
+#include "twai/mit_codec.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include "esp_cpu.h"
+#include "esp_log.h"
+
+namespace mit_codec {
+
+namespace {
+
+const char *TAG = "mit_codec";
+
+constexpr int kFrames = 20000;
+
+volatile uint8_t g_sink = 0;  // 防止基准循环被优化掉
+
+/**
+ * @brief 原MIT::pack_dynamic_control_data（double）逐字复制，作为对照
+ */
+void packLegacy(double position, double velocity, double kp, double kd,
+                double torque, uint8_t data[8]) {
+    uint16_t pos_int = (uint16_t)((position + 15.91) * 65535.0 / 31.82);
+    data[0] = (uint8_t)(pos_int >> 8);
+    data[1] = (uint8_t)(pos_int & 0xFF);
+
+    int16_t vel_int = (int16_t)((velocity + 82.73) * 4095.0 / 165.46);
+    data[2] = (uint8_t)(vel_int >> 4);
+    data[3] = (uint8_t)((vel_int & 0x0F) << 4);
+
+    int16_t kp_int = (int16_t)(kp * 4095.0 / 500.0);
+    data[3] |= (uint8_t)((kp_int >> 8) & 0x0F);
+    data[4] = (uint8_t)(kp_int & 0xFF);
+
+    int16_t kd_int = (int16_t)(kd * 4095.0 / 5.0);
+    data[5] = (uint8_t)(kd_int >> 4);
+    data[6] = (uint8_t)((kd_int & 0x0F) << 4);
+
+    int16_t torque_int = (int16_t)((torque + 6.24) * 4095.0 / (12.48));
+    data[6] |= (uint8_t)((torque_int >> 8) & 0x0F);
+    data[7] = (uint8_t)(torque_int & 0xFF);
+}
+
+struct Input {
+    float position, velocity, kp, kd, torque;
+};
+
+/**
+ * @brief 第i组量程内输入
+ *
+ * 偶数组在量程内均匀分布；奇数组取某个编码边界附近±几个ulp，
+ * 专门覆盖float路径回退到double的情况。
+ */
+Input makeInput(int i) {
+    uint32_t h = (uint32_t)i * 2654435761u;
+    auto uniform = [&h](const Field &f) {
+        h = h * 1664525u + 1013904223u;
+        float u = (h >> 8) * (1.0f / 16777216.0f);
+        return (float)(-f.offset + u * f.span);
+    };
+    auto edge = [&h](const Field &f) {
+        h = h * 1664525u + 1013904223u;
+        uint32_t code = 1 + (h >> 8) % (f.max - 1);
+        float x = (float)(code * f.span / f.max - f.offset);
+        int steps = (int)(h & 7) - 4;
+        for (; steps < 0; steps++) x = nextafterf(x, -INFINITY);
+        for (; steps > 0; steps--) x = nextafterf(x, INFINITY);
+        return x;
+    };
+    if (i & 1) {
+        return {edge(kPosition), edge(kVelocity), edge(kKp), edge(kKd),
+                edge(kTorque)};
+    }
+    return {uniform(kPosition), uniform(kVelocity), uniform(kKp),
+            uniform(kKd), uniform(kTorque)};
+}
+
+}  // namespace
+
+void selfTest() {
+    ESP_LOGI(TAG, "MIT codec self test (%d frames)", kFrames);
+
+    // 逐帧对比
+    int mismatches = 0;
+    for (int i = 0; i < kFrames; i++) {
+        Input in = makeInput(i);
+        uint8_t a[8], b[8];
+        packControl(in.position, in.velocity, in.kp, in.kd, in.torque, a);
+        packLegacy(in.position, in.velocity, in.kp, in.kd, in.torque, b);
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            if (mismatches < 5) {
+                ESP_LOGE(TAG,
+                         "Frame mismatch: pos=%.9g vel=%.9g kp=%.9g kd=%.9g "
+                         "t=%.9g",
+                         in.position, in.velocity, in.kp, in.kd, in.torque);
+            }
+            mismatches++;
+        }
+    }
+
+    // 解码误差：与原double公式对比
+    double pos_err = 0.0, vel_err = 0.0, torque_err = 0.0;
+    for (uint32_t code = 0; code <= kPosition.max; code++) {
+        double ref = 2 * ((double)code * 31.82 / 65535.0 - 15.91);
+        pos_err = fmax(pos_err, fabs(decode(kPosition, code) - ref));
+        if (code <= kVelocity.max) {
+            ref = (double)code * 165.46 / 4095.0 - 82.73;
+            vel_err = fmax(vel_err, fabs(decode(kVelocity, code) - ref));
+            ref = (double)code * (12.48) / 4095.0 - 6.24;
+            torque_err = fmax(torque_err, fabs(decode(kTorque, code) - ref));
+        }
+    }
+
+    // 耗时：同一组量程内均匀输入（偶数组）分别打包
+    uint8_t frame[8];
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < kFrames; i++) {
+        Input in = makeInput(2 * i);
+        packControl(in.position, in.velocity, in.kp, in.kd, in.torque, frame);
+        g_sink = frame[7];
+    }
+    uint32_t float_cycles = (esp_cpu_get_cycle_count() - start) / kFrames;
+
+    start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < kFrames; i++) {
+        Input in = makeInput(2 * i);
+        packLegacy(in.position, in.velocity, in.kp, in.kd, in.torque, frame);
+        g_sink = frame[7];
+    }
+    uint32_t double_cycles = (esp_cpu_get_cycle_count() - start) / kFrames;
+
+    // 输入生成本身的耗时，从两者中扣除
+    start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < kFrames; i++) {
+        Input in = makeInput(2 * i);
+        g_sink = (uint8_t)in.torque;
+    }
+    uint32_t input_cycles = (esp_cpu_get_cycle_count() - start) / kFrames;
+
+    if (mismatches == 0) {
+        ESP_LOGI(TAG, "Frames: all %d bit-exact", kFrames);
+    } else {
+        ESP_LOGE(TAG, "Frames: %d of %d differ", mismatches, kFrames);
+    }
+    ESP_LOGI(TAG, "Decode max_err: pos=%.3g vel=%.3g torque=%.3g", pos_err,
+             vel_err, torque_err);
+    ESP_LOGI(TAG, "Pack: float=%lu cycles/frame  double=%lu cycles/frame",
+             (unsigned long)(float_cycles - input_cycles),
+             (unsigned long)(double_cycles - input_cycles));
+}
+
+}  // namespace mit_codec
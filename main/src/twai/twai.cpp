@@ -1,6 +1,9 @@
 #include "twai/twai.hpp"
+#include "twai/twai_backend.hpp"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include <cstring>
 
 // 事件基础定义
 ESP_EVENT_DEFINE_BASE(TWAI_EVENT);
@@ -10,19 +13,106 @@ bool TWAI::initialized = false;
 bool TWAI::started = false;
 uint32_t TWAI::current_bitrate = 0;
 TaskHandle_t TWAI::bus_load_task_handle = nullptr;
-std::mutex TWAI::stats_mutex;
+uint32_t TWAI::wanted_ids[2048 / 32] = {};
+bool TWAI::wanted_all = true;
 
 // 总线负载监控统计变量
-uint32_t TWAI::rx_message_count = 0;
-uint32_t TWAI::tx_message_count = 0;
-uint32_t TWAI::rx_bytes_count = 0;
-uint32_t TWAI::tx_bytes_count = 0;
-uint64_t TWAI::rx_total_transmission_time_us = 0;
-uint64_t TWAI::tx_total_transmission_time_us = 0;
+TWAI::DirectionCounters TWAI::rx_counters;
+TWAI::DirectionCounters TWAI::tx_counters;
+TWAI::NodeCounters TWAI::node_counters[TWAI::MAX_NODES];
 
 static const char *TAG = "TWAI";
 
-esp_err_t TWAI::init(int tx_pin, int rx_pin, uint32_t bitrate) {
+namespace twai_util {
+
+namespace {
+
+/**
+ * @brief 一组ID的公共位：返回值为不同位的掩码，code取第一个ID
+ */
+uint16_t common_mask(const uint16_t *ids, size_t count, uint16_t bit,
+                     int side, uint16_t &code, size_t &members) {
+  uint16_t mask = 0;
+  members = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (side >= 0 && ((ids[i] & bit) != 0) != (side != 0)) {
+      continue;
+    }
+    if (members++ == 0) {
+      code = ids[i];
+    }
+    mask |= ids[i] ^ code;
+  }
+  return mask & 0x7FF;
+}
+
+uint32_t popcount11(uint16_t mask) {
+  uint32_t n = 0;
+  for (; mask; mask &= mask - 1) {
+    n++;
+  }
+  return n;
+}
+
+}  // namespace
+
+filter_plan_t plan_acceptance_filter(const uint16_t *ids, size_t count) {
+  filter_plan_t plan;
+  plan.config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+  plan.accepted_ids = 2048;
+  plan.dual = false;
+  if (ids == nullptr || count == 0) {
+    return plan;
+  }
+
+  // 单过滤器：ID位于[31:21]，RTR与数据字节不关心
+  uint16_t code;
+  size_t members;
+  uint16_t mask = common_mask(ids, count, 0, -1, code, members);
+  plan.accepted_ids = 1u << popcount11(mask);
+  plan.config.acceptance_code = (uint32_t)(code & ~mask) << 21;
+  plan.config.acceptance_mask = ((uint32_t)mask << 21) | 0x1FFFFF;
+  plan.config.single_filter = true;
+
+  // 双过滤器：过滤器1的ID位于[31:21]，过滤器2的ID位于[15:5]，
+  // 其余位（RTR、过滤器1的数据字节）不关心
+  for (int b = 0; b < 11; b++) {
+    uint16_t bit = 1u << b;
+    uint16_t code1 = 0, code2 = 0;
+    size_t n1, n2;
+    uint16_t mask1 = common_mask(ids, count, bit, 1, code1, n1);
+    uint16_t mask2 = common_mask(ids, count, bit, 0, code2, n2);
+    if (n1 == 0 || n2 == 0) {
+      continue;
+    }
+    uint32_t accepted = (1u << popcount11(mask1)) + (1u << popcount11(mask2));
+    if (accepted < plan.accepted_ids) {
+      plan.accepted_ids = accepted;
+      plan.dual = true;
+      plan.config.acceptance_code =
+          ((uint32_t)(code1 & ~mask1) << 21) | ((uint32_t)(code2 & ~mask2) << 5);
+      plan.config.acceptance_mask = ((uint32_t)mask1 << 21) | (0x1Fu << 16) |
+                                    ((uint32_t)mask2 << 5) | 0x1F;
+      plan.config.single_filter = false;
+    }
+  }
+  return plan;
+}
+
+bool filter_accepts(const filter_plan_t &plan, uint16_t id) {
+  uint32_t code = plan.config.acceptance_code;
+  uint32_t care = ~plan.config.acceptance_mask;
+  if (plan.config.single_filter) {
+    return ((((uint32_t)id << 21) ^ code) & care) == 0;
+  }
+  return ((((uint32_t)id << 21) ^ code) & care & 0xFFE00000) == 0 ||
+         ((((uint32_t)id << 5) ^ code) & care & 0x0000FFE0) == 0;
+}
+
+}  // namespace twai_util
+
+esp_err_t TWAI::init(int tx_pin, int rx_pin, uint32_t bitrate,
+                     const uint16_t *accept_ids, size_t accept_count) {
   if (initialized) {
     ESP_LOGW(TAG, "TWAI already initialized");
     return ESP_OK;
@@ -36,6 +126,8 @@ esp_err_t TWAI::init(int tx_pin, int rx_pin, uint32_t bitrate) {
       (gpio_num_t)tx_pin, (gpio_num_t)rx_pin,
       TWAI_MODE_NORMAL /* TWAI_MODE_NO_ACK */); // TODO 仅测试用
   g_config.tx_queue_len = 15;
+  // 接收、错误与发送完成均由告警驱动（见CanRx、CanTx）
+  g_config.alerts_enabled = TWAI_RX_ALERTS | TWAI_TX_ALERTS;
   // g_config.rx_queue_len = 20;
   // g_config.mode = TWAI_MODE_NO_ACK;
 
@@ -63,11 +155,22 @@ esp_err_t TWAI::init(int tx_pin, int rx_pin, uint32_t bitrate) {
     ESP_LOGW(TAG, "Using default timing for custom bitrate %lu", bitrate);
   }
 
-  // 配置TWAI过滤器配置（接收所有消息）
-  twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+  // 由接收集合计算验收过滤器，只让电机响应帧进入接收中断
+  twai_util::filter_plan_t plan =
+      twai_util::plan_acceptance_filter(accept_ids, accept_count);
+  if (!TWAI_HW_FILTER) {
+    plan = twai_util::plan_acceptance_filter(nullptr, 0);
+  }
+  ESP_LOGI(TAG,
+           "Acceptance filter: %s, code=0x%08lx, mask=0x%08lx, "
+           "passes %lu IDs for %u wanted",
+           plan.dual ? "dual" : "single",
+           (unsigned long)plan.config.acceptance_code,
+           (unsigned long)plan.config.acceptance_mask,
+           (unsigned long)plan.accepted_ids, (unsigned)accept_count);
 
   // 安装TWAI驱动
-  esp_err_t ret = twai_driver_install(&g_config, &t_config, &f_config);
+  esp_err_t ret = twai_backend::driver_install(&g_config, &t_config, &plan.config);
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "Failed to install TWAI driver: %s", esp_err_to_name(ret));
     return ret;
@@ -76,6 +179,14 @@ esp_err_t TWAI::init(int tx_pin, int rx_pin, uint32_t bitrate) {
   // 保存波特率供总线负载监控使用
   current_bitrate = bitrate;
 
+  // 保存接收集合，供统计区分过滤器漏过的帧
+  memset(wanted_ids, 0, sizeof(wanted_ids));
+  wanted_all = accept_ids == nullptr || accept_count == 0;
+  for (size_t i = 0; i < accept_count; i++) {
+    uint16_t id = accept_ids[i] & 0x7FF;
+    wanted_ids[id / 32] |= 1u << (id % 32);
+  }
+
   initialized = true;
   ESP_LOGI(TAG, "TWAI initialized successfully");
   return ESP_OK;
@@ -93,7 +204,7 @@ esp_err_t TWAI::start() {
   }
 
   ESP_LOGI(TAG, "Starting TWAI driver");
-  esp_err_t ret = twai_start();
+  esp_err_t ret = twai_backend::start();
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "Failed to start TWAI driver: %s", esp_err_to_name(ret));
     return ret;
@@ -123,7 +234,7 @@ esp_err_t TWAI::stop() {
   }
 
   ESP_LOGI(TAG, "Stopping TWAI driver");
-  esp_err_t ret = twai_stop();
+  esp_err_t ret = twai_backend::stop();
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "Failed to stop TWAI driver: %s", esp_err_to_name(ret));
     return ret;
@@ -152,7 +263,7 @@ esp_err_t TWAI::deinit() {
   }
 
   ESP_LOGI(TAG, "Deinitializing TWAI driver");
-  esp_err_t ret = twai_driver_uninstall();
+  esp_err_t ret = twai_backend::driver_uninstall();
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "Failed to deinitialize TWAI driver: %s",
              esp_err_to_name(ret));
@@ -189,18 +300,31 @@ esp_err_t TWAI::send(uint32_t id, const uint8_t *data, uint8_t data_len,
     tx_msg.data[i] = data[i];
   }
 
+  return transmit(tx_msg, timeout_ms);
+}
+
+esp_err_t TWAI::transmit(const twai_message_t &msg, int timeout_ms) {
+  if (!initialized || !started) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
   // 发送消息
-  esp_err_t ret = twai_transmit(&tx_msg, pdMS_TO_TICKS(timeout_ms));
+  esp_err_t ret = twai_backend::transmit(&msg, pdMS_TO_TICKS(timeout_ms));
   if (ret != ESP_OK) {
     // ESP_LOGE(TAG, "Failed to send TWAI message: %s",
     // esp_err_to_name(ret));
+    if (!msg.extd) {
+      node_counters[(msg.identifier >> 5) & 0x3F].errors.fetch_add(
+          1, std::memory_order_relaxed);
+    }
     return ret;
   }
 
   // 更新发送统计信息
-  updateTxStats(data_len, is_extended);
+  updateTxStats(msg, esp_timer_get_time());
 
-  ESP_LOGD(TAG, "TWAI message sent: ID=0x%lx, Len=%d", id, data_len);
+  ESP_LOGD(TAG, "TWAI message sent: ID=0x%lx, Len=%d", msg.identifier,
+           msg.data_length_code);
   return ESP_OK;
 }
 
@@ -213,7 +337,7 @@ esp_err_t TWAI::receive(uint32_t *id, uint8_t *data, uint8_t *data_len,
 
   // 接收消息
   twai_message_t rx_msg;
-  esp_err_t ret = twai_receive(&rx_msg, pdMS_TO_TICKS(timeout_ms));
+  esp_err_t ret = twai_backend::receive(&rx_msg, pdMS_TO_TICKS(timeout_ms));
   if (ret != ESP_OK) {
     if (ret != ESP_ERR_TIMEOUT) {
       ESP_LOGE(TAG, "Failed to receive TWAI message: %s", esp_err_to_name(ret));
@@ -230,12 +354,56 @@ esp_err_t TWAI::receive(uint32_t *id, uint8_t *data, uint8_t *data_len,
   memcpy(data, rx_msg.data, *data_len);
 
   // 更新接收统计信息
-  updateRxStats(*data_len, *is_extended);
+  updateRxStats(rx_msg, esp_timer_get_time());
 
   ESP_LOGD(TAG, "TWAI message received: ID=0x%lx, Len=%d", *id, *data_len);
   return ESP_OK;
 }
 
+esp_err_t TWAI::readAlerts(uint32_t *alerts, int timeout_ms) {
+  if (!initialized || !started) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  return twai_backend::read_alerts(alerts, pdMS_TO_TICKS(timeout_ms));
+}
+
+esp_err_t TWAI::initiateRecovery() {
+  if (!initialized || !started) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  esp_err_t ret = twai_backend::initiate_recovery();
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to initiate bus recovery: %s", esp_err_to_name(ret));
+  }
+  return ret;
+}
+
+esp_err_t TWAI::restart() {
+  if (!initialized || !started) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  // 恢复完成后驱动处于停止状态，started标志与监控任务保持不变
+  esp_err_t ret = twai_backend::start();
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to restart TWAI driver: %s", esp_err_to_name(ret));
+  }
+  return ret;
+}
+
+esp_err_t TWAI::getStatus(twai_status_info_t *info) {
+  if (!initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  return twai_backend::get_status_info(info);
+}
+
+bool TWAI::isWanted(uint32_t id) {
+  if (wanted_all) {
+    return true;
+  }
+  return id < 2048 && (wanted_ids[id / 32] & (1u << (id % 32))) != 0;
+}
+
 bool TWAI::is_initialized() { return initialized; }
 
 bool TWAI::is_started() { return started; }
@@ -257,26 +425,16 @@ void TWAI::busLoadMonitorTask(void *arg) {
     uint32_t time_diff_ms = current_time - last_report_time;
     uint64_t time_diff_us = (uint64_t)time_diff_ms * 1000;
 
-    // 获取统计数据的快照
-    std::lock_guard<std::mutex> lock(stats_mutex);
-
-    uint32_t rx_msgs = rx_message_count;
-    uint32_t tx_msgs = tx_message_count;
-    uint32_t rx_bytes = rx_bytes_count;
-    uint32_t tx_bytes = tx_bytes_count;
-    uint64_t rx_time_us = rx_total_transmission_time_us;
-    uint64_t tx_time_us = tx_total_transmission_time_us;
-
-    // 重置统计计数器
-    rx_message_count = 0;
-    tx_message_count = 0;
-    rx_bytes_count = 0;
-    tx_bytes_count = 0;
-    rx_total_transmission_time_us = 0;
-    tx_total_transmission_time_us = 0;
-
-    // 解锁后计算负载率
-    lock.~lock_guard();
+    // 取走并清零各计数；字段间不是同一瞬间的快照，窗口边界上的帧可能
+    // 计入相邻窗口，对负载率没有影响
+    uint32_t rx_msgs = rx_counters.messages.exchange(0, std::memory_order_relaxed);
+    uint32_t tx_msgs = tx_counters.messages.exchange(0, std::memory_order_relaxed);
+    uint32_t rx_bytes = rx_counters.bytes.exchange(0, std::memory_order_relaxed);
+    uint32_t tx_bytes = tx_counters.bytes.exchange(0, std::memory_order_relaxed);
+    uint32_t rx_time_us =
+        rx_counters.bus_time_us.exchange(0, std::memory_order_relaxed);
+    uint32_t tx_time_us =
+        tx_counters.bus_time_us.exchange(0, std::memory_order_relaxed);
 
     // 计算负载率
     float rx_load = time_diff_us > 0 ? (float)rx_time_us / time_diff_us : 0.0f;
@@ -302,6 +460,7 @@ void TWAI::busLoadMonitorTask(void *arg) {
     event_data.txBytesCount = tx_bytes;
     event_data.bitrate = current_bitrate;
     event_data.timestamp = current_time;
+    collectNodeStats(event_data);
     esp_err_t ret = esp_event_post(TWAI_EVENT, TWAI_EVENT_BUS_LOAD_UPDATE, &event_data,
                                    sizeof(event_data), pdMS_TO_TICKS(100));
     if (ret != ESP_OK) {
@@ -312,38 +471,94 @@ void TWAI::busLoadMonitorTask(void *arg) {
   }
 }
 
-void TWAI::updateTxStats(uint8_t data_len, bool is_extended) {
-  if (!initialized || !started) {
-    return;
-  }
+void TWAI::collectNodeStats(twai_bus_load_update_event_data_t &event) {
+  event.nodeCount = 0;
+  event.nodesDropped = 0;
+
+  for (int node = 0; node < MAX_NODES; node++) {
+    NodeCounters &n = node_counters[node];
+    twai_node_stats_t s;
+    s.node = node;
+    s.txFrames = n.tx_frames.exchange(0, std::memory_order_relaxed);
+    s.rxFrames = n.rx_frames.exchange(0, std::memory_order_relaxed);
+    s.errors = n.errors.exchange(0, std::memory_order_relaxed);
+    s.lastSeen = n.last_seen_ms.load(std::memory_order_relaxed);
+    for (int b = 0; b < TWAI_RTT_BUCKETS; b++) {
+      s.rttHistogram[b] = n.rtt[b].exchange(0, std::memory_order_relaxed);
+    }
 
-  std::lock_guard<std::mutex> lock(stats_mutex);
+    // 只发布本窗口有流量或曾经应答过的节点
+    if (s.txFrames == 0 && s.rxFrames == 0 && s.errors == 0 &&
+        s.lastSeen == 0) {
+      continue;
+    }
+    if (event.nodeCount < TWAI_EVENT_NODE_SLOTS) {
+      event.nodes[event.nodeCount++] = s;
+    } else {
+      event.nodesDropped++;
+    }
+  }
+}
 
-  tx_message_count++;
-  tx_bytes_count += data_len;
+void TWAI::updateTxStats(const twai_message_t &msg, int64_t now_us) {
+  uint8_t data_len = msg.rtr ? 0 : msg.data_length_code;
+  tx_counters.messages.fetch_add(1, std::memory_order_relaxed);
+  tx_counters.bytes.fetch_add(data_len, std::memory_order_relaxed);
 
   // 计算发送这条消息的传输时间
-  uint32_t message_time_us = twai_util::calculate_message_transmission_time(
-      current_bitrate, data_len, is_extended);
+  tx_counters.bus_time_us.fetch_add(
+      twai_util::calculate_message_transmission_time(current_bitrate, data_len,
+                                                     msg.extd),
+      std::memory_order_relaxed);
 
-  tx_total_transmission_time_us += message_time_us;
-}
-
-void TWAI::updateRxStats(uint8_t data_len, bool is_extended) {
-  if (!initialized || !started) {
+  if (msg.extd) {
     return;
   }
+  NodeCounters &n = node_counters[(msg.identifier >> 5) & 0x3F];
+  n.tx_frames.fetch_add(1, std::memory_order_relaxed);
+
+  // 往返时间从最早未应答的请求算起；无应答的命令（如设置轴状态）由下一帧
+  // 应答结束计时
+  uint32_t now = (uint32_t)now_us | 1;
+  uint32_t since = n.request_us.load(std::memory_order_relaxed);
+  if (since == 0) {
+    n.request_us.compare_exchange_strong(since, now,
+                                         std::memory_order_relaxed);
+  } else if (now - since > TWAI_NODE_REPLY_TIMEOUT_MS * 1000) {
+    // 应答超时，从本帧重新计时
+    n.errors.fetch_add(1, std::memory_order_relaxed);
+    n.request_us.store(now, std::memory_order_relaxed);
+  }
+}
 
-  std::lock_guard<std::mutex> lock(stats_mutex);
-
-  rx_message_count++;
-  rx_bytes_count += data_len;
+void TWAI::updateRxStats(const twai_message_t &msg, int64_t now_us) {
+  uint8_t data_len = msg.rtr ? 0 : msg.data_length_code;
+  rx_counters.messages.fetch_add(1, std::memory_order_relaxed);
+  rx_counters.bytes.fetch_add(data_len, std::memory_order_relaxed);
 
   // 计算接收这条消息的传输时间
-  uint32_t message_time_us = twai_util::calculate_message_transmission_time(
-      current_bitrate, data_len, is_extended);
+  rx_counters.bus_time_us.fetch_add(
+      twai_util::calculate_message_transmission_time(current_bitrate, data_len,
+                                                     msg.extd),
+      std::memory_order_relaxed);
 
-  rx_total_transmission_time_us += message_time_us;
+  if (msg.extd) {
+    return;
+  }
+  NodeCounters &n = node_counters[(msg.identifier >> 5) & 0x3F];
+  n.rx_frames.fetch_add(1, std::memory_order_relaxed);
+  n.last_seen_ms.store((uint32_t)(now_us / 1000), std::memory_order_relaxed);
+
+  uint32_t since = n.request_us.exchange(0, std::memory_order_relaxed);
+  if (since != 0) {
+    uint32_t rtt = (uint32_t)now_us - since;
+    int b = 0;
+    while (b < TWAI_RTT_BUCKETS - 1 &&
+           rtt >= ((uint32_t)TWAI_RTT_BUCKET_BASE_US << b)) {
+      b++;
+    }
+    n.rtt[b].fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
 esp_err_t TWAI::initEventSystem() {
@@ -0,0 +1,645 @@
+#include "twai/twai_sim.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "twai/mit.hpp"
+#include "twai/mit_codec.hpp"
+#include "twai/twai.hpp"
+
+namespace twai_sim {
+
+namespace {
+
+const char *TAG = "TwaiSim";
+
+constexpr int kMaxNodes = 64;
+constexpr size_t kPendingLen = 32;  // 在途应答（需不小于一个节拍的请求数）
+constexpr int64_t kNever = INT64_MAX;
+constexpr uint32_t kErrorFrameBits = 20;  // 错误帧（6+8位）与帧间隔（3位）后重发
+
+// 控制帧字段按协议原公式解码（反馈位置的2倍增益只用于状态帧）
+constexpr mit_codec::Field kRefPosition = mit_codec::makeField(15.91, 31.82, 16);
+
+/**
+ * @brief 模拟电机
+ */
+struct Motor {
+  bool online;
+  uint8_t axis_state;
+  uint64_t fault_code;
+  float pos;  // 弧度
+  float vel;  // 弧度/秒
+  float torque;
+  // 最近一帧MIT控制
+  float p_ref, v_ref, kp, kd, t_ff;
+  int64_t time_us;  // 已积分到的时刻
+};
+
+/**
+ * @brief 发送队列项
+ */
+struct TxItem {
+  twai_message_t msg;
+  int64_t enqueue_us;
+};
+
+/**
+ * @brief 在途应答：ready_us起可竞争总线，deliver_us发完后进入接收队列
+ */
+struct Pending {
+  twai_message_t msg;
+  int64_t request_us;  // 对应请求的入队时刻，用于往返时间
+  int64_t ready_us;
+  int64_t deliver_us;
+};
+
+std::mutex mutex;  // 保护以下全部状态
+bool installed = false;
+twai_state_t state = TWAI_STATE_STOPPED;
+uint32_t bitrate = 500000;
+uint32_t alerts_enabled = 0;
+twai_util::filter_plan_t filter = {};
+QueueHandle_t tx_queue = nullptr;
+QueueHandle_t rx_queue = nullptr;
+EventGroupHandle_t alert_group = nullptr;
+TaskHandle_t task_handle = nullptr;
+esp_timer_handle_t wake_timer = nullptr;
+
+Motor motors[kMaxNodes] = {};
+Pending pending[kPendingLen];
+size_t pending_head = 0;  // 最早未交付
+size_t pending_bus = 0;   // 最早未上总线
+size_t pending_tail = 0;
+// 控制器发送缓冲：队首帧装入后留在这里直到被ACK，无ACK时自动重发
+bool tx_loaded = false;
+TxItem tx_buf;
+int64_t tx_buf_end = kNever;  // 在总线上时为发完时刻
+int64_t bus_free_at = 0;
+int64_t recovery_done_us = 0;
+uint32_t tec = 0;
+uint32_t rx_missed = 0;
+
+Stats stats = {};
+int64_t window_start_us = 0;
+
+void raise(uint32_t alerts) {
+  alerts &= alerts_enabled;
+  if (alerts != 0 && alert_group != nullptr) {
+    xEventGroupSetBits(alert_group, alerts);
+  }
+}
+
+uint32_t frameTime(const twai_message_t &msg) {
+  return twai_util::calculate_message_transmission_time(
+      bitrate, msg.rtr ? 0 : msg.data_length_code, msg.extd);
+}
+
+void resetPending() {
+  pending_head = pending_bus = pending_tail = 0;
+  tx_loaded = false;
+  tx_buf_end = kNever;
+}
+
+/**
+ * @brief 把电机积分到指定时刻
+ */
+void integrate(Motor &m, int64_t until_us) {
+  while (m.time_us < until_us) {
+    int64_t step_us = until_us - m.time_us;
+    if (step_us > TWAI_SIM_STEP_US) {
+      step_us = TWAI_SIM_STEP_US;
+    }
+    float dt = step_us * 1e-6f;
+
+    float t = 0.0f;
+    if (m.fault_code == 0) {
+      t = m.kp * (m.p_ref - m.pos) + m.kd * (m.v_ref - m.vel) + m.t_ff;
+      float t_max = (float)mit_codec::kTorque.offset;
+      t = t > t_max ? t_max : (t < -t_max ? -t_max : t);
+    }
+    m.torque = t;
+
+    // 半隐式欧拉
+    m.vel += (t - TWAI_SIM_DAMPING * m.vel) / TWAI_SIM_INERTIA * dt;
+    m.pos += m.vel * dt;
+    m.time_us += step_us;
+  }
+}
+
+float decodeRef(const mit_codec::Field &f, uint32_t code) {
+  return (float)(code * f.span / f.max - f.offset);
+}
+
+/**
+ * @brief 电机处理一帧请求
+ * @param reply 输出参数：应答帧
+ * @return bool 是否应答
+ */
+bool handleRequest(uint8_t node, const twai_message_t &msg, int64_t at_us,
+                   twai_message_t &reply) {
+  Motor &m = motors[node];
+  integrate(m, at_us);
+
+  uint32_t cmd = msg.identifier & 0x1F;
+  reply = {};
+  reply.identifier = msg.identifier;
+  reply.data_length_code = 8;
+
+  switch (cmd) {
+    case MIT::CMD_MIT_CONTROL: {
+      const uint8_t *d = msg.data;
+      m.p_ref = decodeRef(kRefPosition, (d[0] << 8) | d[1]);
+      m.v_ref = decodeRef(mit_codec::kVelocity, (d[2] << 4) | (d[3] >> 4));
+      m.kp = decodeRef(mit_codec::kKp, ((d[3] & 0x0F) << 8) | d[4]);
+      m.kd = decodeRef(mit_codec::kKd, (d[5] << 4) | (d[6] >> 4));
+      m.t_ff = decodeRef(mit_codec::kTorque, ((d[6] & 0x0F) << 8) | d[7]);
+
+      // 状态帧位置按2倍增益解码，这里先除以2
+      uint32_t pos = mit_codec::encode(mit_codec::kPosition, m.pos * 0.5f);
+      uint32_t vel = mit_codec::encode(mit_codec::kVelocity, m.vel);
+      uint32_t t = mit_codec::encode(mit_codec::kTorque, m.torque);
+      reply.data[0] = node;
+      reply.data[1] = (uint8_t)(pos >> 8);
+      reply.data[2] = (uint8_t)(pos & 0xFF);
+      reply.data[3] = (uint8_t)(vel >> 4);
+      reply.data[4] = (uint8_t)(((vel & 0x0F) << 4) | ((t >> 8) & 0x0F));
+      reply.data[5] = (uint8_t)(t & 0xFF);
+      return true;
+    }
+
+    case MIT::CMD_GET_ERROR:
+      for (int i = 0; i < 8; i++) {
+        reply.data[i] = (uint8_t)(m.fault_code >> (56 - 8 * i));
+      }
+      return true;
+
+    case MIT::CMD_GET_ENCODER_ESTIMATES:
+      memcpy(&reply.data[0], &m.pos, 4);
+      memcpy(&reply.data[4], &m.vel, 4);
+      return true;
+
+    case MIT::CMD_CLEAR_ERRORS:
+      m.fault_code = 0;
+      return true;
+
+    case MIT::CMD_SET_AXIS_STATE:
+      m.axis_state = msg.data[0];
+      if (m.axis_state != MIT::AXIS_STATE_CLOSED_LOOP_CONTROL) {
+        m.kp = m.kd = m.t_ff = 0.0f;
+      }
+      return false;
+
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief 请求帧发完：ACK、错误计数与电机应答
+ * @return bool 是否被ACK（否则控制器在错误帧后自动重发）
+ */
+bool onRequestSent(const TxItem &item, int64_t end_us) {
+  uint8_t node = (item.msg.identifier >> 5) & 0x3F;
+
+  // 任一在线节点都会ACK，全部掉线时为ACK错误
+  bool acked = false;
+  for (int i = 0; i < kMaxNodes && !acked; i++) {
+    acked = motors[i].online;
+  }
+  if (!acked) {
+    stats.unacked++;
+    // 错误被动时ACK错误不再增加TEC
+    if (tec < 128) {
+      tec += 8;
+      raise(TWAI_ALERT_BUS_ERROR | (tec >= 128 ? TWAI_ALERT_ERR_PASS : 0));
+    } else {
+      raise(TWAI_ALERT_BUS_ERROR);
+    }
+    return false;
+  }
+
+  stats.tx_frames++;
+  if (tec > 0 && --tec == 127) {
+    raise(TWAI_ALERT_ERR_ACTIVE);
+  }
+  raise(TWAI_ALERT_TX_SUCCESS);
+
+  if (!motors[node].online) {
+    return true;
+  }
+  Pending &p = pending[pending_tail % kPendingLen];
+  if (pending_tail - pending_head >= kPendingLen) {
+    ESP_LOGW(TAG, "Pending reply ring full, dropping reply");
+    return true;
+  }
+  if (!handleRequest(node, item.msg, end_us, p.msg)) {
+    return true;
+  }
+  p.request_us = item.enqueue_us;
+  p.ready_us = end_us + TWAI_SIM_REPLY_US;
+  p.deliver_us = kNever;
+  pending_tail++;
+  return true;
+}
+
+/**
+ * @brief 应答发完，经验收过滤器进入接收队列
+ */
+void deliver(const Pending &p, int64_t now) {
+  stats.replies++;
+  if (!twai_util::filter_accepts(filter, p.msg.identifier)) {
+    stats.filtered++;
+    return;
+  }
+  if (xQueueSend(rx_queue, &p.msg, 0) != pdTRUE) {
+    stats.rx_missed++;
+    rx_missed++;
+    raise(TWAI_ALERT_RX_QUEUE_FULL);
+    return;
+  }
+  uint32_t rtt = (uint32_t)(now - p.request_us);
+  stats.rtt_sum_us += rtt;
+  if (rtt > stats.rtt_max_us) {
+    stats.rtt_max_us = rtt;
+  }
+  raise(TWAI_ALERT_RX_DATA);
+}
+
+/**
+ * @brief 推进虚拟总线到当前时刻
+ * @return int64_t 下一个事件的时刻，无事件时为kNever
+ */
+int64_t advance(int64_t now) {
+  if (state == TWAI_STATE_RECOVERING && now >= recovery_done_us) {
+    state = TWAI_STATE_STOPPED;
+    tec = 0;
+    raise(TWAI_ALERT_BUS_RECOVERED);
+  }
+  if (state != TWAI_STATE_RUNNING) {
+    return state == TWAI_STATE_RECOVERING ? recovery_done_us : kNever;
+  }
+
+  while (true) {
+    // 发送缓冲中的帧发完：ACK后释放，无ACK时错误帧后重发
+    if (tx_loaded && tx_buf_end <= now) {
+      int64_t end = tx_buf_end;
+      tx_buf_end = kNever;
+      if (onRequestSent(tx_buf, end)) {
+        tx_loaded = false;
+      } else {
+        uint32_t t = kErrorFrameBits * 1000000ull / bitrate;
+        bus_free_at = end + t;
+        stats.busy_us += t;
+      }
+    }
+
+    while (pending_head != pending_bus &&
+           pending[pending_head % kPendingLen].deliver_us <= now) {
+      deliver(pending[pending_head % kPendingLen], now);
+      pending_head++;
+    }
+
+    if (!tx_loaded && xQueueReceive(tx_queue, &tx_buf, 0) == pdTRUE) {
+      tx_loaded = true;
+    }
+
+    // 应答与发送缓冲中的帧按就绪时刻先后占用总线，同时就绪时应答优先
+    int64_t reply_start = kNever;
+    if (pending_bus != pending_tail) {
+      int64_t ready = pending[pending_bus % kPendingLen].ready_us;
+      reply_start = ready > bus_free_at ? ready : bus_free_at;
+    }
+    int64_t tx_start = kNever;
+    if (tx_loaded && tx_buf_end == kNever) {
+      tx_start = tx_buf.enqueue_us > bus_free_at ? tx_buf.enqueue_us
+                                                 : bus_free_at;
+    }
+
+    if (reply_start <= tx_start && reply_start <= now) {
+      Pending &p = pending[pending_bus % kPendingLen];
+      uint32_t t = frameTime(p.msg);
+      p.deliver_us = reply_start + t;
+      bus_free_at = p.deliver_us;
+      stats.busy_us += t;
+      pending_bus++;
+    } else if (tx_start < reply_start && tx_start <= now) {
+      uint32_t t = frameTime(tx_buf.msg);
+      tx_buf_end = tx_start + t;
+      bus_free_at = tx_buf_end;
+      stats.busy_us += t;
+    } else {
+      int64_t next = reply_start < tx_start ? reply_start : tx_start;
+      if (tx_loaded && tx_buf_end < next) {
+        next = tx_buf_end;
+      }
+      if (pending_head != pending_bus) {
+        int64_t d = pending[pending_head % kPendingLen].deliver_us;
+        next = d < next ? d : next;
+      }
+      return next;
+    }
+  }
+}
+
+void report(int64_t now) {
+  float window_s = (now - window_start_us) / 1000000.0f;
+  if (window_s < TWAI_SIM_REPORT_MS / 1000.0f) {
+    return;
+  }
+  Stats s = stats;
+  stats = {};
+  window_start_us = now;
+  uint32_t delivered = s.replies - s.filtered - s.rx_missed;
+
+  ESP_LOGI(TAG,
+           "Sim [%.1fs window] - tx=%.0f/s, replies=%.0f/s, load=%.1f%%, "
+           "rtt avg=%.0f us max=%lu us, txq max=%lu, unacked=%lu, "
+           "filtered=%lu, rx_missed=%lu",
+           window_s, s.tx_frames / window_s, s.replies / window_s,
+           s.busy_us / (window_s * 10000.0f),
+           delivered > 0 ? (float)s.rtt_sum_us / delivered : 0.0f,
+           (unsigned long)s.rtt_max_us, (unsigned long)s.tx_queue_max,
+           (unsigned long)s.unacked, (unsigned long)s.filtered,
+           (unsigned long)s.rx_missed);
+}
+
+void wake(void *arg) {
+  xTaskNotifyGive(task_handle);
+}
+
+void busTask(void *arg) {
+  ESP_LOGI(TAG, "Virtual CAN bus started at %lu bit/s",
+           (unsigned long)bitrate);
+
+  while (true) {
+    int64_t next;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      int64_t now = esp_timer_get_time();
+      next = advance(now);
+      report(now);
+      if (next != kNever) {
+        esp_timer_stop(wake_timer);
+        int64_t delay = next - now;
+        esp_timer_start_once(wake_timer, delay > 0 ? delay : 1);
+      }
+    }
+    // 新帧入队或定时器到期时唤醒
+    ulTaskNotifyTake(pdTRUE, next == kNever
+                                 ? pdMS_TO_TICKS(TWAI_SIM_REPORT_MS)
+                                 : portMAX_DELAY);
+  }
+}
+
+}  // namespace
+
+esp_err_t driver_install(const twai_general_config_t *g_config,
+                         const twai_timing_config_t *t_config,
+                         const twai_filter_config_t *f_config) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  uint32_t resolution = t_config->brp != 0 ? 80000000 / t_config->brp
+                                           : t_config->quanta_resolution_hz;
+  uint32_t quanta = 1 + t_config->tseg_1 + t_config->tseg_2;
+  bitrate = resolution / quanta;
+  if (bitrate == 0) {
+    bitrate = 500000;
+  }
+  alerts_enabled = g_config->alerts_enabled;
+  filter.config = *f_config;
+  filter.dual = !f_config->single_filter;
+
+  tx_queue = xQueueCreate(g_config->tx_queue_len, sizeof(TxItem));
+  rx_queue = xQueueCreate(g_config->rx_queue_len, sizeof(twai_message_t));
+  alert_group = xEventGroupCreate();
+  esp_timer_create_args_t timer_args = {};
+  timer_args.callback = wake;
+  timer_args.dispatch_method = ESP_TIMER_TASK;
+  timer_args.name = "twai_sim";
+  if (tx_queue == nullptr || rx_queue == nullptr || alert_group == nullptr ||
+      esp_timer_create(&timer_args, &wake_timer) != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to allocate virtual bus");
+    return ESP_ERR_NO_MEM;
+  }
+
+  for (int node = 0; node < kMaxNodes; node++) {
+    motors[node] = {};
+    motors[node].online = (TWAI_SIM_NODE_MASK >> node) & 1;
+    motors[node].axis_state = MIT::AXIS_STATE_IDLE;
+    motors[node].time_us = esp_timer_get_time();
+  }
+  resetPending();
+  state = TWAI_STATE_STOPPED;
+  tec = rx_missed = 0;
+  stats = {};
+  window_start_us = esp_timer_get_time();
+
+  if (xTaskCreate(busTask, "twai_sim", 4096, nullptr, TWAI_SIM_TASK_PRIORITY,
+                  &task_handle) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create virtual bus task");
+    return ESP_FAIL;
+  }
+
+  installed = true;
+  ESP_LOGW(TAG, "Simulating MIT motors (node mask 0x%llx), no frames leave "
+                "the chip",
+           (unsigned long long)TWAI_SIM_NODE_MASK);
+  return ESP_OK;
+}
+
+esp_err_t driver_uninstall() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!installed ||
+        (state != TWAI_STATE_STOPPED && state != TWAI_STATE_BUS_OFF)) {
+      return ESP_ERR_INVALID_STATE;
+    }
+  }
+
+  // 总线任务只在锁外阻塞，删除时不持锁，任务不会停在等锁处
+  vTaskDelete(task_handle);
+  std::lock_guard<std::mutex> lock(mutex);
+  task_handle = nullptr;
+  esp_timer_stop(wake_timer);
+  esp_timer_delete(wake_timer);
+  wake_timer = nullptr;
+  vQueueDelete(tx_queue);
+  vQueueDelete(rx_queue);
+  vEventGroupDelete(alert_group);
+  tx_queue = rx_queue = nullptr;
+  alert_group = nullptr;
+  installed = false;
+  return ESP_OK;
+}
+
+esp_err_t start() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!installed || state != TWAI_STATE_STOPPED) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  xQueueReset(tx_queue);
+  resetPending();
+  bus_free_at = 0;
+  state = TWAI_STATE_RUNNING;
+  return ESP_OK;
+}
+
+esp_err_t stop() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!installed || state != TWAI_STATE_RUNNING) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  xQueueReset(tx_queue);
+  resetPending();
+  state = TWAI_STATE_STOPPED;
+  return ESP_OK;
+}
+
+esp_err_t transmit(const twai_message_t *message, TickType_t ticks_to_wait) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!installed || state != TWAI_STATE_RUNNING) {
+      return ESP_ERR_INVALID_STATE;
+    }
+  }
+
+  TxItem item;
+  item.msg = *message;
+  item.enqueue_us = esp_timer_get_time();
+  if (xQueueSend(tx_queue, &item, ticks_to_wait) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+
+  uint32_t depth = uxQueueMessagesWaiting(tx_queue);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (depth > stats.tx_queue_max) {
+      stats.tx_queue_max = depth;
+    }
+  }
+  xTaskNotifyGive(task_handle);
+  return ESP_OK;
+}
+
+esp_err_t receive(twai_message_t *message, TickType_t ticks_to_wait) {
+  if (!installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  return xQueueReceive(rx_queue, message, ticks_to_wait) == pdTRUE
+             ? ESP_OK
+             : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t read_alerts(uint32_t *alerts, TickType_t ticks_to_wait) {
+  if (!installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  *alerts = xEventGroupWaitBits(alert_group, alerts_enabled, pdTRUE, pdFALSE,
+                                ticks_to_wait) &
+            alerts_enabled;
+  return *alerts != 0 ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t initiate_recovery() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!installed || state != TWAI_STATE_BUS_OFF) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  // 恢复需检测到128次11个隐性位
+  state = TWAI_STATE_RECOVERING;
+  recovery_done_us = esp_timer_get_time() + 128 * 11 * 1000000ll / bitrate;
+  raise(TWAI_ALERT_RECOVERY_IN_PROGRESS);
+  xTaskNotifyGive(task_handle);
+  return ESP_OK;
+}
+
+esp_err_t get_status_info(twai_status_info_t *status_info) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  *status_info = {};
+  status_info->state = state;
+  // 与驱动一致，包含发送缓冲中未发完的帧
+  status_info->msgs_to_tx =
+      uxQueueMessagesWaiting(tx_queue) + (tx_loaded ? 1 : 0);
+  status_info->msgs_to_rx = uxQueueMessagesWaiting(rx_queue);
+  status_info->tx_error_counter = state == TWAI_STATE_BUS_OFF ? 256 : tec;
+  status_info->tx_failed_count = 0;  // 无ACK的帧自动重发，不计失败
+  status_info->rx_missed_count = rx_missed;
+  return ESP_OK;
+}
+
+void setNodeOnline(uint8_t node, bool online) {
+  if (node >= kMaxNodes) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  Motor &m = motors[node];
+  if (online && !m.online) {
+    // 重新上电：空闲、保持原位
+    float pos = m.pos;
+    m = {};
+    m.pos = pos;
+    m.axis_state = MIT::AXIS_STATE_IDLE;
+    m.time_us = esp_timer_get_time();
+  }
+  m.online = online;
+  ESP_LOGW(TAG, "Node %u %s", node, online ? "online" : "offline");
+}
+
+void setNodeFault(uint8_t node, uint64_t fault_code) {
+  if (node >= kMaxNodes) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  integrate(motors[node], esp_timer_get_time());
+  motors[node].fault_code = fault_code;
+  ESP_LOGW(TAG, "Node %u fault 0x%llx", node, (unsigned long long)fault_code);
+}
+
+void injectBusOff() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!installed || state != TWAI_STATE_RUNNING) {
+    return;
+  }
+  // 进入总线关闭时驱动清空发送队列
+  state = TWAI_STATE_BUS_OFF;
+  xQueueReset(tx_queue);
+  resetPending();
+  raise(TWAI_ALERT_BUS_OFF);
+  ESP_LOGW(TAG, "Injected bus-off");
+}
+
+float nodePosition(uint8_t node) {
+  if (node >= kMaxNodes) {
+    return NAN;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!motors[node].online) {
+    return NAN;
+  }
+  integrate(motors[node], esp_timer_get_time());
+  return motors[node].pos;
+}
+
+Stats takeStats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  Stats s = stats;
+  stats = {};
+  window_start_us = esp_timer_get_time();
+  return s;
+}
+
+}  // namespace twai_sim
@@ -2,9 +2,11 @@
 #include "def.h"
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <memory>
+#include <stdexcept>
 #include <sdkconfig.h>
 #include <string>
 
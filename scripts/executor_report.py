@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""
+按执行器模式统计固件体积：对每个mode分别以虚函数节拍（EXECUTOR_DEVIRTUALIZE=0）
+和编译期组合节拍（EXECUTOR_DEVIRTUALIZE=1）构建，输出Flash代码/IRAM/DRAM占用对比。
+
+每节拍CPU周期数需在硬件上测量：以 -D EXECUTOR_TICK_PROFILE=1 构建并烧录，
+执行器统计窗口日志中的 "Tick: avg=... cycles" 即为结果。
+
+用法（在工程根目录、已导出ESP-IDF环境）：
+    python scripts/executor_report.py [mode ...]
+"""
+
+import json
+import subprocess
+import sys
+
+MODES = {0: "OSR", 3: "SR6", 6: "TrRMax", 8: "SR6CAN", 9: "O6"}
+REGIONS = ("Flash Code", "IRAM", "DRAM")
+
+
+def build_and_size(mode: int, devirtualize: int) -> dict[str, int]:
+    """
+    构建指定配置并返回各内存区域占用（字节）
+    """
+    build_dir = "build_report/mode%d_d%d" % (mode, devirtualize)
+    defines = [
+        "-D", "EXECUTOR_FIXED_MODE=%d" % mode,
+        "-D", "EXECUTOR_DEVIRTUALIZE=%d" % devirtualize,
+    ]
+    subprocess.run(["idf.py", "-B", build_dir, *defines, "build"],
+                   check=True, stdout=subprocess.DEVNULL)
+    size_file = build_dir + "/size.json"
+    subprocess.run(["idf.py", "-B", build_dir, *defines, "size",
+                    "--format", "json2", "--output-file", size_file],
+                   check=True, stdout=subprocess.DEVNULL)
+
+    with open(size_file) as f:
+        memory_types = json.load(f).get("memory_types", {})
+    usage = {}
+    for region in REGIONS:
+        usage[region] = sum(info.get("used", 0)
+                            for name, info in memory_types.items()
+                            if name.startswith(region))
+    return usage
+
+
+def main():
+    modes = [int(m) for m in sys.argv[1:]] or list(MODES)
+
+    print("| mode | 节拍 | " + " | ".join(REGIONS) + " |")
+    print("|---|---|" + "---|" * len(REGIONS))
+    for mode in modes:
+        for devirtualize in (0, 1):
+            usage = build_and_size(mode, devirtualize)
+            print("| %d (%s) | %s | %s |" % (
+                mode, MODES.get(mode, "?"),
+                "pipeline" if devirtualize else "virtual",
+                " | ".join(str(usage[r]) for r in REGIONS)))
+
+
+if __name__ == "__main__":
+    main()
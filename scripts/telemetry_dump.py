@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+下载并解析关节遥测数据（GET /api/telemetry），统计各关节的跟踪误差与滞后
+固件需以EXECUTOR_TELEMETRY=1编译（默认关闭），否则该接口返回500。
+
+跟踪误差RMS只计新反馈样本（实测值相对上一条记录有变化的记录），与固件
+TrackingFeedForward打印的RMS定义相同；另列出逐节拍计入陈旧反馈的RMS，
+其中多出的部分是“目标速度 × 反馈年龄”，与电机跟踪无关。
+
+也可直接解析保存的快照文件（如主机仿真host/sr6can_sim --telemetry的输出）。
+"""
+
+import math
+import os
+import struct
+import sys
+import urllib.request
+
+HEADER = struct.Struct("<IHHIII")
+MAGIC = 0x314D4C54  # "TLM1"
+
+
+def parse(data: bytes):
+    """
+    解析遥测二进制数据
+
+    Returns:
+        (joints, tick_period_us, dropped, records)
+        records为[(timestamp_us, commanded[], measured[])]
+    """
+    magic, version, joints, count, period, dropped = HEADER.unpack_from(data)
+    if magic != MAGIC or version != 1:
+        raise ValueError("不是遥测数据或版本不支持")
+    record = struct.Struct("<I%df" % (2 * joints))
+    records = []
+    for i in range(count):
+        fields = record.unpack_from(data, HEADER.size + i * record.size)
+        records.append((fields[0], fields[1:1 + joints], fields[1 + joints:]))
+    return joints, period, dropped, records
+
+
+def tracking_lag(cmd: list[float], meas: list[float], max_lag: int = 50) -> int:
+    """
+    实测相对指令的滞后节拍数（使两者差的平方和最小的平移量），跳过无反馈的节拍
+    """
+    best_lag, best_err = 0, math.inf
+    for lag in range(min(max_lag, len(cmd) - 1) + 1):
+        diffs = [meas[i + lag] - cmd[i] for i in range(len(cmd) - lag)
+                 if not math.isnan(meas[i + lag])]
+        if not diffs:
+            continue
+        err = sum(d * d for d in diffs) / len(diffs)
+        if err < best_err:
+            best_lag, best_err = lag, err
+    return best_lag
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("用法: telemetry_dump.py <设备IP> [保存文件]")
+        print("      telemetry_dump.py <快照文件>")
+        return
+
+    if os.path.isfile(sys.argv[1]):
+        with open(sys.argv[1], "rb") as f:
+            data = f.read()
+    else:
+        url = "http://%s/api/telemetry" % sys.argv[1]
+        data = urllib.request.urlopen(url, timeout=10).read()
+        if len(sys.argv) > 2:
+            with open(sys.argv[2], "wb") as f:
+                f.write(data)
+
+    joints, period, dropped, records = parse(data)
+    print("关节: %d, 节拍: %dus, 记录: %d, 丢弃: %d"
+          % (joints, period, len(records), dropped))
+
+    for j in range(joints):
+        cmd = [r[1][j] for r in records]
+        meas = [r[2][j] for r in records]
+        valid = [(c, m) for c, m in zip(cmd, meas) if not math.isnan(m)]
+        fresh = [(cmd[i], meas[i]) for i in range(1, len(meas))
+                 if not math.isnan(meas[i]) and meas[i] != meas[i - 1]]
+        if not fresh:
+            print("关节%d: 无反馈" % j)
+            continue
+        rms = math.sqrt(sum((m - c) ** 2 for c, m in fresh) / len(fresh))
+        rms_all = math.sqrt(sum((m - c) ** 2 for c, m in valid) / len(valid))
+        lag = tracking_lag(cmd, meas)
+        print("关节%d: 误差RMS=%.4f (新样本%d个), 含陈旧反馈=%.4f, "
+              "滞后=%d节拍 (%.1fms)"
+              % (j, rms, len(fresh), rms_all, lag, lag * period / 1000.0))
+
+
+if __name__ == "__main__":
+    main()